@@ -0,0 +1,214 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// bench_util.h
+//
+// Identification: bench/bench_util.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/util/hashers.h"
+
+namespace bustub {
+
+/**
+ * A small benchmark harness: key streams with a fixed seed, a runner that
+ * times every operation of every thread, and the throughput and latency
+ * percentiles of a run.
+ */
+
+/** Command line flags of the form --name=value, lists are comma separated. */
+class BenchFlags {
+ public:
+  BenchFlags(int argc, char **argv) {
+    for (int i = 1; i < argc; i++) {
+      std::string arg = argv[i];
+      size_t eq = arg.find('=');
+      if (arg.compare(0, 2, "--") != 0 || eq == std::string::npos) {
+        fprintf(stderr, "ignoring argument %s, flags look like --name=value\n", arg.c_str());
+        continue;
+      }
+      flags_[arg.substr(2, eq - 2)] = arg.substr(eq + 1);
+    }
+  }
+
+  std::string GetString(const std::string &name, const std::string &default_value) const {
+    auto it = flags_.find(name);
+    return it == flags_.end() ? default_value : it->second;
+  }
+
+  uint64_t GetInt(const std::string &name, uint64_t default_value) const {
+    auto it = flags_.find(name);
+    return it == flags_.end() ? default_value : std::stoull(it->second);
+  }
+
+  std::vector<std::string> GetList(const std::string &name, const std::string &default_value) const {
+    std::vector<std::string> list;
+    std::stringstream stream(GetString(name, default_value));
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+      list.push_back(item);
+    }
+    return list;
+  }
+
+ private:
+  std::map<std::string, std::string> flags_;
+};
+
+/**
+ * Zipfian ranks in [0, n) with skew theta, after "Quickly Generating
+ * Billion-Record Synthetic Databases" (Gray et al.) as used by YCSB.
+ * Ranks are scrambled so that the popular keys are spread over the key space.
+ */
+class ZipfianGenerator {
+ public:
+  ZipfianGenerator(uint64_t n, double theta) : n_(n), theta_(theta) {
+    double zeta_2 = Zeta(2);
+    zeta_n_ = Zeta(n);
+    alpha_ = 1.0 / (1.0 - theta_);
+    eta_ = (1.0 - std::pow(2.0 / static_cast<double>(n_), 1.0 - theta_)) / (1.0 - zeta_2 / zeta_n_);
+  }
+
+  template <typename Random>
+  uint64_t Next(Random *random) {
+    double u = std::uniform_real_distribution<double>(0.0, 1.0)(*random);
+    double uz = u * zeta_n_;
+    uint64_t rank;
+    if (uz < 1.0) {
+      rank = 0;
+    } else if (uz < 1.0 + std::pow(0.5, theta_)) {
+      rank = 1;
+    } else {
+      rank = static_cast<uint64_t>(static_cast<double>(n_) * std::pow(eta_ * u - eta_ + 1.0, alpha_));
+    }
+    return HashMixer::Fmix64(std::min(rank, n_ - 1)) % n_;
+  }
+
+ private:
+  double Zeta(uint64_t n) const {
+    double sum = 0;
+    for (uint64_t i = 1; i <= n; i++) {
+      sum += 1.0 / std::pow(static_cast<double>(i), theta_);
+    }
+    return sum;
+  }
+
+  uint64_t n_;
+  double theta_;
+  double zeta_n_;
+  double alpha_;
+  double eta_;
+};
+
+/**
+ * The key ids each thread works on: sequential gives the threads interleaved
+ * slices of 0, 1, 2, ..., uniform and zipfian draw from [0, num_keys) with a
+ * seed per thread, so every run of the same flags sees the same keys.
+ */
+inline std::vector<std::vector<uint64_t>> MakeKeyStreams(const std::string &distribution, uint64_t num_keys,
+                                                         size_t num_threads, uint64_t seed) {
+  std::vector<std::vector<uint64_t>> streams(num_threads);
+  std::unique_ptr<ZipfianGenerator> zipfian;
+  if (distribution == "zipfian") {
+    zipfian = std::make_unique<ZipfianGenerator>(num_keys, 0.99);
+  } else if (distribution != "uniform" && distribution != "sequential") {
+    fprintf(stderr, "unknown distribution %s\n", distribution.c_str());
+    exit(1);
+  }
+  for (size_t t = 0; t < num_threads; t++) {
+    std::mt19937_64 random(seed + t);
+    std::uniform_int_distribution<uint64_t> uniform(0, num_keys - 1);
+    for (uint64_t i = t; i < num_keys; i += num_threads) {
+      if (distribution == "sequential") {
+        streams[t].push_back(i);
+      } else if (distribution == "uniform") {
+        streams[t].push_back(uniform(random));
+      } else {
+        streams[t].push_back(zipfian->Next(&random));
+      }
+    }
+  }
+  return streams;
+}
+
+/** Throughput and latency of one run. */
+struct BenchResult {
+  uint64_t num_ops_;
+  double seconds_;
+  double p50_us_;
+  double p99_us_;
+  double p999_us_;
+  double max_us_;
+};
+
+/**
+ * Runs op(thread, i) for every i of streams[thread] on one thread per stream,
+ * starting all threads together, and times every call.
+ */
+template <typename Op>
+BenchResult RunTimed(const std::vector<std::vector<uint64_t>> &streams, Op op) {
+  size_t num_threads = streams.size();
+  std::vector<std::vector<uint32_t>> latencies(num_threads);
+  std::vector<std::thread> threads;
+  std::atomic<size_t> ready{0};
+  std::atomic<bool> go{false};
+  for (size_t t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      latencies[t].reserve(streams[t].size());
+      ready++;
+      while (!go) {
+        std::this_thread::yield();
+      }
+      for (size_t i = 0; i < streams[t].size(); i++) {
+        auto start = std::chrono::steady_clock::now();
+        op(t, i);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        latencies[t].push_back(
+            static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+      }
+    });
+  }
+  while (ready < num_threads) {
+    std::this_thread::yield();
+  }
+  auto start = std::chrono::steady_clock::now();
+  go = true;
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  std::vector<uint32_t> all;
+  for (const auto &thread_latencies : latencies) {
+    all.insert(all.end(), thread_latencies.begin(), thread_latencies.end());
+  }
+  std::sort(all.begin(), all.end());
+  auto percentile = [&all](double p) {
+    return all.empty() ? 0.0 : all[std::min(all.size() - 1, static_cast<size_t>(p * all.size()))] / 1000.0;
+  };
+  return {all.size(), elapsed.count(), percentile(0.5), percentile(0.99), percentile(0.999),
+          all.empty() ? 0.0 : all.back() / 1000.0};
+}
+
+}  // namespace bustub
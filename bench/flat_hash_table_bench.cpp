@@ -0,0 +1,98 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// flat_hash_table_bench.cpp
+//
+// Identification: bench/flat_hash_table_bench.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+// Counting string keys with FlatHashTable against std::unordered_map, the way a hash aggregation counts groups.
+//
+//   flat_hash_table_bench --keys=1024,65536,1048576 --lookups=4194304 --csv=0
+//
+// Every key is 4 to 67 bytes long with a common prefix, like serialized group-by columns, and is counted
+// lookups / keys times. Build with CMAKE_BUILD_TYPE=Release, debug builds run with the address sanitizer.
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "bench_util.h"
+#include "container/hash/flat_hash_table.h"
+
+namespace bustub {
+
+namespace {
+
+// keys of 4 to 67 bytes with a common prefix, like serialized group-by columns
+std::vector<std::string> MakeKeys(uint64_t num_keys) {
+  std::vector<std::string> keys;
+  keys.reserve(num_keys);
+  for (uint64_t i = 0; i < num_keys; i++) {
+    keys.push_back(std::string(i % 64, 'k') + std::to_string(i));
+  }
+  return keys;
+}
+
+// time counting the occurrences of keys, every key is looked up rounds times
+template <typename CountFn>
+void TimeCount(const std::string &table, const std::vector<std::string> &keys, uint64_t rounds, bool csv,
+               CountFn count) {
+  auto start = std::chrono::steady_clock::now();
+  int sink = 0;
+  for (uint64_t r = 0; r < rounds; r++) {
+    for (const auto &key : keys) {
+      sink += count(key);
+    }
+  }
+  std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+  double ns_per_key = elapsed.count() / static_cast<double>(keys.size() * rounds);
+  // the checksum keeps the counting from being optimized away
+  if (csv) {
+    printf("%s,%zu,%.3f,%d\n", table.c_str(), keys.size(), ns_per_key, sink & 0xFF);
+  } else {
+    printf("%-18s %9zu %9.3f %8d\n", table.c_str(), keys.size(), ns_per_key, sink & 0xFF);
+  }
+  fflush(stdout);
+}
+
+}  // namespace
+
+}  // namespace bustub
+
+int main(int argc, char **argv) {
+  bustub::BenchFlags flags(argc, argv);
+  auto key_counts = flags.GetList("keys", "1024,65536,1048576");
+  uint64_t lookups = flags.GetInt("lookups", 1 << 22);
+  bool csv = flags.GetInt("csv", 0) != 0;
+
+#ifndef NDEBUG
+  fprintf(stderr, "warning: built without NDEBUG, build with CMAKE_BUILD_TYPE=Release for meaningful numbers\n");
+#endif
+  if (csv) {
+    printf("table,keys,ns_per_key,checksum\n");
+  } else {
+    printf("# lookups=%lu\n", lookups);
+    printf("%-18s %9s %9s %8s\n", "table", "keys", "ns/key", "checksum");
+  }
+  for (const auto &key_count : key_counts) {
+    auto keys = bustub::MakeKeys(std::stoull(key_count));
+    uint64_t rounds = std::max<uint64_t>(1, lookups / keys.size());
+
+    std::unordered_map<std::string, int> map;
+    bustub::TimeCount("std::unordered_map", keys, rounds, csv, [&map](const std::string &key) { return ++map[key]; });
+
+    bustub::FlatHashTable<int> table;
+    bustub::TimeCount("FlatHashTable", keys, rounds, csv, [&table](const std::string &key) {
+      return ++*table.FindOrInsert(key, [] { return 0; }).first;
+    });
+  }
+  return 0;
+}
@@ -0,0 +1,137 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_function_bench.cpp
+//
+// Identification: bench/hash_function_bench.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+// Hashing speed of the key hashers on GenericKey.
+//
+//   hash_function_bench --hashers=murmur3,crc32c,xxhash3,default --key-sizes=4,8,16,32,64 --keys=65536
+//                       --rounds=100 --csv=0
+//
+// The keys are sequential integers the way an index builds them, so most of their bytes are zero. "default" is the
+// hasher HashFunction picks for the key size. Build with CMAKE_BUILD_TYPE=Release, debug builds run with the address
+// sanitizer.
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "container/hash/hash_function.h"
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+namespace {
+
+// keys the way an index builds them: small integers, most bytes zero
+template <size_t KeySize>
+std::vector<GenericKey<KeySize>> SequentialKeys(uint64_t num_keys) {
+  std::vector<GenericKey<KeySize>> keys(num_keys);
+  for (uint64_t i = 0; i < num_keys; i++) {
+    if (KeySize < sizeof(int64_t)) {
+      // SetFromInteger writes 8 bytes, a 4 byte key holds an INTEGER column
+      auto column = static_cast<int32_t>(i);
+      memcpy(keys[i].data_, &column, sizeof(column));
+    } else {
+      keys[i].SetFromInteger(static_cast<int64_t>(i));
+    }
+  }
+  return keys;
+}
+
+template <size_t KeySize, typename Hasher>
+void TimeHasher(const std::string &name, uint64_t num_keys, uint64_t rounds, bool csv) {
+  auto keys = SequentialKeys<KeySize>(num_keys);
+  HashFunction<GenericKey<KeySize>, Hasher> hash_fn;
+  uint64_t sink = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (uint64_t r = 0; r < rounds; r++) {
+    for (const auto &key : keys) {
+      sink += hash_fn.GetHash(key);
+    }
+  }
+  std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+  double ns_per_key = elapsed.count() / static_cast<double>(num_keys * rounds);
+  // the checksum keeps the hashing from being optimized away
+  if (csv) {
+    printf("%s,%zu,%.3f,%lu\n", name.c_str(), KeySize, ns_per_key, sink & 0xFF);
+  } else {
+    printf("%-8s %4zu %9.3f %8lu\n", name.c_str(), KeySize, ns_per_key, sink & 0xFF);
+  }
+  fflush(stdout);
+}
+
+template <size_t KeySize>
+void BenchHasher(const std::string &hasher, uint64_t num_keys, uint64_t rounds, bool csv) {
+  if (hasher == "murmur3") {
+    TimeHasher<KeySize, MurmurHasher>(hasher, num_keys, rounds, csv);
+  } else if (hasher == "crc32c") {
+    TimeHasher<KeySize, Crc32cHasher>(hasher, num_keys, rounds, csv);
+  } else if (hasher == "xxhash3") {
+    TimeHasher<KeySize, XxHash3Hasher>(hasher, num_keys, rounds, csv);
+  } else if (hasher == "default") {
+    TimeHasher<KeySize, typename DefaultHasher<GenericKey<KeySize>>::type>(hasher, num_keys, rounds, csv);
+  } else {
+    fprintf(stderr, "unknown hasher %s\n", hasher.c_str());
+    exit(1);
+  }
+}
+
+}  // namespace
+
+}  // namespace bustub
+
+int main(int argc, char **argv) {
+  using bustub::BenchHasher;
+  bustub::BenchFlags flags(argc, argv);
+  auto hashers = flags.GetList("hashers", "murmur3,crc32c,xxhash3,default");
+  auto key_sizes = flags.GetList("key-sizes", "4,8,16,32,64");
+  uint64_t num_keys = flags.GetInt("keys", 1 << 16);
+  uint64_t rounds = flags.GetInt("rounds", 100);
+  bool csv = flags.GetInt("csv", 0) != 0;
+
+#ifndef NDEBUG
+  fprintf(stderr, "warning: built without NDEBUG, build with CMAKE_BUILD_TYPE=Release for meaningful numbers\n");
+#endif
+  if (csv) {
+    printf("hasher,key_size,ns_per_key,checksum\n");
+  } else {
+    printf("# keys=%lu rounds=%lu\n", num_keys, rounds);
+    printf("%-8s %4s %9s %8s\n", "hasher", "key", "ns/key", "checksum");
+  }
+  for (const auto &key_size : key_sizes) {
+    for (const auto &hasher : hashers) {
+      switch (std::stoul(key_size)) {
+        case 4:
+          BenchHasher<4>(hasher, num_keys, rounds, csv);
+          break;
+        case 8:
+          BenchHasher<8>(hasher, num_keys, rounds, csv);
+          break;
+        case 16:
+          BenchHasher<16>(hasher, num_keys, rounds, csv);
+          break;
+        case 32:
+          BenchHasher<32>(hasher, num_keys, rounds, csv);
+          break;
+        case 64:
+          BenchHasher<64>(hasher, num_keys, rounds, csv);
+          break;
+        default:
+          fprintf(stderr, "key sizes are 4, 8, 16, 32 or 64\n");
+          return 1;
+      }
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,246 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_bench.cpp
+//
+// Identification: bench/index_bench.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+// Insert, lookup and delete throughput and latency of LinearProbeHashTable and BPlusTree.
+//
+//   index_bench --index=hash,bplustree --key-sizes=4,8,16,32,64 --distributions=sequential,uniform,zipfian
+//               --threads=1,2,4,8 --keys=100000 --pool-pages=4096 --buckets=1024 --seed=42 --csv=0
+//
+// Every run starts from an empty index on a fresh buffer pool. The threads first insert their keys, then look
+// them up, then delete them, and each phase is reported on its own. Build with CMAKE_BUILD_TYPE=Release, debug
+// builds run with the address sanitizer.
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "buffer/buffer_pool_manager.h"
+#include "catalog/schema.h"
+#include "concurrency/transaction.h"
+#include "container/hash/linear_probe_hash_table.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+namespace {
+
+const char *const DB_FILE = "index_bench.db";
+
+struct BenchConfig {
+  size_t pool_pages_;
+  size_t buckets_;
+  uint64_t num_keys_;
+  uint64_t seed_;
+  bool csv_;
+};
+
+// the key schema of a GenericKey<KeySize>: one integer for 4 bytes, else KeySize / 8 bigints
+template <size_t KeySize>
+Schema MakeKeySchema() {
+  std::vector<Column> columns;
+  if (KeySize < sizeof(int64_t)) {
+    columns.emplace_back("c0", TypeId::INTEGER);
+  } else {
+    for (size_t i = 0; i < KeySize / sizeof(int64_t); i++) {
+      columns.emplace_back("c" + std::to_string(i), TypeId::BIGINT);
+    }
+  }
+  return Schema(columns);
+}
+
+// the key of an id, every column holds the id so that all bytes of the key differ between keys
+template <size_t KeySize>
+GenericKey<KeySize> MakeKey(uint64_t id) {
+  GenericKey<KeySize> key;
+  if (KeySize < sizeof(int64_t)) {
+    auto column = static_cast<int32_t>(id);
+    memcpy(key.data_, &column, sizeof(column));
+  } else {
+    for (size_t i = 0; i < KeySize / sizeof(int64_t); i++) {
+      auto column = static_cast<int64_t>(id);
+      memcpy(key.data_ + i * sizeof(int64_t), &column, sizeof(column));
+    }
+  }
+  return key;
+}
+
+void Report(const BenchConfig &config, const std::string &index, size_t key_size, const std::string &distribution,
+            size_t num_threads, const std::string &phase, const BenchResult &result) {
+  double mops = static_cast<double>(result.num_ops_) / result.seconds_ / 1e6;
+  if (config.csv_) {
+    printf("%s,%zu,%s,%zu,%s,%.3f,%.2f,%.2f,%.2f,%.2f\n", index.c_str(), key_size, distribution.c_str(), num_threads,
+           phase.c_str(), mops, result.p50_us_, result.p99_us_, result.p999_us_, result.max_us_);
+  } else {
+    printf("%-10s %4zu %-11s %3zu %-7s %9.3f %9.2f %9.2f %9.2f %9.2f\n", index.c_str(), key_size,
+           distribution.c_str(), num_threads, phase.c_str(), mops, result.p50_us_, result.p99_us_, result.p999_us_,
+           result.max_us_);
+  }
+  fflush(stdout);
+}
+
+// insert, look up and delete the keys of the streams, on an index made by make_index(bpm)
+template <size_t KeySize, typename MakeIndex, typename Insert, typename Lookup, typename Erase>
+void RunPhases(const BenchConfig &config, const std::string &index_name, const std::string &distribution,
+               size_t num_threads, MakeIndex make_index, Insert insert, Lookup lookup, Erase erase) {
+  auto streams = MakeKeyStreams(distribution, config.num_keys_, num_threads, config.seed_);
+  std::vector<std::vector<GenericKey<KeySize>>> keys(num_threads);
+  for (size_t t = 0; t < num_threads; t++) {
+    for (uint64_t id : streams[t]) {
+      keys[t].push_back(MakeKey<KeySize>(id));
+    }
+  }
+
+  auto *disk_manager = new DiskManager(DB_FILE);
+  auto *bpm = new BufferPoolManager(config.pool_pages_, disk_manager);
+  auto index = make_index(bpm);
+  std::vector<std::unique_ptr<Transaction>> txns;
+  for (size_t t = 0; t < num_threads; t++) {
+    txns.emplace_back(new Transaction(t));
+  }
+
+  // the value of a key records the operation that inserted it, so duplicate keys get distinct values
+  auto rid_of = [](size_t t, size_t i) { return RID(static_cast<page_id_t>(t), static_cast<uint32_t>(i)); };
+  auto insert_result =
+      RunTimed(streams, [&](size_t t, size_t i) { insert(index.get(), txns[t].get(), keys[t][i], rid_of(t, i)); });
+  Report(config, index_name, KeySize, distribution, num_threads, "insert", insert_result);
+  auto lookup_result = RunTimed(streams, [&](size_t t, size_t i) { lookup(index.get(), txns[t].get(), keys[t][i]); });
+  Report(config, index_name, KeySize, distribution, num_threads, "lookup", lookup_result);
+  auto delete_result =
+      RunTimed(streams, [&](size_t t, size_t i) { erase(index.get(), txns[t].get(), keys[t][i], rid_of(t, i)); });
+  Report(config, index_name, KeySize, distribution, num_threads, "delete", delete_result);
+
+  index.reset();
+  disk_manager->ShutDown();
+  remove(DB_FILE);
+  delete bpm;
+  delete disk_manager;
+}
+
+template <size_t KeySize>
+void BenchHashTable(const BenchConfig &config, const std::string &distribution, size_t num_threads) {
+  using HashTable = LinearProbeHashTable<GenericKey<KeySize>, RID, GenericComparator<KeySize>>;
+  Schema key_schema = MakeKeySchema<KeySize>();
+  GenericComparator<KeySize> comparator(&key_schema);
+  RunPhases<KeySize>(
+      config, "hash", distribution, num_threads,
+      [&](BufferPoolManager *bpm) {
+        return std::make_unique<HashTable>("index_bench", bpm, comparator, config.buckets_,
+                                           HashFunction<GenericKey<KeySize>>());
+      },
+      [](HashTable *ht, Transaction *txn, const GenericKey<KeySize> &key, const RID &rid) {
+        ht->Insert(txn, key, rid);
+      },
+      [](HashTable *ht, Transaction *txn, const GenericKey<KeySize> &key) {
+        std::vector<RID> result;
+        ht->GetValue(txn, key, &result);
+      },
+      [](HashTable *ht, Transaction *txn, const GenericKey<KeySize> &key, const RID &rid) {
+        ht->Remove(txn, key, rid);
+      });
+}
+
+template <size_t KeySize>
+void BenchBPlusTree(const BenchConfig &config, const std::string &distribution, size_t num_threads) {
+  using Tree = BPlusTree<GenericKey<KeySize>, RID, GenericComparator<KeySize>>;
+  Schema key_schema = MakeKeySchema<KeySize>();
+  GenericComparator<KeySize> comparator(&key_schema);
+  RunPhases<KeySize>(
+      config, "bplustree", distribution, num_threads,
+      [&](BufferPoolManager *bpm) {
+        // the tree keeps its root in the header page, page 0
+        page_id_t header_page_id;
+        bpm->NewPage(&header_page_id);
+        bpm->UnpinPage(header_page_id, true);
+        return std::make_unique<Tree>("index_bench", bpm, comparator);
+      },
+      [](Tree *tree, Transaction *txn, const GenericKey<KeySize> &key, const RID &rid) { tree->Insert(key, rid, txn); },
+      [](Tree *tree, Transaction *txn, const GenericKey<KeySize> &key) {
+        std::vector<RID> result;
+        tree->GetValue(key, &result, txn);
+      },
+      [](Tree *tree, Transaction *txn, const GenericKey<KeySize> &key, const RID &rid) { tree->Remove(key, txn); });
+}
+
+template <size_t KeySize>
+void BenchIndex(const BenchConfig &config, const std::string &index, const std::string &distribution,
+                size_t num_threads) {
+  if (index == "hash") {
+    BenchHashTable<KeySize>(config, distribution, num_threads);
+  } else if (index == "bplustree") {
+    BenchBPlusTree<KeySize>(config, distribution, num_threads);
+  } else {
+    fprintf(stderr, "unknown index %s\n", index.c_str());
+    exit(1);
+  }
+}
+
+}  // namespace
+
+}  // namespace bustub
+
+int main(int argc, char **argv) {
+  using bustub::BenchIndex;
+  bustub::BenchFlags flags(argc, argv);
+  bustub::BenchConfig config{flags.GetInt("pool-pages", 4096), flags.GetInt("buckets", 1024),
+                             flags.GetInt("keys", 100000), flags.GetInt("seed", 42), flags.GetInt("csv", 0) != 0};
+  auto indexes = flags.GetList("index", "hash,bplustree");
+  auto key_sizes = flags.GetList("key-sizes", "4,8,16,32,64");
+  auto distributions = flags.GetList("distributions", "sequential,uniform,zipfian");
+  auto thread_counts = flags.GetList("threads", "1,2,4,8");
+
+#ifndef NDEBUG
+  fprintf(stderr, "warning: built without NDEBUG, build with CMAKE_BUILD_TYPE=Release for meaningful numbers\n");
+#endif
+  if (config.csv_) {
+    printf("index,key_size,distribution,threads,phase,mops,p50_us,p99_us,p999_us,max_us\n");
+  } else {
+    printf("# keys=%lu pool-pages=%zu buckets=%zu seed=%lu\n", config.num_keys_, config.pool_pages_, config.buckets_,
+           config.seed_);
+    printf("%-10s %4s %-11s %3s %-7s %9s %9s %9s %9s %9s\n", "index", "key", "dist", "thr", "phase", "Mops/s",
+           "p50 us", "p99 us", "p99.9 us", "max us");
+  }
+  for (const auto &index : indexes) {
+    for (const auto &key_size : key_sizes) {
+      for (const auto &distribution : distributions) {
+        for (const auto &threads : thread_counts) {
+          size_t num_threads = std::stoul(threads);
+          switch (std::stoul(key_size)) {
+            case 4:
+              BenchIndex<4>(config, index, distribution, num_threads);
+              break;
+            case 8:
+              BenchIndex<8>(config, index, distribution, num_threads);
+              break;
+            case 16:
+              BenchIndex<16>(config, index, distribution, num_threads);
+              break;
+            case 32:
+              BenchIndex<32>(config, index, distribution, num_threads);
+              break;
+            case 64:
+              BenchIndex<64>(config, index, distribution, num_threads);
+              break;
+            default:
+              fprintf(stderr, "key sizes are 4, 8, 16, 32 or 64\n");
+              return 1;
+          }
+        }
+      }
+    }
+  }
+  return 0;
+}
@@ -43,6 +43,7 @@ Page *BufferPoolManager::FetchPageImpl(page_id_t page_id) {
   // 2.     If R is dirty, write it back to the disk.
   // 3.     Delete R from the page table and insert P.
   // 4.     Update P's metadata, read in the page content from disk, and then return a pointer to P.
+  std::scoped_lock latch{latch_};
   auto page = page_table_.find(page_id);
   if (page != page_table_.end()) {
     replacer_->Pin(page->second);
@@ -69,7 +70,7 @@ Page *BufferPoolManager::FetchPageImpl(page_id_t page_id) {
   auto page_to_remove = pages_[replacement].GetPageId();
 
   if (pages_[replacement].IsDirty()) {
-    if (!FlushPageImpl(page_to_remove)) return nullptr;
+    disk_manager_->WritePage(page_to_remove, pages_[replacement].data_);
   }
   page_table_.erase(page_to_remove);
   page_table_[page_id] = replacement;
@@ -82,17 +83,22 @@ Page *BufferPoolManager::FetchPageImpl(page_id_t page_id) {
 }
 
 bool BufferPoolManager::UnpinPageImpl(page_id_t page_id, bool is_dirty) {
+  std::scoped_lock latch{latch_};
   auto page = page_table_.find(page_id);
   if (page == page_table_.end()) return true;
   if (pages_[page->second].GetPinCount() <= 0) return false;
   pages_[page->second].pin_count_ -= 1;
-  pages_[page->second].is_dirty_ = is_dirty;
-  replacer_->Unpin(page->second);
+  // a clean unpin must not hide the changes of an earlier dirty one
+  pages_[page->second].is_dirty_ = pages_[page->second].is_dirty_ || is_dirty;
+  if (pages_[page->second].GetPinCount() == 0) {
+    replacer_->Unpin(page->second);
+  }
   return true;
 }
 
 bool BufferPoolManager::FlushPageImpl(page_id_t page_id) {
   // Make sure you call DiskManager::WritePage!
+  std::scoped_lock latch{latch_};
   auto page = page_table_.find(page_id);
   if (page == page_table_.end()) return false;
   if (!pages_[page->second].IsDirty()) return true;
@@ -107,7 +113,7 @@ Page *BufferPoolManager::NewPageImpl(page_id_t *page_id) {
   // 2.   Pick a victim page P from either the free list or the replacer. Always pick from the free list first.
   // 3.   Update P's metadata, zero out memory and add P to the page table.
   // 4.   Set the page ID output parameter. Return a pointer to P.
-
+  std::scoped_lock latch{latch_};
   frame_id_t victim;
   if (!free_list_.empty() > 0) {
     victim = free_list_.front();
@@ -126,7 +132,7 @@ Page *BufferPoolManager::NewPageImpl(page_id_t *page_id) {
   page_id_t page_to_remove = pages_[victim].GetPageId();
 
   if (pages_[victim].IsDirty()) {
-    if (!FlushPageImpl(page_to_remove)) return nullptr;
+    disk_manager_->WritePage(page_to_remove, pages_[victim].data_);
   }
   page_table_.erase(page_to_remove);
   *page_id = disk_manager_->AllocatePage();
@@ -145,22 +151,27 @@ bool BufferPoolManager::DeletePageImpl(page_id_t page_id) {
   // 1.   If P does not exist, return true.
   // 2.   If P exists, but has a non-zero pin-count, return false. Someone is using the page.
   // 3.   Otherwise, P can be deleted. Remove P from the page table, reset its metadata and return it to the free list.
-
+  std::scoped_lock latch{latch_};
   auto page = page_table_.find(page_id);
   if (page_id == INVALID_PAGE_ID || page == page_table_.end()) return true;
   if (pages_[page->second].GetPinCount() != 0) return false;
+  frame_id_t frame_id = page->second;
   disk_manager_->DeallocatePage(page_id);
-  page_table_.erase(page_id);
-  pages_[page->second].is_dirty_ = false;
-  pages_[page->second].page_id_ = INVALID_PAGE_ID;
-  free_list_.push_back(page->second);
+  page_table_.erase(page);
+  // the frame goes to the free list, so the replacer must not hand it out as well
+  replacer_->Pin(frame_id);
+  pages_[frame_id].is_dirty_ = false;
+  pages_[frame_id].page_id_ = INVALID_PAGE_ID;
+  free_list_.push_back(frame_id);
   return true;
 }
 
 void BufferPoolManager::FlushAllPagesImpl() {
+  std::scoped_lock latch{latch_};
   for (size_t i = 0; i < pool_size_; i++) {
     if (pages_[i].IsDirty()) {
-      FlushPageImpl(pages_[i].page_id_);
+      disk_manager_->WritePage(pages_[i].page_id_, pages_[i].data_);
+      pages_[i].is_dirty_ = false;
     }
   }
 }
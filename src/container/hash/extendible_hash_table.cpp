@@ -0,0 +1,437 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_hash_table.cpp
+//
+// Identification: src/container/hash/extendible_hash_table.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common/exception.h"
+#include "common/macros.h"
+#include "common/rid.h"
+#include "container/hash/extendible_hash_table.h"
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+EXTENDIBLE_HASH_TABLE_TYPE::ExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
+                                                const KeyComparator &comparator, size_t num_buckets,
+                                                HashFunction<KeyType> hash_fn)
+    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {
+  Page *page = buffer_pool_manager_->NewPage(&directory_page_id_);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate hash table directory page");
+  }
+  auto *dir = reinterpret_cast<HashTableDirectoryPage *>(page->GetData());
+  dir->SetPageId(directory_page_id_);
+
+  // start with enough buckets for num_buckets entries
+  while (dir->GetGlobalDepth() < DIRECTORY_MAX_DEPTH && dir->Size() * BLOCK_ARRAY_SIZE < num_buckets) {
+    dir->IncrGlobalDepth();
+  }
+  for (uint32_t i = 0; i < dir->Size(); i++) {
+    page_id_t bucket_page_id;
+    NewBucket(&bucket_page_id);
+    buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+    dir->SetBucketPageId(i, bucket_page_id);
+    dir->SetLocalDepth(i, dir->GetGlobalDepth());
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, true);
+}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key,
+                                          std::vector<ValueType> *result) {
+  uint64_t hash = Hash(key);
+  table_latch_.RLock();
+  auto *dir = reinterpret_cast<HashTableDirectoryPage *>(FetchPage(directory_page_id_)->GetData());
+  page_id_t bucket_page_id = dir->GetBucketPageId(DirectoryIndex(dir, hash));
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+
+  Page *page = FetchPage(bucket_page_id);
+  auto *bucket = reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(page->GetData());
+  page->RLatch();
+  VisitChain(bucket, false, [&](HASH_TABLE_BLOCK_TYPE *block) {
+    ScanBucket(block, HASH_TABLE_BLOCK_TYPE::TagOf(hash), [&](slot_offset_t i) {
+      if (comparator_(block->KeyAt(i), key) == 0) {
+        result->push_back(block->ValueAt(i));
+      }
+      return false;
+    });
+    return false;
+  });
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+  table_latch_.RUnlock();
+  return !result->empty();
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  uint64_t hash = Hash(key);
+  table_latch_.RLock();
+  auto *dir = reinterpret_cast<HashTableDirectoryPage *>(FetchPage(directory_page_id_)->GetData());
+  page_id_t bucket_page_id = dir->GetBucketPageId(DirectoryIndex(dir, hash));
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+
+  Page *page = FetchPage(bucket_page_id);
+  page->WLatch();
+  bool full;
+  bool inserted =
+      InsertIntoBucket(reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(page->GetData()), key, value, hash, &full);
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(bucket_page_id, inserted);
+  table_latch_.RUnlock();
+
+  if (inserted || !full) {
+    return inserted;
+  }
+  table_latch_.WLock();
+  inserted = SplitInsert(key, value);
+  table_latch_.WUnlock();
+  return inserted;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::SplitInsert(const KeyType &key, const ValueType &value) {
+  auto *dir = reinterpret_cast<HashTableDirectoryPage *>(FetchPage(directory_page_id_)->GetData());
+  uint64_t hash = Hash(key);
+  bool dir_dirty = false;
+  bool inserted = false;
+  while (true) {
+    // another writer may have split the bucket already, so look it up again every round
+    uint32_t bucket_idx = DirectoryIndex(dir, hash);
+    page_id_t bucket_page_id = dir->GetBucketPageId(bucket_idx);
+    auto *bucket = reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(FetchPage(bucket_page_id)->GetData());
+    bool full;
+    inserted = InsertIntoBucket(bucket, key, value, hash, &full);
+    uint32_t local_depth = dir->GetLocalDepth(bucket_idx);
+    if (!inserted && full && local_depth == DIRECTORY_MAX_DEPTH) {
+      // a bucket whose keys agree on every bit the directory can use cannot be split any further
+      inserted = AppendOverflowPage(bucket, key, value, hash);
+    }
+    if (inserted || !full || local_depth == DIRECTORY_MAX_DEPTH) {
+      buffer_pool_manager_->UnpinPage(bucket_page_id, inserted);
+      break;
+    }
+    // only buckets at the maximum depth have overflow pages, see Merge
+    BUSTUB_ASSERT(bucket->GetNextPageId() == INVALID_PAGE_ID, "splitting a bucket with overflow pages");
+
+    if (local_depth == dir->GetGlobalDepth()) {
+      dir->IncrGlobalDepth();
+    }
+    // the slots sharing the bucket are told apart by hash bit local_depth, those with it set get the image
+    page_id_t image_page_id;
+    auto *image = reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(NewBucket(&image_page_id)->GetData());
+    uint32_t low_mask = (1U << local_depth) - 1;
+    for (uint32_t i = 0; i < dir->Size(); i++) {
+      if ((i & low_mask) != (bucket_idx & low_mask)) {
+        continue;
+      }
+      dir->SetLocalDepth(i, local_depth + 1);
+      if (((i >> local_depth) & 1) != 0) {
+        dir->SetBucketPageId(i, image_page_id);
+      }
+    }
+    dir_dirty = true;
+
+    slot_offset_t image_slot = 0;
+    for (slot_offset_t i = 0; i < BLOCK_ARRAY_SIZE && bucket->IsOccupied(i); i++) {
+      if (bucket->IsReadable(i) && ((Hash(bucket->KeyAt(i)) >> local_depth) & 1) != 0) {
+        image->Insert(image_slot++, bucket->KeyAt(i), bucket->ValueAt(i), bucket->TagAt(i));
+        bucket->Remove(i);
+      }
+    }
+    buffer_pool_manager_->UnpinPage(image_page_id, true);
+    buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, dir_dirty);
+  return inserted;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::InsertIntoBucket(HASH_TABLE_BLOCK_TYPE *bucket, const KeyType &key,
+                                                  const ValueType &value, uint64_t hash, bool *full) {
+  uint8_t tag = HASH_TABLE_BLOCK_TYPE::TagOf(hash);
+  *full = false;
+  bool duplicate = VisitChain(bucket, false, [&](HASH_TABLE_BLOCK_TYPE *block) {
+    return ScanBucket(block, tag, [&](slot_offset_t i) {
+      return comparator_(block->KeyAt(i), key) == 0 && block->ValueAt(i) == value;
+    });
+  });
+  if (duplicate) {
+    return false;
+  }
+  bool inserted = VisitChain(bucket, true, [&](HASH_TABLE_BLOCK_TYPE *block) {
+    for (size_t group = 0; group < BLOCK_TAG_GROUPS; group++) {
+      uint32_t free_slots = ~block->ReadableMask(group) & HASH_TABLE_BLOCK_TYPE::GroupMask(group);
+      if (free_slots != 0) {
+        return block->Insert(group * TAG_GROUP_SIZE + __builtin_ctz(free_slots), key, value, tag);
+      }
+    }
+    return false;
+  });
+  *full = !inserted;
+  return inserted;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::AppendOverflowPage(HASH_TABLE_BLOCK_TYPE *bucket, const KeyType &key,
+                                                    const ValueType &value, uint64_t hash) {
+  page_id_t overflow_page_id;
+  auto *overflow = reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(NewBucket(&overflow_page_id)->GetData());
+  overflow->Insert(0, key, value, HASH_TABLE_BLOCK_TYPE::TagOf(hash));
+  buffer_pool_manager_->UnpinPage(overflow_page_id, true);
+  // every page of the chain is full, so the new page goes at its end
+  VisitChain(bucket, true, [&](HASH_TABLE_BLOCK_TYPE *block) {
+    if (block->GetNextPageId() != INVALID_PAGE_ID) {
+      return false;
+    }
+    block->SetNextPageId(overflow_page_id);
+    return true;
+  });
+  return true;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void EXTENDIBLE_HASH_TABLE_TYPE::PruneChain(HASH_TABLE_BLOCK_TYPE *bucket) {
+  HASH_TABLE_BLOCK_TYPE *prev = bucket;
+  Page *prev_page = nullptr;
+  page_id_t page_id = bucket->GetNextPageId();
+  while (page_id != INVALID_PAGE_ID) {
+    Page *page = FetchPage(page_id);
+    auto *block = reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(page->GetData());
+    page_id_t next_page_id = block->GetNextPageId();
+    if (IsEmptyBucket(block)) {
+      prev->SetNextPageId(next_page_id);
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      buffer_pool_manager_->DeletePage(page_id);
+    } else {
+      if (prev_page != nullptr) {
+        buffer_pool_manager_->UnpinPage(prev_page->GetPageId(), true);
+      }
+      prev = block;
+      prev_page = page;
+    }
+    page_id = next_page_id;
+  }
+  if (prev_page != nullptr) {
+    buffer_pool_manager_->UnpinPage(prev_page->GetPageId(), true);
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename PageVisitor>
+bool EXTENDIBLE_HASH_TABLE_TYPE::VisitChain(HASH_TABLE_BLOCK_TYPE *bucket, bool modify, PageVisitor visit) {
+  if (visit(bucket)) {
+    return true;
+  }
+  for (page_id_t page_id = bucket->GetNextPageId(); page_id != INVALID_PAGE_ID;) {
+    auto *block = reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(FetchPage(page_id)->GetData());
+    bool stop = visit(block);
+    page_id_t next_page_id = block->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, modify && stop);
+    if (stop) {
+      return true;
+    }
+    page_id = next_page_id;
+  }
+  return false;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename SlotVisitor>
+bool EXTENDIBLE_HASH_TABLE_TYPE::ScanBucket(HASH_TABLE_BLOCK_TYPE *bucket, uint8_t tag, SlotVisitor visit) {
+  for (size_t group = 0; group < BLOCK_TAG_GROUPS; group++) {
+    for (uint32_t matches = bucket->MatchTag(group, tag); matches != 0; matches &= matches - 1) {
+      if (visit(static_cast<slot_offset_t>(group * TAG_GROUP_SIZE + __builtin_ctz(matches)))) {
+        return true;
+      }
+    }
+    // occupied slots form a prefix of the bucket, nothing follows the first never used slot
+    if (bucket->OccupiedMask(group) != HASH_TABLE_BLOCK_TYPE::GroupMask(group)) {
+      break;
+    }
+  }
+  return false;
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  uint64_t hash = Hash(key);
+  table_latch_.RLock();
+  auto *dir = reinterpret_cast<HashTableDirectoryPage *>(FetchPage(directory_page_id_)->GetData());
+  page_id_t bucket_page_id = dir->GetBucketPageId(DirectoryIndex(dir, hash));
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+
+  Page *page = FetchPage(bucket_page_id);
+  auto *bucket = reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(page->GetData());
+  page->WLatch();
+  bool removed = VisitChain(bucket, true, [&](HASH_TABLE_BLOCK_TYPE *block) {
+    return ScanBucket(block, HASH_TABLE_BLOCK_TYPE::TagOf(hash), [&](slot_offset_t i) {
+      if (comparator_(block->KeyAt(i), key) != 0 || !(block->ValueAt(i) == value)) {
+        return false;
+      }
+      block->Remove(i);
+      return true;
+    });
+  });
+  if (removed && bucket->GetNextPageId() != INVALID_PAGE_ID) {
+    PruneChain(bucket);
+  }
+  bool empty = removed && IsEmptyBucket(bucket) && bucket->GetNextPageId() == INVALID_PAGE_ID;
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(bucket_page_id, removed);
+  table_latch_.RUnlock();
+
+  if (empty) {
+    table_latch_.WLock();
+    Merge(key);
+    table_latch_.WUnlock();
+  }
+  return removed;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void EXTENDIBLE_HASH_TABLE_TYPE::Merge(const KeyType &key) {
+  auto *dir = reinterpret_cast<HashTableDirectoryPage *>(FetchPage(directory_page_id_)->GetData());
+  uint64_t hash = Hash(key);
+  bool dir_dirty = false;
+  // a merge can make the merged bucket and its own image mergeable, so keep folding up
+  while (true) {
+    uint32_t bucket_idx = DirectoryIndex(dir, hash);
+    uint32_t local_depth = dir->GetLocalDepth(bucket_idx);
+    uint32_t image_idx = dir->GetSplitImageIndex(bucket_idx);
+    if (local_depth == 0 || dir->GetLocalDepth(image_idx) != local_depth) {
+      break;
+    }
+    page_id_t bucket_page_id = dir->GetBucketPageId(bucket_idx);
+    page_id_t image_page_id = dir->GetBucketPageId(image_idx);
+
+    // an insert may have refilled the bucket before we got the latch, and the image may be the empty one
+    // a bucket with overflow pages is never folded, so that only buckets at the maximum depth have them
+    auto *bucket = reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(FetchPage(bucket_page_id)->GetData());
+    bool bucket_empty = IsEmptyBucket(bucket);
+    bool bucket_chained = bucket->GetNextPageId() != INVALID_PAGE_ID;
+    buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+    auto *image = reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(FetchPage(image_page_id)->GetData());
+    bool image_empty = IsEmptyBucket(image);
+    bool image_chained = image->GetNextPageId() != INVALID_PAGE_ID;
+    buffer_pool_manager_->UnpinPage(image_page_id, false);
+    if ((!bucket_empty && !image_empty) || bucket_chained || image_chained) {
+      break;
+    }
+
+    page_id_t kept_page_id = bucket_empty ? image_page_id : bucket_page_id;
+    page_id_t dropped_page_id = bucket_empty ? bucket_page_id : image_page_id;
+    for (uint32_t i = 0; i < dir->Size(); i++) {
+      page_id_t page_id = dir->GetBucketPageId(i);
+      if (page_id == bucket_page_id || page_id == image_page_id) {
+        dir->SetBucketPageId(i, kept_page_id);
+        dir->SetLocalDepth(i, local_depth - 1);
+      }
+    }
+    buffer_pool_manager_->DeletePage(dropped_page_id);
+    while (dir->CanShrink()) {
+      dir->DecrGlobalDepth();
+    }
+    dir_dirty = true;
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, dir_dirty);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::IsEmptyBucket(HASH_TABLE_BLOCK_TYPE *bucket) {
+  for (size_t group = 0; group < BLOCK_TAG_GROUPS; group++) {
+    if (bucket->ReadableMask(group) != 0) {
+      return false;
+    }
+    if (bucket->OccupiedMask(group) != HASH_TABLE_BLOCK_TYPE::GroupMask(group)) {
+      break;
+    }
+  }
+  return true;
+}
+
+/*****************************************************************************
+ * UTILITIES
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+Page *EXTENDIBLE_HASH_TABLE_TYPE::FetchPage(page_id_t page_id) {
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch hash table page");
+  }
+  return page;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+Page *EXTENDIBLE_HASH_TABLE_TYPE::NewBucket(page_id_t *bucket_page_id) {
+  Page *page = buffer_pool_manager_->NewPage(bucket_page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate hash table bucket page");
+  }
+  reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(page->GetData())->SetNextPageId(INVALID_PAGE_ID);
+  return page;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint32_t EXTENDIBLE_HASH_TABLE_TYPE::GetGlobalDepth() {
+  table_latch_.RLock();
+  auto *dir = reinterpret_cast<HashTableDirectoryPage *>(FetchPage(directory_page_id_)->GetData());
+  uint32_t global_depth = dir->GetGlobalDepth();
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  table_latch_.RUnlock();
+  return global_depth;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void EXTENDIBLE_HASH_TABLE_TYPE::VerifyIntegrity() {
+  table_latch_.RLock();
+  auto *dir = reinterpret_cast<HashTableDirectoryPage *>(FetchPage(directory_page_id_)->GetData());
+  std::unordered_map<page_id_t, uint32_t> slot_count;
+  std::unordered_map<page_id_t, uint32_t> local_depth;
+  for (uint32_t i = 0; i < dir->Size(); i++) {
+    page_id_t page_id = dir->GetBucketPageId(i);
+    BUSTUB_ASSERT(dir->GetLocalDepth(i) <= dir->GetGlobalDepth(), "local depth above global depth");
+    BUSTUB_ASSERT(local_depth.count(page_id) == 0 || local_depth[page_id] == dir->GetLocalDepth(i),
+                  "slots of a bucket disagree on its local depth");
+    local_depth[page_id] = dir->GetLocalDepth(i);
+    slot_count[page_id]++;
+  }
+  for (const auto &page_and_count : slot_count) {
+    BUSTUB_ASSERT(page_and_count.second == 1U << (dir->GetGlobalDepth() - local_depth[page_and_count.first]),
+                  "bucket referenced by the wrong number of slots");
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  table_latch_.RUnlock();
+}
+
+template class ExtendibleHashTable<int, int, IntComparator>;
+
+template class ExtendibleHashTable<GenericKey<4>, RID, GenericComparator<4>>;
+template class ExtendibleHashTable<GenericKey<8>, RID, GenericComparator<8>>;
+template class ExtendibleHashTable<GenericKey<16>, RID, GenericComparator<16>>;
+template class ExtendibleHashTable<GenericKey<32>, RID, GenericComparator<32>>;
+template class ExtendibleHashTable<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
@@ -10,11 +10,13 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <functional>
 #include <iostream>
 #include <string>
+#include <thread>  // NOLINT
 #include <utility>
 #include <vector>
-#include <math.h>
 
 #include "common/exception.h"
 #include "common/logger.h"
@@ -23,111 +25,113 @@
 
 namespace bustub {
 
+namespace {
+
+// the bits [begin, end) of a tag group mask
+uint32_t RunMask(size_t begin, size_t end) {
+  uint32_t below_end = end >= TAG_GROUP_SIZE ? ~0U : (1U << end) - 1;
+  return below_end & ~((1U << begin) - 1);
+}
+
+}  // namespace
+
 template <typename KeyType, typename ValueType, typename KeyComparator>
 HASH_TABLE_TYPE::LinearProbeHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
                                       const KeyComparator &comparator, size_t num_buckets,
                                       HashFunction<KeyType> hash_fn)
     : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {
-      //header page
-    Page *header = buffer_pool_manager->NewPage(&header_page_id_);
-    auto headerPage = reinterpret_cast<HashTableHeaderPage*>(header->GetData());
-    headerPage->SetPageId(header_page_id_);
-    headerPage->SetSize(num_buckets);
-
-    //block pages
-    auto blocknum = ceil(num_buckets / BLOCK_ARRAY_SIZE);
-    page_id_t blockPageId;
-    for(unsigned i = 0; i< blocknum; i++){
-      buffer_pool_manager->NewPage(&blockPageId);
-      buffer_pool_manager->UnpinPage(blockPageId, true);
-      buffer_pool_manager->FlushPage(blockPageId);
-      headerPage->AddBlockPageId(blockPageId);
-    }
-    buffer_pool_manager->UnpinPage(header_page_id_, true);
-
- 
-  
-    }
+  auto generations = std::make_shared<Generations>();
+  generations->current_ = std::make_shared<Generation>(buffer_pool_manager_, std::max<size_t>(num_buckets, 1));
+  std::atomic_store(&generations_, std::shared_ptr<const Generations>(generations));
+}
 
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) {
-  table_latch_.RLock();
-  Page *header = buffer_pool_manager_->FetchPage(header_page_id_);
-    auto *headerPage = reinterpret_cast<HashTableHeaderPage*>(header->GetData());
-    auto start = hash_fn_.GetHash(key) % headerPage->GetSize();
-    auto finish = false;
-      for (auto i = start;;i = (i+1) % headerPage->GetSize()){
-
-      if(i == start){
-        if(finish) break;
-        finish = true;
-      }
-
-    auto blockIndex = start / BLOCK_ARRAY_SIZE;
-    auto blockPageId = headerPage->GetBlockPageId(blockIndex);
-    auto block = buffer_pool_manager_->FetchPage(blockPageId);
-    auto blockPage = reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(block->GetData());
-    auto offset = i % BLOCK_ARRAY_SIZE;
-      block->RLatch();
-      if(!blockPage->IsOccupied(offset)) {
-        block->RUnlatch();
-        break;
-        }
-      
-      if(blockPage->IsReadable(offset) && comparator_(blockPage->KeyAt(offset),key) == 0) {
-        result->push_back(blockPage->ValueAt(offset));
-      }
-      block->RUnlatch();
-    }
-    table_latch_.RUnlock();
-    if (result->size() > 0){
+  uint64_t hash = hash_fn_.GetHash(key);
+  std::vector<ValueType> values;
+  // values found in the old generation, an entry being moved may show up in both
+  size_t num_old_values = 0;
+  auto collect = [&](HASH_TABLE_BLOCK_TYPE *block, slot_offset_t offset) {
+    if (!block->IsOccupied(offset)) {
       return true;
     }
+    MappingType pair;
+    if (block->ReadPair(offset, &pair)) {
+      auto old_end = values.begin() + num_old_values;
+      if (comparator_(pair.first, key) == 0 && std::find(values.begin(), old_end, pair.second) == old_end) {
+        values.push_back(pair.second);
+      }
+    }
     return false;
+  };
 
+  while (true) {
+    auto generations = LoadGenerations();
+    values.clear();
+    num_old_values = 0;
+    // a migration inserts into the current generation before it removes from the old one, so probing the
+    // old one first cannot miss an entry that moves meanwhile
+    if (generations->old_ != nullptr) {
+      Probe(*generations->old_, hash, false, collect);
+      num_old_values = values.size();
+    }
+    Probe(*generations->current_, hash, false, collect);
+    // a resize that started or finished while probing may have moved entries past the probes, so look again
+    if (LoadGenerations() == generations) {
+      break;
+    }
+  }
+  result->insert(result->end(), values.begin(), values.end());
+  return !values.empty();
 }
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) {
-  table_latch_.RLock();
-  Page *header = buffer_pool_manager_->FetchPage(header_page_id_);
-  auto *headerPage = reinterpret_cast<HashTableHeaderPage*>(header->GetData());
-  auto start = hash_fn_.GetHash(key) % headerPage->GetSize();
-  auto finish = false;
-    for (auto i = start;;i = (i+1) % headerPage->GetSize()){
-
-    if(i == start){
-      if(finish) break;
-      finish = true;
-    }
-  auto blockIndex = start / BLOCK_ARRAY_SIZE;
-  auto blockPageId = headerPage->GetBlockPageId(blockIndex);
-  auto block = buffer_pool_manager_->FetchPage(blockPageId);
-  auto blockPage = reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(block->GetData());
-  auto offset = i % BLOCK_ARRAY_SIZE;
-  block->WLatch();
-    if(blockPage->IsOccupied(offset) && comparator_(blockPage->KeyAt(offset),key) == 0 && blockPage->ValueAt(offset) == value){
-      block->WUnlatch();
-      table_latch_.RUnlock();
-      return false;
+  uint64_t hash = hash_fn_.GetHash(key);
+  // a full table is retried until the resize it starts, or the migration it waits for, makes room
+  while (true) {
+    MigrateStep();
+
+    std::shared_ptr<const Generations> generations;
+    bool full;
+    bool inserted;
+    bool overloaded;
+    {
+      ReadLatchGuard guard(&table_latch_);
+      generations = LoadGenerations();
+      if (generations->old_ != nullptr && Contains(*generations->old_, key, value, hash)) {
+        return false;
+      }
+      inserted = InsertInto(*generations->current_, key, value, hash, &full);
+      overloaded = static_cast<double>(num_occupied_) >
+                   MAX_LOAD_FACTOR * static_cast<double>(generations->current_->num_buckets_);
     }
 
-    if(blockPage->Insert(offset,key,value)) {
-      block->WUnlatch();
-      table_latch_.RUnlock();
+    if (!inserted && !full) {
+      return false;
+    }
+    if (full || overloaded) {
+      WriteLatchGuard guard(&table_latch_);
+      // another writer may have started the resize already
+      if (LoadGenerations()->current_ == generations->current_) {
+        size_t num_buckets = GrowthTarget(*generations->current_, full);
+        if (num_buckets == 0) {
+          // the table is as large as it gets, it takes entries until its last slot is used
+          return inserted;
+        }
+        BeginResize(num_buckets);
+      }
+    }
+    if (inserted) {
       return true;
     }
-
-   block->WUnlatch(); 
   }
-  table_latch_.RUnlock();
-  this->Resize(headerPage->GetSize());
-  return this->Insert(transaction, key, value);
 }
 
 /*****************************************************************************
@@ -135,35 +139,210 @@ bool HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) {
-  table_latch_.RLock();
-  Page *header = buffer_pool_manager_->FetchPage(header_page_id_);
-  auto *headerPage = reinterpret_cast<HashTableHeaderPage*>(header->GetData());
-  auto start = hash_fn_.GetHash(key) % headerPage->GetSize();
-  //auto found = false;
-  auto finish = false;
-    for (auto i = start;;i = (i+1) % headerPage->GetSize()){
-
-    if(i == start){
-      if(finish) break;
-      finish = true;
-    }
-  auto blockIndex = start / BLOCK_ARRAY_SIZE;
-  auto blockPageId = headerPage->GetBlockPageId(blockIndex);
-  auto block = buffer_pool_manager_->FetchPage(blockPageId);
-  auto blockPage = reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(block->GetData());
-  auto offset = i % BLOCK_ARRAY_SIZE;
-    block->WLatch();
-    if(blockPage->IsOccupied(offset) && blockPage->IsReadable(offset) && comparator_(blockPage->KeyAt(offset),key) == 0 &&
-    value == blockPage->ValueAt(offset)) {
-      blockPage->Remove(offset);
-      block->WUnlatch();
-      table_latch_.RUnlock();
-      return true;
+  MigrateStep();
+
+  uint64_t hash = hash_fn_.GetHash(key);
+  std::shared_ptr<const Generations> generations;
+  bool removed;
+  bool compact = false;
+  {
+    ReadLatchGuard guard(&table_latch_);
+    generations = LoadGenerations();
+    const Generation &current = *generations->current_;
+    removed = RemoveFrom(current, key, value, hash, true);
+    if (removed) {
+      compact =
+          static_cast<double>(num_tombstones_) > MAX_TOMBSTONE_FRACTION * static_cast<double>(current.num_buckets_);
+    } else if (generations->old_ != nullptr) {
+      removed = RemoveFrom(*generations->old_, key, value, hash, false);
+    }
+  }
+
+  // a resize in progress drops the tombstones anyway
+  if (compact && generations->old_ == nullptr) {
+    WriteLatchGuard guard(&table_latch_);
+    if (LoadGenerations()->current_ == generations->current_) {
+      BeginResize(generations->current_->num_buckets_);
+    }
+  }
+  return removed;
+}
+
+/*****************************************************************************
+ * BULK LOAD
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::BulkLoad(const std::vector<MappingType> &entries, size_t num_threads, std::vector<bool> *loaded) {
+  if (loaded != nullptr) {
+    loaded->assign(entries.size(), true);
+  }
+  {
+    WriteLatchGuard guard(&table_latch_);
+    auto generations = LoadGenerations();
+    if (generations->old_ == nullptr) {
+      if (num_occupied_ == 0) {
+        Regenerate(entries.size());
+        generations = LoadGenerations();
+      }
+      const Generation &current = *generations->current_;
+      if (static_cast<double>(num_occupied_ + entries.size()) <=
+          MAX_LOAD_FACTOR * static_cast<double>(current.num_buckets_)) {
+        LoadInto(current, entries, num_threads, loaded);
+        return;
+      }
+    }
+  }
+  for (size_t i = 0; i < entries.size(); i++) {
+    bool inserted = Insert(nullptr, entries[i].first, entries[i].second);
+    if (loaded != nullptr) {
+      (*loaded)[i] = inserted;
+    }
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::Reserve(size_t num_entries) {
+  WriteLatchGuard guard(&table_latch_);
+  if (num_occupied_ == 0 && LoadGenerations()->old_ == nullptr) {
+    Regenerate(num_entries);
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::Regenerate(size_t num_entries) {
+  // size the table like one that has just doubled to hold the entries, so loading them does not resize, but no
+  // larger than a header page can address
+  auto max_entries = static_cast<size_t>(MAX_LOAD_FACTOR * static_cast<double>(MAX_NUM_BUCKETS));
+  if (num_entries > max_entries) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "Too many entries for one hash table header page");
+  }
+  auto generations = LoadGenerations();
+  size_t num_buckets = std::min(2 * num_entries, MAX_NUM_BUCKETS);
+  if (num_buckets <= generations->current_->num_buckets_) {
+    return;
+  }
+  // the empty generation the table started with is dropped
+  generations->current_->retired_ = true;
+  auto regenerated = std::make_shared<Generations>();
+  regenerated->current_ = std::make_shared<Generation>(buffer_pool_manager_, num_buckets);
+  std::atomic_store(&generations_, std::shared_ptr<const Generations>(regenerated));
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::LoadInto(const Generation &generation, const std::vector<MappingType> &entries,
+                               size_t num_threads, std::vector<bool> *loaded) {
+  size_t num_buckets = generation.num_buckets_;
+  size_t num_blocks = generation.block_page_ids_.size();
+  num_threads = std::max<size_t>(1, std::min(num_threads, num_blocks));
+  auto run_parallel = [num_threads](const std::function<void(size_t)> &task) {
+    std::vector<std::thread> threads;
+    for (size_t t = 1; t < num_threads; t++) {
+      threads.emplace_back(task, t);
+    }
+    task(0);
+    for (auto &thread : threads) {
+      thread.join();
+    }
+  };
+
+  // hash every entry once, drop the pairs that are in the table already like Insert does, then group the entries
+  // by the block of their home slot
+  std::vector<uint64_t> hashes(entries.size());
+  std::vector<char> present(entries.size(), 0);
+  bool check_present = num_occupied_ != 0;
+  run_parallel([&](size_t t) {
+    for (size_t i = t; i < entries.size(); i += num_threads) {
+      hashes[i] = hash_fn_.GetHash(entries[i].first);
+      present[i] = static_cast<char>(check_present && Contains(generation, entries[i].first, entries[i].second,
+                                                                hashes[i]));
+    }
+  });
+  std::vector<size_t> block_begin(num_blocks + 1, 0);
+  size_t num_loaded = 0;
+  for (size_t i = 0; i < entries.size(); i++) {
+    if (present[i] != 0) {
+      if (loaded != nullptr) {
+        (*loaded)[i] = false;
+      }
+      continue;
+    }
+    block_begin[hashes[i] % num_buckets / BLOCK_ARRAY_SIZE + 1]++;
+    num_loaded++;
+  }
+  for (size_t b = 0; b < num_blocks; b++) {
+    block_begin[b + 1] += block_begin[b];
+  }
+  std::vector<size_t> order(num_loaded);
+  std::vector<size_t> cursor(block_begin.begin(), block_begin.end() - 1);
+  for (size_t i = 0; i < entries.size(); i++) {
+    if (present[i] == 0) {
+      order[cursor[hashes[i] % num_buckets / BLOCK_ARRAY_SIZE]++] = i;
+    }
+  }
+
+  // every thread fills a range of blocks, the entries that run off the end of a range are inserted afterwards
+  size_t blocks_per_thread = (num_blocks - 1) / num_threads + 1;
+  std::vector<std::vector<size_t>> spills(num_threads);
+  run_parallel([&](size_t t) {
+    size_t end = std::min(num_blocks, (t + 1) * blocks_per_thread);
+    for (size_t b = t * blocks_per_thread; b < end; b++) {
+      std::vector<size_t> block_entries(order.begin() + block_begin[b], order.begin() + block_begin[b + 1]);
+      FillBlock(generation, b, entries, hashes, &block_entries, &spills[t]);
+    }
+  });
+
+  num_occupied_ += num_loaded;
+  for (const auto &spill : spills) {
+    num_occupied_ -= spill.size();
+  }
+  for (const auto &spill : spills) {
+    for (size_t i : spill) {
+      bool full;
+      InsertInto(generation, entries[i].first, entries[i].second, hashes[i], &full);
     }
-    block->WUnlatch();
   }
-  table_latch_.RUnlock();
-  return false;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::FillBlock(const Generation &generation, size_t block_index,
+                                const std::vector<MappingType> &entries, const std::vector<uint64_t> &hashes,
+                                std::vector<size_t> *block_entries, std::vector<size_t> *carry) {
+  size_t num_buckets = generation.num_buckets_;
+  size_t num_slots = std::min<size_t>(BLOCK_ARRAY_SIZE, num_buckets - block_index * BLOCK_ARRAY_SIZE);
+  auto home = [&](size_t i) { return hashes[i] % num_buckets % BLOCK_ARRAY_SIZE; };
+  std::sort(block_entries->begin(), block_entries->end(),
+            [&](size_t lhs, size_t rhs) { return home(lhs) < home(rhs); });
+
+  // lookups may probe the page while it is filled, they see a slot once its readable bit is set
+  page_id_t block_page_id = generation.block_page_ids_[block_index];
+  Page *page = FetchPage(block_page_id);
+  auto *block = reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(page->GetData());
+  std::vector<size_t> incoming;
+  incoming.swap(*carry);
+  // slots below next are taken, so every entry goes to the first free slot at or after its home slot, skipping the
+  // slots that were taken before the load
+  size_t next = 0;
+  auto place = [&](size_t i, size_t home_slot) {
+    next = std::max(next, home_slot);
+    while (next < num_slots && block->IsOccupied(next)) {
+      next++;
+    }
+    if (next == num_slots) {
+      carry->push_back(i);
+      return;
+    }
+    block->Insert(next++, entries[i].first, entries[i].second, HASH_TABLE_BLOCK_TYPE::TagOf(hashes[i]));
+  };
+  page->WLatch();
+  // entries carried over have their home slot in an earlier block
+  for (size_t i : incoming) {
+    place(i, 0);
+  }
+  for (size_t i : *block_entries) {
+    place(i, home(i));
+  }
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(block_page_id, true);
 }
 
 /*****************************************************************************
@@ -171,26 +350,109 @@ bool HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 void HASH_TABLE_TYPE::Resize(size_t initial_size) {
-  table_latch_.WLock();
-  Page *header = buffer_pool_manager_->FetchPage(header_page_id_);
-  auto *headerPage = reinterpret_cast<HashTableHeaderPage*>(header->GetData());
-  auto newSize = initial_size * 2;
-  headerPage->SetSize(newSize);
-  page_id_t blockPageId;
-      for(unsigned i = 0; i< initial_size; i++){
-        buffer_pool_manager_->NewPage(&blockPageId);
-        headerPage->AddBlockPageId(blockPageId);
-        buffer_pool_manager_->UnpinPage(blockPageId, true);
-      }
-      headerPage->ResetIndex();
-      for (size_t idx = 0; idx < headerPage->NumBlocks(); idx++) {
-      const auto &block = reinterpret_cast<HASH_TABLE_BLOCK_TYPE*>(buffer_pool_manager_->FetchPage(headerPage->GetBlockPageId(idx))->GetData()); 
-      for (size_t pair_idx = 0; pair_idx < BLOCK_ARRAY_SIZE; pair_idx++) {
-        this->Insert(nullptr, block->KeyAt(pair_idx), block->ValueAt(pair_idx));
+  WriteLatchGuard guard(&table_latch_);
+  BeginResize(std::clamp<size_t>(2 * initial_size, 1, MAX_NUM_BUCKETS));
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::Compact() {
+  WriteLatchGuard guard(&table_latch_);
+  // the tombstones of an old generation are dropped when it is drained anyway
+  if (num_tombstones_ > 0) {
+    BeginResize(LoadGenerations()->current_->num_buckets_);
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_TYPE::ResizeStep(size_t num_slots) {
+  WriteLatchGuard guard(&table_latch_);
+  MigrateSlots(num_slots);
+  return IsResizing();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+size_t HASH_TABLE_TYPE::GrowthTarget(const Generation &current, bool full) const {
+  // without its tombstones the table must come out at most half as loaded as a resize allows
+  double live = static_cast<double>(num_occupied_) - static_cast<double>(num_tombstones_);
+  if (live <= MAX_LOAD_FACTOR / 2 * static_cast<double>(current.num_buckets_)) {
+    return current.num_buckets_;
+  }
+  if (current.num_buckets_ < MAX_NUM_BUCKETS) {
+    return std::min(2 * current.num_buckets_, MAX_NUM_BUCKETS);
+  }
+  // at the largest size, the tombstones are only dropped once they hold the last free slots
+  return full && num_tombstones_ > 0 ? current.num_buckets_ : 0;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::BeginResize(size_t num_buckets) {
+  // a table drains one old generation at a time, the migration steps start this resize once it is done
+  if (IsResizing()) {
+    pending_num_buckets_ = std::max(pending_num_buckets_, num_buckets);
+    return;
+  }
+  auto generations = std::make_shared<Generations>();
+  generations->old_ = LoadGenerations()->current_;
+  generations->current_ = std::make_shared<Generation>(buffer_pool_manager_, num_buckets);
+  migrate_cursor_ = 0;
+  num_occupied_ = 0;
+  num_tombstones_ = 0;
+  std::atomic_store(&generations_, std::shared_ptr<const Generations>(generations));
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::MigrateSlots(size_t num_slots) {
+  auto generations = LoadGenerations();
+  if (generations->old_ == nullptr) {
+    return;
+  }
+  const Generation &old = *generations->old_;
+  size_t end = std::min(old.num_buckets_, migrate_cursor_ + num_slots);
+  while (migrate_cursor_ < end) {
+    page_id_t block_page_id = old.block_page_ids_[migrate_cursor_ / BLOCK_ARRAY_SIZE];
+    Page *page = FetchPage(block_page_id);
+    auto *block = reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(page->GetData());
+    size_t block_end = std::min(end, (migrate_cursor_ / BLOCK_ARRAY_SIZE + 1) * BLOCK_ARRAY_SIZE);
+    page->WLatch();
+    for (; migrate_cursor_ < block_end; migrate_cursor_++) {
+      slot_offset_t offset = migrate_cursor_ % BLOCK_ARRAY_SIZE;
+      if (!block->IsReadable(offset)) {
+        continue;
       }
-      this->buffer_pool_manager_->DeletePage(headerPage->GetBlockPageId(idx));
+      KeyType key = block->KeyAt(offset);
+      bool full;
+      bool moved = InsertInto(*generations->current_, key, block->ValueAt(offset), hash_fn_.GetHash(key), &full);
+      BUSTUB_ASSERT(moved || !full, "The new generation has room for every entry of the old one.");
+      // leave a tombstone so that the probe sequences of the old generation stay unbroken
+      block->Remove(offset);
+    }
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(block_page_id, true);
+  }
+
+  if (migrate_cursor_ == old.num_buckets_) {
+    // the pages go once the lookups still probing the old generation let go of it
+    generations->old_->retired_ = true;
+    auto drained = std::make_shared<Generations>();
+    drained->current_ = generations->current_;
+    std::atomic_store(&generations_, std::shared_ptr<const Generations>(drained));
+
+    size_t num_buckets = pending_num_buckets_;
+    pending_num_buckets_ = 0;
+    // a compaction asked for meanwhile is only worth it if tombstones were left in the new generation
+    if (num_buckets != 0 && (num_buckets != drained->current_->num_buckets_ || num_tombstones_ > 0)) {
+      BeginResize(num_buckets);
     }
-    table_latch_.WUnlock();
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::MigrateStep() {
+  if (!IsResizing()) {
+    return;
+  }
+  WriteLatchGuard guard(&table_latch_);
+  MigrateSlots(HASH_TABLE_MIGRATE_BATCH_SIZE);
 }
 
 /*****************************************************************************
@@ -198,14 +460,187 @@ void HASH_TABLE_TYPE::Resize(size_t initial_size) {
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 size_t HASH_TABLE_TYPE::GetSize() {
-  table_latch_.RLock();
-  Page *header = buffer_pool_manager_->FetchPage(header_page_id_);
-  auto *headerPage = reinterpret_cast<HashTableHeaderPage*>(header->GetData());
-  auto size = headerPage->GetSize();
-  table_latch_.WUnlock();
-  return size;
+  return LoadGenerations()->current_->num_buckets_;
 }
 
+/*****************************************************************************
+ * GENERATIONS
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+HASH_TABLE_TYPE::Generation::Generation(BufferPoolManager *buffer_pool_manager, size_t num_buckets)
+    : buffer_pool_manager_(buffer_pool_manager), num_buckets_(num_buckets) {
+  size_t num_blocks = (num_buckets - 1) / BLOCK_ARRAY_SIZE + 1;
+  if (num_buckets > MAX_NUM_BUCKETS) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "Too many buckets for one hash table header page");
+  }
+
+  Page *page = buffer_pool_manager_->NewPage(&header_page_id_);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate hash table header page");
+  }
+  auto *header = reinterpret_cast<HashTableHeaderPage *>(page->GetData());
+  header->SetPageId(header_page_id_);
+  header->SetSize(num_buckets);
+  header->ResetIndex();
+
+  for (size_t i = 0; i < num_blocks; i++) {
+    page_id_t block_page_id;
+    if (buffer_pool_manager_->NewPage(&block_page_id) == nullptr) {
+      buffer_pool_manager_->UnpinPage(header_page_id_, true);
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate hash table block page");
+    }
+    buffer_pool_manager_->UnpinPage(block_page_id, true);
+    header->AddBlockPageId(block_page_id);
+    block_page_ids_.push_back(block_page_id);
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id_, true);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+HASH_TABLE_TYPE::Generation::~Generation() {
+  if (!retired_) {
+    return;
+  }
+  for (page_id_t block_page_id : block_page_ids_) {
+    buffer_pool_manager_->DeletePage(block_page_id);
+  }
+  buffer_pool_manager_->DeletePage(header_page_id_);
+}
+
+/*****************************************************************************
+ * PROBING
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+Page *HASH_TABLE_TYPE::FetchPage(page_id_t page_id) {
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch hash table page");
+  }
+  return page;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename SlotVisitor>
+bool HASH_TABLE_TYPE::Probe(const Generation &generation, uint64_t hash, bool exclusive, SlotVisitor visit,
+                            bool claim_tombstone) {
+  uint8_t tag = HASH_TABLE_BLOCK_TYPE::TagOf(hash);
+  size_t num_buckets = generation.num_buckets_;
+  size_t bucket = hash % num_buckets;
+  bool ended = false;
+  // the sequence is walked one run of slots per block page, up to the end of the block or of the generation
+  for (size_t remaining = num_buckets; remaining > 0 && !ended;) {
+    size_t block_index = bucket / BLOCK_ARRAY_SIZE;
+    size_t begin = bucket % BLOCK_ARRAY_SIZE;
+    size_t end = std::min<size_t>({BLOCK_ARRAY_SIZE, num_buckets - block_index * BLOCK_ARRAY_SIZE, begin + remaining});
+    page_id_t block_page_id = generation.block_page_ids_[block_index];
+    Page *page = FetchPage(block_page_id);
+    auto *block = reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(page->GetData());
+    if (exclusive) {
+      page->WLatch();
+    }
+    // first tombstone of the run, only claimed while the page stays latched
+    size_t tombstone = BLOCK_ARRAY_SIZE;
+    for (size_t group = begin / TAG_GROUP_SIZE; group * TAG_GROUP_SIZE < end && !ended; group++) {
+      size_t base = group * TAG_GROUP_SIZE;
+      uint32_t run = RunMask(std::max(begin, base) - base, std::min(end, base + TAG_GROUP_SIZE) - base);
+      uint32_t matches = block->MatchTag(group, tag) & run;
+      uint32_t occupied = block->OccupiedMask(group);
+      uint32_t free_slots = ~occupied & run;
+      if (free_slots != 0) {
+        // the first never used slot ends the sequence, nothing after it belongs to this key
+        run &= (free_slots & (~free_slots + 1)) - 1;
+        matches &= run;
+      }
+      if (claim_tombstone && tombstone == BLOCK_ARRAY_SIZE) {
+        uint32_t tombstones = occupied & ~block->ReadableMask(group) & run;
+        if (tombstones != 0) {
+          tombstone = base + __builtin_ctz(tombstones);
+        }
+      }
+      for (; matches != 0 && !ended; matches &= matches - 1) {
+        ended = visit(block, static_cast<slot_offset_t>(base + __builtin_ctz(matches)));
+      }
+      if (free_slots != 0 && !ended) {
+        size_t slot = tombstone != BLOCK_ARRAY_SIZE ? tombstone : base + __builtin_ctz(free_slots);
+        visit(block, static_cast<slot_offset_t>(slot));
+        ended = true;
+      }
+    }
+    if (exclusive) {
+      page->WUnlatch();
+    }
+    buffer_pool_manager_->UnpinPage(block_page_id, exclusive);
+    remaining -= end - begin;
+    bucket = (block_index * BLOCK_ARRAY_SIZE + end) % num_buckets;
+  }
+  return ended;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_TYPE::InsertInto(const Generation &generation, const KeyType &key, const ValueType &value,
+                                 uint64_t hash, bool *full) {
+  uint8_t tag = HASH_TABLE_BLOCK_TYPE::TagOf(hash);
+  bool inserted = false;
+  bool reused = false;
+  auto visit = [&](HASH_TABLE_BLOCK_TYPE *block, slot_offset_t offset) {
+    if (!block->IsReadable(offset)) {
+      // the slot that ends the sequence, or a tombstone on the way to it
+      reused = block->IsOccupied(offset);
+      inserted = block->Insert(offset, key, value, tag);
+      if (reused) {
+        num_tombstones_--;
+      }
+      return true;
+    }
+    // a pair that is there already
+    return comparator_(block->KeyAt(offset), key) == 0 && block->ValueAt(offset) == value;
+  };
+  bool ended = Probe(generation, hash, true, visit, true);
+  *full = !ended;
+  if (inserted && !reused) {
+    num_occupied_++;
+  }
+  return inserted;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_TYPE::RemoveFrom(const Generation &generation, const KeyType &key, const ValueType &value,
+                                 uint64_t hash, bool count_tombstone) {
+  bool removed = false;
+  Probe(generation, hash, true, [&](HASH_TABLE_BLOCK_TYPE *block, slot_offset_t offset) {
+    if (!block->IsOccupied(offset)) {
+      return true;
+    }
+    if (comparator_(block->KeyAt(offset), key) == 0 && block->ValueAt(offset) == value) {
+      block->Remove(offset);
+      // counted while the page is latched, before an insert can claim the tombstone
+      if (count_tombstone) {
+        num_tombstones_++;
+      }
+      removed = true;
+      return true;
+    }
+    return false;
+  });
+  return removed;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_TYPE::Contains(const Generation &generation, const KeyType &key, const ValueType &value,
+                               uint64_t hash) {
+  bool found = false;
+  Probe(generation, hash, false, [&](HASH_TABLE_BLOCK_TYPE *block, slot_offset_t offset) {
+    if (!block->IsOccupied(offset)) {
+      return true;
+    }
+    MappingType pair;
+    if (block->ReadPair(offset, &pair)) {
+      found = comparator_(pair.first, key) == 0 && pair.second == value;
+    }
+    return found;
+  });
+  return found;
+}
 
 template class LinearProbeHashTable<int, int, IntComparator>;
 
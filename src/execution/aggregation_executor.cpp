@@ -1,29 +1,100 @@
-//===----------------------------------------------------------------------===//
-//
-//                         BusTub
-//
-// aggregation_executor.cpp
-//
-// Identification: src/execution/aggregation_executor.cpp
-//
-// Copyright (c) 2015-19, Carnegie Mellon University Database Group
-//
-//===----------------------------------------------------------------------===//
-#include <memory>
-#include <vector>
-
-#include "execution/executors/aggregation_executor.h"
-
-namespace bustub {
-
-AggregationExecutor::AggregationExecutor(ExecutorContext *exec_ctx, const AggregationPlanNode *plan,
-                                         std::unique_ptr<AbstractExecutor> &&child)
-    : AbstractExecutor(exec_ctx) {}
-
-const AbstractExecutor *AggregationExecutor::GetChildExecutor() const { return child_.get(); }
-
-void AggregationExecutor::Init() {}
-
-bool AggregationExecutor::Next(Tuple *tuple, RID *rid) { return false; }
-
-}  // namespace bustub
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// aggregation_executor.cpp
+//
+// Identification: src/execution/aggregation_executor.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "execution/executors/aggregation_executor.h"
+
+namespace bustub {
+
+AggregationExecutor::AggregationExecutor(ExecutorContext *exec_ctx, const AggregationPlanNode *plan,
+                                         std::unique_ptr<AbstractExecutor> &&child)
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      child_(std::move(child)),
+      aht_(plan->GetAggregates(), plan->GetAggregateTypes()),
+      aht_iterator_(aht_.Begin()) {}
+
+const AbstractExecutor *AggregationExecutor::GetChildExecutor() const { return child_.get(); }
+
+void AggregationExecutor::Init() {
+  child_->Init();
+  aht_.Clear();
+  // the group-by and aggregate expressions are evaluated a batch at a time, only the hash table is per tuple
+  const auto &group_bys = plan_->GetGroupBys();
+  const auto &aggregates = plan_->GetAggregates();
+  BatchColumns key_columns(group_bys.size());
+  BatchColumns val_columns(aggregates.size());
+  TupleBatch batch;
+  while (child_->NextBatch(&batch)) {
+    for (uint32_t i = 0; i < group_bys.size(); i++) {
+      key_columns.Evaluate(i, group_bys[i], batch);
+    }
+    for (uint32_t i = 0; i < aggregates.size(); i++) {
+      val_columns.Evaluate(i, aggregates[i], batch);
+    }
+    for (uint32_t row = 0; row < batch.GetNumRows(); row++) {
+      AggregateKey key;
+      key.group_bys_.reserve(group_bys.size());
+      for (uint32_t i = 0; i < group_bys.size(); i++) {
+        key.group_bys_.push_back(key_columns[i][row]);
+      }
+      AggregateValue val;
+      val.aggregates_.reserve(aggregates.size());
+      for (uint32_t i = 0; i < aggregates.size(); i++) {
+        val.aggregates_.push_back(val_columns[i][row]);
+      }
+      aht_.InsertCombine(key, val);
+    }
+  }
+  aht_iterator_ = aht_.Begin();
+}
+
+bool AggregationExecutor::Next(Tuple *tuple, RID *rid) {
+  std::vector<Value> values;
+  if (!NextGroup(&values)) {
+    return false;
+  }
+  *tuple = Tuple(values, GetOutputSchema());
+  return true;
+}
+
+bool AggregationExecutor::NextBatch(TupleBatch *batch) {
+  batch->Reset(GetOutputSchema());
+  std::vector<Value> values;
+  while (!batch->IsFull() && NextGroup(&values)) {
+    batch->Append(values, RID());
+  }
+  return !batch->IsEmpty();
+}
+
+bool AggregationExecutor::NextGroup(std::vector<Value> *values) {
+  while (aht_iterator_ != aht_.End()) {
+    // the entries of the hash table stay where they are while it is iterated
+    const auto &group_bys = aht_iterator_.Key().group_bys_;
+    const auto &aggregates = aht_iterator_.Val().aggregates_;
+    ++aht_iterator_;
+    if (plan_->GetHaving() != nullptr &&
+        !PassesPredicate(plan_->GetHaving()->EvaluateAggregate(group_bys, aggregates))) {
+      continue;
+    }
+    values->clear();
+    for (const auto &col : GetOutputSchema()->GetColumns()) {
+      values->push_back(col.GetExpr()->EvaluateAggregate(group_bys, aggregates));
+    }
+    return true;
+  }
+  return false;
+}
+
+}  // namespace bustub
@@ -0,0 +1,340 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compiled_predicate.cpp
+//
+// Identification: src/execution/compiled_predicate.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstring>
+#include <type_traits>
+
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/compiled_predicate.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "type/limits.h"
+
+namespace bustub {
+
+namespace {
+
+bool IsCompiledType(TypeId type) {
+  switch (type) {
+    case TypeId::BOOLEAN:
+    case TypeId::TINYINT:
+    case TypeId::SMALLINT:
+    case TypeId::INTEGER:
+    case TypeId::BIGINT:
+    case TypeId::DECIMAL:
+      return true;
+    default:
+      return false;
+  }
+}
+
+int64_t IntegerOf(const Value &value) {
+  switch (value.GetTypeId()) {
+    case TypeId::BOOLEAN:
+    case TypeId::TINYINT:
+      return value.GetAs<int8_t>();
+    case TypeId::SMALLINT:
+      return value.GetAs<int16_t>();
+    case TypeId::INTEGER:
+      return value.GetAs<int32_t>();
+    default:
+      return value.GetAs<int64_t>();
+  }
+}
+
+// BOOLEAN is only compared with BOOLEAN, the numbers with each other
+bool IsComparable(TypeId left, TypeId right) { return (left == TypeId::BOOLEAN) == (right == TypeId::BOOLEAN); }
+
+// the NULL of a column stored as T, BOOLEAN and TINYINT share theirs
+template <typename T>
+constexpr T NullOf() {
+  if constexpr (std::is_same_v<T, int8_t>) {
+    return BUSTUB_INT8_NULL;
+  } else if constexpr (std::is_same_v<T, int16_t>) {
+    return BUSTUB_INT16_NULL;
+  } else if constexpr (std::is_same_v<T, int32_t>) {
+    return BUSTUB_INT32_NULL;
+  } else if constexpr (std::is_same_v<T, int64_t>) {
+    return BUSTUB_INT64_NULL;
+  } else {
+    return BUSTUB_DECIMAL_NULL;
+  }
+}
+
+template <typename T>
+T Load(const char *data, uint32_t offset) {
+  T value;
+  memcpy(&value, data + offset, sizeof(T));
+  return value;
+}
+
+template <ComparisonType Op, typename C>
+bool Apply(C left, C right) {
+  if constexpr (Op == ComparisonType::Equal) {
+    return left == right;
+  } else if constexpr (Op == ComparisonType::NotEqual) {
+    return left != right;
+  } else if constexpr (Op == ComparisonType::LessThan) {
+    return left < right;
+  } else if constexpr (Op == ComparisonType::LessThanOrEqual) {
+    return left <= right;
+  } else if constexpr (Op == ComparisonType::GreaterThan) {
+    return left > right;
+  } else {
+    return left >= right;
+  }
+}
+
+// the comparison with its operands swapped: a < b is b > a
+ComparisonType Mirror(ComparisonType op) {
+  switch (op) {
+    case ComparisonType::LessThan:
+      return ComparisonType::GreaterThan;
+    case ComparisonType::LessThanOrEqual:
+      return ComparisonType::GreaterThanOrEqual;
+    case ComparisonType::GreaterThan:
+      return ComparisonType::LessThan;
+    case ComparisonType::GreaterThanOrEqual:
+      return ComparisonType::LessThanOrEqual;
+    default:
+      return op;
+  }
+}
+
+}  // namespace
+
+template <typename T>
+void CompiledPredicate::LoadColumn(const Instruction &instruction, const char *data, Register *registers) {
+  T value = Load<T>(data, instruction.offset_);
+  Register &dst = registers[instruction.dst_];
+  dst.null_ = value == NullOf<T>();
+  if constexpr (std::is_same_v<T, double>) {
+    dst.decimal_ = value;
+  } else {
+    dst.integer_ = value;
+  }
+}
+
+void CompiledPredicate::LoadConstant(const Instruction &instruction, const char *data, Register *registers) {
+  registers[instruction.dst_] = instruction.constant_;
+}
+
+void CompiledPredicate::ToDecimal(const Instruction &instruction, const char *data, Register *registers) {
+  const Register &src = registers[instruction.left_];
+  Register &dst = registers[instruction.dst_];
+  dst.null_ = src.null_;
+  dst.decimal_ = static_cast<double>(src.integer_);
+}
+
+template <ComparisonType Op, typename C>
+void CompiledPredicate::Compare(const Instruction &instruction, const char *data, Register *registers) {
+  const Register &left = registers[instruction.left_];
+  const Register &right = registers[instruction.right_];
+  Register &dst = registers[instruction.dst_];
+  dst.null_ = left.null_ || right.null_;
+  if constexpr (std::is_same_v<C, double>) {
+    dst.integer_ = Apply<Op>(left.decimal_, right.decimal_);
+  } else {
+    dst.integer_ = Apply<Op>(left.integer_, right.integer_);
+  }
+}
+
+template <typename T, ComparisonType Op, typename C>
+void CompiledPredicate::CompareColumnConstant(const Instruction &instruction, const char *data, Register *registers) {
+  T value = Load<T>(data, instruction.offset_);
+  Register &dst = registers[instruction.dst_];
+  dst.null_ = value == NullOf<T>();
+  if constexpr (std::is_same_v<C, double>) {
+    dst.integer_ = Apply<Op>(static_cast<double>(value), instruction.constant_.decimal_);
+  } else {
+    dst.integer_ = Apply<Op>(static_cast<int64_t>(value), instruction.constant_.integer_);
+  }
+}
+
+template <typename C>
+CompiledPredicate::Handler CompiledPredicate::CompareHandler(ComparisonType op) {
+  switch (op) {
+    case ComparisonType::Equal:
+      return &Compare<ComparisonType::Equal, C>;
+    case ComparisonType::NotEqual:
+      return &Compare<ComparisonType::NotEqual, C>;
+    case ComparisonType::LessThan:
+      return &Compare<ComparisonType::LessThan, C>;
+    case ComparisonType::LessThanOrEqual:
+      return &Compare<ComparisonType::LessThanOrEqual, C>;
+    case ComparisonType::GreaterThan:
+      return &Compare<ComparisonType::GreaterThan, C>;
+    default:
+      return &Compare<ComparisonType::GreaterThanOrEqual, C>;
+  }
+}
+
+template <typename T, typename C>
+CompiledPredicate::Handler CompiledPredicate::CompareColumnConstantHandler(ComparisonType op) {
+  switch (op) {
+    case ComparisonType::Equal:
+      return &CompareColumnConstant<T, ComparisonType::Equal, C>;
+    case ComparisonType::NotEqual:
+      return &CompareColumnConstant<T, ComparisonType::NotEqual, C>;
+    case ComparisonType::LessThan:
+      return &CompareColumnConstant<T, ComparisonType::LessThan, C>;
+    case ComparisonType::LessThanOrEqual:
+      return &CompareColumnConstant<T, ComparisonType::LessThanOrEqual, C>;
+    case ComparisonType::GreaterThan:
+      return &CompareColumnConstant<T, ComparisonType::GreaterThan, C>;
+    default:
+      return &CompareColumnConstant<T, ComparisonType::GreaterThanOrEqual, C>;
+  }
+}
+
+CompiledPredicate::Handler CompiledPredicate::LoadColumnHandler(TypeId type) {
+  switch (type) {
+    case TypeId::BOOLEAN:
+    case TypeId::TINYINT:
+      return &LoadColumn<int8_t>;
+    case TypeId::SMALLINT:
+      return &LoadColumn<int16_t>;
+    case TypeId::INTEGER:
+      return &LoadColumn<int32_t>;
+    case TypeId::BIGINT:
+      return &LoadColumn<int64_t>;
+    default:
+      return &LoadColumn<double>;
+  }
+}
+
+CompiledPredicate::Handler CompiledPredicate::ColumnConstantHandler(TypeId column_type, bool decimal,
+                                                                    ComparisonType op) {
+  switch (column_type) {
+    case TypeId::BOOLEAN:
+    case TypeId::TINYINT:
+      return decimal ? CompareColumnConstantHandler<int8_t, double>(op)
+                     : CompareColumnConstantHandler<int8_t, int64_t>(op);
+    case TypeId::SMALLINT:
+      return decimal ? CompareColumnConstantHandler<int16_t, double>(op)
+                     : CompareColumnConstantHandler<int16_t, int64_t>(op);
+    case TypeId::INTEGER:
+      return decimal ? CompareColumnConstantHandler<int32_t, double>(op)
+                     : CompareColumnConstantHandler<int32_t, int64_t>(op);
+    case TypeId::BIGINT:
+      return decimal ? CompareColumnConstantHandler<int64_t, double>(op)
+                     : CompareColumnConstantHandler<int64_t, int64_t>(op);
+    default:
+      return CompareColumnConstantHandler<double, double>(op);
+  }
+}
+
+std::unique_ptr<CompiledPredicate> CompiledPredicate::Compile(const AbstractExpression *predicate,
+                                                              const Schema *schema) {
+  std::unique_ptr<CompiledPredicate> compiled(new CompiledPredicate());
+  uint32_t dst;
+  TypeId type;
+  if (!compiled->CompileNode(predicate, schema, &dst, &type) || type != TypeId::BOOLEAN) {
+    return nullptr;
+  }
+  compiled->registers_.resize(compiled->num_registers_);
+  return compiled;
+}
+
+bool CompiledPredicate::CompileNode(const AbstractExpression *expr, const Schema *schema, uint32_t *dst,
+                                    TypeId *type) {
+  if (const auto *column = dynamic_cast<const ColumnValueExpression *>(expr); column != nullptr) {
+    if (column->GetTupleIdx() != 0 || column->GetColIdx() >= schema->GetColumnCount()) {
+      return false;
+    }
+    const Column &col = schema->GetColumn(column->GetColIdx());
+    *type = col.GetType();
+    if (!IsCompiledType(*type)) {
+      return false;
+    }
+    *dst = NewRegister();
+    program_.push_back({LoadColumnHandler(*type), *dst, 0, 0, col.GetOffset(), {}});
+    return true;
+  }
+
+  if (const auto *constant = dynamic_cast<const ConstantValueExpression *>(expr); constant != nullptr) {
+    // a constant does not look at the tuple
+    Value value = constant->Evaluate(nullptr, nullptr);
+    *type = value.GetTypeId();
+    if (!IsCompiledType(*type)) {
+      return false;
+    }
+    Instruction instruction{&LoadConstant, NewRegister(), 0, 0, 0, {}};
+    instruction.constant_.null_ = value.IsNull();
+    if (*type == TypeId::DECIMAL) {
+      instruction.constant_.decimal_ = value.IsNull() ? 0 : value.GetAs<double>();
+    } else {
+      instruction.constant_.integer_ = value.IsNull() ? 0 : IntegerOf(value);
+    }
+    *dst = instruction.dst_;
+    program_.push_back(instruction);
+    return true;
+  }
+
+  const auto *comparison = dynamic_cast<const ComparisonExpression *>(expr);
+  if (comparison == nullptr) {
+    return false;
+  }
+  *type = TypeId::BOOLEAN;
+  ComparisonType op = comparison->GetComparisonType();
+  uint32_t left;
+  uint32_t right;
+  TypeId left_type;
+  TypeId right_type;
+  size_t start = program_.size();
+  if (!CompileNode(comparison->GetChildAt(0), schema, &left, &left_type) ||
+      !CompileNode(comparison->GetChildAt(1), schema, &right, &right_type) || !IsComparable(left_type, right_type)) {
+    return false;
+  }
+  bool decimal = left_type == TypeId::DECIMAL || right_type == TypeId::DECIMAL;
+
+  // a column and a constant that is not NULL are compared by one instruction, the constant on the right
+  if (program_.size() == start + 2) {
+    Instruction &first = program_[start];
+    Instruction &second = program_[start + 1];
+    bool column_first = first.handler_ == LoadColumnHandler(left_type) && second.handler_ == &LoadConstant;
+    bool constant_first = first.handler_ == &LoadConstant && second.handler_ == LoadColumnHandler(right_type);
+    if (column_first || constant_first) {
+      uint32_t offset = column_first ? first.offset_ : second.offset_;
+      Register constant = column_first ? second.constant_ : first.constant_;
+      TypeId column_type = column_first ? left_type : right_type;
+      TypeId constant_type = column_first ? right_type : left_type;
+      if (!constant.null_) {
+        if (decimal && constant_type != TypeId::DECIMAL) {
+          constant.decimal_ = static_cast<double>(constant.integer_);
+        }
+        num_registers_ = first.dst_;
+        program_.resize(start);
+        *dst = NewRegister();
+        Handler handler = ColumnConstantHandler(column_type, decimal, column_first ? op : Mirror(op));
+        program_.push_back({handler, *dst, 0, 0, offset, constant});
+        return true;
+      }
+    }
+  }
+
+  // numbers are compared as doubles as soon as one of them is a DECIMAL
+  if (decimal && left_type != TypeId::DECIMAL) {
+    uint32_t src = left;
+    left = NewRegister();
+    program_.push_back({&ToDecimal, left, src, 0, 0, {}});
+  }
+  if (decimal && right_type != TypeId::DECIMAL) {
+    uint32_t src = right;
+    right = NewRegister();
+    program_.push_back({&ToDecimal, right, src, 0, 0, {}});
+  }
+  *dst = NewRegister();
+  program_.push_back({decimal ? CompareHandler<double>(op) : CompareHandler<int64_t>(op), *dst, left, right, 0, {}});
+  return true;
+}
+
+}  // namespace bustub
@@ -14,15 +14,24 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 #include "execution/executors/abstract_executor.h"
 #include "execution/executors/aggregation_executor.h"
 #include "execution/executors/delete_executor.h"
+#include "execution/executors/gather_executor.h"
+#include "execution/executors/grace_hash_join_executor.h"
+#include "execution/executors/hash_aggregation_executor.h"
+#include "execution/executors/hash_join_executor.h"
 #include "execution/executors/index_scan_executor.h"
 #include "execution/executors/insert_executor.h"
 #include "execution/executors/limit_executor.h"
+#include "execution/executors/merge_join_executor.h"
 #include "execution/executors/nested_index_join_executor.h"
 #include "execution/executors/nested_loop_join_executor.h"
+#include "execution/executors/repartition_executor.h"
 #include "execution/executors/seq_scan_executor.h"
+#include "execution/executors/sort_executor.h"
+#include "execution/executors/topn_executor.h"
 #include "execution/executors/update_executor.h"
 #include "storage/index/generic_key.h"
 
@@ -62,17 +71,34 @@ std::unique_ptr<AbstractExecutor> ExecutorFactory::CreateExecutor(ExecutorContex
 
     case PlanType::Limit: {
       auto limit_plan = dynamic_cast<const LimitPlanNode *>(plan);
+      // ORDER BY ... LIMIT keeps the best tuples instead of sorting all of them
+      if (limit_plan->GetChildPlan()->GetType() == PlanType::Sort) {
+        auto sort_plan = dynamic_cast<const SortPlanNode *>(limit_plan->GetChildPlan());
+        if (TopNExecutor::CanExecute(limit_plan, sort_plan)) {
+          auto child_executor = ExecutorFactory::CreateExecutor(exec_ctx, sort_plan->GetChildPlan());
+          return std::make_unique<TopNExecutor>(exec_ctx, limit_plan, sort_plan, std::move(child_executor));
+        }
+      }
       auto child_executor = ExecutorFactory::CreateExecutor(exec_ctx, limit_plan->GetChildPlan());
       return std::make_unique<LimitExecutor>(exec_ctx, limit_plan, std::move(child_executor));
     }
 
-    // Create a new aggregation executor.
+    // Create a new aggregation executor, the hash aggregation creates the executors of its child itself.
     case PlanType::Aggregation: {
       auto agg_plan = dynamic_cast<const AggregationPlanNode *>(plan);
+      if (HashAggregationExecutor::CanExecute(agg_plan)) {
+        return std::make_unique<HashAggregationExecutor>(exec_ctx, agg_plan);
+      }
       auto child_executor = ExecutorFactory::CreateExecutor(exec_ctx, agg_plan->GetChildPlan());
       return std::make_unique<AggregationExecutor>(exec_ctx, agg_plan, std::move(child_executor));
     }
 
+    case PlanType::Sort: {
+      auto sort_plan = dynamic_cast<const SortPlanNode *>(plan);
+      auto child_executor = ExecutorFactory::CreateExecutor(exec_ctx, sort_plan->GetChildPlan());
+      return std::make_unique<SortExecutor>(exec_ctx, sort_plan, std::move(child_executor));
+    }
+
     case PlanType::NestedLoopJoin: {
       auto nested_loop_join_plan = dynamic_cast<const NestedLoopJoinPlanNode *>(plan);
       auto left = ExecutorFactory::CreateExecutor(exec_ctx, nested_loop_join_plan->GetLeftPlan());
@@ -81,6 +107,34 @@ std::unique_ptr<AbstractExecutor> ExecutorFactory::CreateExecutor(ExecutorContex
                                                       std::move(right));
     }
 
+    case PlanType::HashJoin: {
+      auto hash_join_plan = dynamic_cast<const HashJoinPlanNode *>(plan);
+      auto left = ExecutorFactory::CreateExecutor(exec_ctx, hash_join_plan->GetLeftPlan());
+      auto right = ExecutorFactory::CreateExecutor(exec_ctx, hash_join_plan->GetRightPlan());
+      // with a memory budget, the join spills what does not fit to temporary pages
+      if (hash_join_plan->GetMemoryBudget() != 0) {
+        return std::make_unique<GraceHashJoinExecutor>(exec_ctx, hash_join_plan, std::move(left), std::move(right));
+      }
+      return std::make_unique<HashJoinExecutor>(exec_ctx, hash_join_plan, std::move(left), std::move(right));
+    }
+
+    case PlanType::MergeJoin: {
+      auto merge_join_plan = dynamic_cast<const MergeJoinPlanNode *>(plan);
+      auto left = ExecutorFactory::CreateExecutor(exec_ctx, merge_join_plan->GetLeftPlan());
+      auto right = ExecutorFactory::CreateExecutor(exec_ctx, merge_join_plan->GetRightPlan());
+      return std::make_unique<MergeJoinExecutor>(exec_ctx, merge_join_plan, std::move(left), std::move(right));
+    }
+
+    case PlanType::Gather: {
+      return std::make_unique<GatherExecutor>(exec_ctx, dynamic_cast<const GatherPlanNode *>(plan));
+    }
+
+    case PlanType::Repartition: {
+      auto repartition_plan = dynamic_cast<const RepartitionPlanNode *>(plan);
+      auto child_executor = ExecutorFactory::CreateExecutor(exec_ctx, repartition_plan->GetChildPlan());
+      return std::make_unique<RepartitionExecutor>(exec_ctx, repartition_plan, std::move(child_executor));
+    }
+
     case PlanType::NestedIndexJoin: {
       auto nested_index_join_plan = dynamic_cast<const NestedIndexJoinPlanNode *>(plan);
       auto left = ExecutorFactory::CreateExecutor(exec_ctx, nested_index_join_plan->GetChildPlan());
@@ -93,4 +147,20 @@ std::unique_ptr<AbstractExecutor> ExecutorFactory::CreateExecutor(ExecutorContex
   }
 }
 
+std::vector<WorkerExecutor> ExecutorFactory::CreateWorkerExecutors(ExecutorContext *exec_ctx,
+                                                                   ParallelContext *parallel_ctx,
+                                                                   const AbstractPlanNode *plan) {
+  std::vector<WorkerExecutor> workers(parallel_ctx->GetNumWorkers());
+  for (size_t worker_id = 0; worker_id < workers.size(); worker_id++) {
+    auto &worker = workers[worker_id];
+    worker.exec_ctx_ =
+        std::make_unique<ExecutorContext>(exec_ctx->GetTransaction(), exec_ctx->GetCatalog(),
+                                          exec_ctx->GetBufferPoolManager(), exec_ctx->GetTransactionManager(),
+                                          exec_ctx->GetLockManager());
+    worker.exec_ctx_->SetParallelContext(parallel_ctx, worker_id);
+    worker.executor_ = CreateExecutor(worker.exec_ctx_.get(), plan);
+  }
+  return workers;
+}
+
 }  // namespace bustub
@@ -0,0 +1,130 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// gather_executor.cpp
+//
+// Identification: src/execution/gather_executor.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "execution/executors/gather_executor.h"
+
+namespace bustub {
+
+GatherExecutor::GatherExecutor(ExecutorContext *exec_ctx, const GatherPlanNode *plan)
+    : AbstractExecutor(exec_ctx), plan_(plan) {}
+
+GatherExecutor::~GatherExecutor() { Stop(); }
+
+void GatherExecutor::Init() {
+  Stop();
+  ThreadPool *thread_pool = exec_ctx_->GetThreadPool();
+  size_t num_workers = ParallelContext::NumWorkers(thread_pool, plan_->GetChildPlan(), plan_->GetNumWorkers());
+  parallel_ctx_ = std::make_unique<ParallelContext>(num_workers, plan_->GetMorselPages());
+  workers_ = ExecutorFactory::CreateWorkerExecutors(exec_ctx_, parallel_ctx_.get(), plan_->GetChildPlan());
+  batches_.clear();
+  error_ = nullptr;
+  batch_.Reset(GetOutputSchema());
+  next_row_ = 0;
+
+  // a single worker is pulled by Next itself
+  if (num_workers == 1) {
+    workers_[0].executor_->Init();
+    return;
+  }
+  num_running_ = num_workers;
+  // the workers are queued together, a repartition below makes them wait for each other
+  std::vector<std::function<void()>> tasks;
+  for (size_t worker_id = 0; worker_id < num_workers; worker_id++) {
+    tasks.emplace_back([this, worker_id] { RunWorker(worker_id); });
+  }
+  futures_ = thread_pool->SubmitAll(std::move(tasks));
+}
+
+bool GatherExecutor::Next(Tuple *tuple, RID *rid) {
+  while (next_row_ == batch_.GetNumRows()) {
+    if (!NextBatch(&batch_)) {
+      return false;
+    }
+    next_row_ = 0;
+  }
+  *tuple = batch_.GetTuple(next_row_);
+  *rid = batch_.GetRid(next_row_);
+  next_row_++;
+  return true;
+}
+
+bool GatherExecutor::NextBatch(TupleBatch *batch) {
+  if (workers_.size() == 1) {
+    return workers_[0].executor_->NextBatch(batch);
+  }
+  return PopBatch(batch);
+}
+
+void GatherExecutor::RunWorker(size_t worker_id) {
+  WorkerExecutor &worker = workers_[worker_id];
+  try {
+    worker.executor_->Init();
+    TupleBatch batch;
+    size_t max_queued = MAX_QUEUED_BATCHES_PER_WORKER * workers_.size();
+    while (!parallel_ctx_->IsCancelled() && worker.executor_->NextBatch(&batch)) {
+      std::unique_lock latch{latch_};
+      not_full_.wait(latch, [&] { return batches_.size() < max_queued || parallel_ctx_->IsCancelled(); });
+      batches_.push_back(std::move(batch));
+      not_empty_.notify_one();
+    }
+  } catch (...) {
+    // the other workers stop as well, Next rethrows the first error
+    parallel_ctx_->Cancel();
+    std::scoped_lock latch{latch_};
+    if (error_ == nullptr) {
+      error_ = std::current_exception();
+    }
+    not_full_.notify_all();
+  }
+  parallel_ctx_->WorkerDone(worker_id);
+  std::scoped_lock latch{latch_};
+  num_running_--;
+  not_empty_.notify_all();
+}
+
+bool GatherExecutor::PopBatch(TupleBatch *batch) {
+  std::unique_lock latch{latch_};
+  not_empty_.wait(latch, [this] { return !batches_.empty() || num_running_ == 0 || error_ != nullptr; });
+  if (error_ != nullptr) {
+    std::exception_ptr error = error_;
+    latch.unlock();
+    Stop();
+    std::rethrow_exception(error);
+  }
+  if (batches_.empty()) {
+    return false;
+  }
+  *batch = std::move(batches_.front());
+  batches_.pop_front();
+  not_full_.notify_one();
+  return true;
+}
+
+void GatherExecutor::Stop() {
+  if (parallel_ctx_ != nullptr) {
+    parallel_ctx_->Cancel();
+  }
+  {
+    std::scoped_lock latch{latch_};
+    not_full_.notify_all();
+  }
+  for (auto &future : futures_) {
+    future.wait();
+  }
+  futures_.clear();
+}
+
+}  // namespace bustub
@@ -0,0 +1,231 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// grace_hash_join_executor.cpp
+//
+// Identification: src/execution/grace_hash_join_executor.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <utility>
+#include <vector>
+
+#include "execution/executors/grace_hash_join_executor.h"
+
+namespace bustub {
+
+GraceHashJoinExecutor::GraceHashJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan,
+                                             std::unique_ptr<AbstractExecutor> &&left_executor,
+                                             std::unique_ptr<AbstractExecutor> &&right_executor)
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      left_executor_(std::move(left_executor)),
+      right_executor_(std::move(right_executor)),
+      memory_budget_(plan->GetMemoryBudget()),
+      left_keys_(plan->GetLeftKeys(), JoinKeyEncoder::KeyTypes(plan)),
+      right_keys_(plan->GetRightKeys(), JoinKeyEncoder::KeyTypes(plan)) {}
+
+void GraceHashJoinExecutor::Init() {
+  left_executor_->Init();
+  right_executor_->Init();
+  partitions_.clear();
+  for (size_t i = 0; i < NUM_PARTITIONS; i++) {
+    partitions_.emplace_back(exec_ctx_->GetBufferPoolManager());
+    partitions_.back().table_ = std::make_unique<JoinHashTable>();
+  }
+  in_memory_bytes_ = 0;
+  num_spilled_ = 0;
+  probing_ = true;
+  spill_partition_ = 0;
+  build_page_ = 0;
+  probe_page_ = 0;
+  results_.Reset(GetOutputSchema());
+  next_result_ = 0;
+
+  while (left_executor_->NextBatch(&build_batch_)) {
+    left_keys_.Encode(build_batch_);
+    for (uint32_t row : left_keys_.GetRows()) {
+      AddBuildRow(&partitions_[PartitionOf(left_keys_.GetHash(row))], build_batch_, row);
+    }
+  }
+  for (auto &partition : partitions_) {
+    partition.build_file_.Close();
+  }
+}
+
+bool GraceHashJoinExecutor::Next(Tuple *tuple, RID *rid) {
+  while (next_result_ == results_.GetNumRows()) {
+    if (!JoinNextResults()) {
+      return false;
+    }
+  }
+  *tuple = results_.GetTuple(next_result_++);
+  return true;
+}
+
+bool GraceHashJoinExecutor::NextBatch(TupleBatch *batch) {
+  batch->Reset(GetOutputSchema());
+  while (!batch->IsFull() && (next_result_ < results_.GetNumRows() || JoinNextResults())) {
+    next_result_ = batch->AppendFrom(results_, next_result_);
+  }
+  return !batch->IsEmpty();
+}
+
+bool GraceHashJoinExecutor::JoinNextResults() {
+  if (probing_) {
+    if (ProbeNextBatch()) {
+      return true;
+    }
+    probing_ = false;
+    for (auto &partition : partitions_) {
+      partition.probe_file_.Close();
+    }
+  }
+  return JoinNextSpilledPage();
+}
+
+void GraceHashJoinExecutor::AddBuildRow(Partition *partition, const TupleBatch &batch, uint32_t row) {
+  if (partition->spilled_) {
+    partition->build_file_.Append(batch.GetTuple(row));
+    return;
+  }
+  partition->tuples_.push_back(batch.GetTuple(row));
+  partition->table_->Insert(left_keys_.GetKey(row), left_keys_.GetHash(row),
+                            static_cast<uint32_t>(partition->tuples_.size() - 1));
+  size_t bytes = partition->tuples_.back().GetLength() + left_keys_.GetKey(row).size() +
+                 HashJoinExecutor::BUILD_TUPLE_OVERHEAD;
+  partition->bytes_ += bytes;
+  in_memory_bytes_ += bytes;
+
+  // every spilled partition holds a page while it is written
+  while (in_memory_bytes_ + num_spilled_ * PAGE_SIZE > memory_budget_) {
+    Partition *largest = nullptr;
+    for (auto &candidate : partitions_) {
+      if (!candidate.spilled_ && (largest == nullptr || candidate.bytes_ > largest->bytes_)) {
+        largest = &candidate;
+      }
+    }
+    if (largest == nullptr || largest->bytes_ == 0) {
+      break;
+    }
+    Spill(largest);
+  }
+}
+
+void GraceHashJoinExecutor::Spill(Partition *partition) {
+  for (const auto &tuple : partition->tuples_) {
+    partition->build_file_.Append(tuple);
+  }
+  std::vector<Tuple>().swap(partition->tuples_);
+  partition->table_.reset();
+  in_memory_bytes_ -= partition->bytes_;
+  partition->bytes_ = 0;
+  partition->spilled_ = true;
+  num_spilled_++;
+}
+
+void GraceHashJoinExecutor::ProbeRow(const Partition &partition, uint32_t row) {
+  const Schema *left_schema = left_executor_->GetOutputSchema();
+  const Schema *right_schema = right_executor_->GetOutputSchema();
+  const AbstractExpression *predicate = plan_->Predicate();
+  Tuple right_tuple;
+  bool materialized = false;
+  partition.table_->ForEachMatch(right_keys_.GetKey(row), right_keys_.GetHash(row), [&](uint32_t build_tuple) {
+    if (!materialized) {
+      right_tuple = probe_batch_.GetTuple(row);
+      materialized = true;
+    }
+    const Tuple &left_tuple = partition.tuples_[build_tuple];
+    if (predicate != nullptr &&
+        !PassesPredicate(predicate->EvaluateJoin(&left_tuple, left_schema, &right_tuple, right_schema))) {
+      return;
+    }
+    std::vector<Value> values;
+    for (const auto &col : GetOutputSchema()->GetColumns()) {
+      values.push_back(col.GetExpr()->EvaluateJoin(&left_tuple, left_schema, &right_tuple, right_schema));
+    }
+    results_.Append(values, RID());
+  });
+}
+
+void GraceHashJoinExecutor::ReadPage(TmpTupleFile *file, size_t page_index, const Schema *schema,
+                                     TupleBatch *batch) {
+  file->ReadPage(page_index, &page_tuples_);
+  batch->Reset(schema);
+  for (const auto &tuple : page_tuples_) {
+    batch->Append(tuple, RID());
+  }
+}
+
+bool GraceHashJoinExecutor::ProbeNextBatch() {
+  results_.Clear();
+  next_result_ = 0;
+  if (!right_executor_->NextBatch(&probe_batch_)) {
+    return false;
+  }
+  right_keys_.Encode(probe_batch_);
+  for (uint32_t row : right_keys_.GetRows()) {
+    Partition &partition = partitions_[PartitionOf(right_keys_.GetHash(row))];
+    if (partition.spilled_) {
+      partition.probe_file_.Append(probe_batch_.GetTuple(row));
+    } else {
+      ProbeRow(partition, row);
+    }
+  }
+  return true;
+}
+
+bool GraceHashJoinExecutor::JoinNextSpilledPage() {
+  results_.Clear();
+  next_result_ = 0;
+  while (spill_partition_ < partitions_.size()) {
+    Partition &partition = partitions_[spill_partition_];
+    if (partition.spilled_ && !partition.probe_file_.IsEmpty()) {
+      // probe the loaded part of the left side with every right page, then load the next part
+      if (partition.table_ != nullptr && probe_page_ < partition.probe_file_.GetNumPages()) {
+        ReadPage(&partition.probe_file_, probe_page_++, right_executor_->GetOutputSchema(), &probe_batch_);
+        right_keys_.Encode(probe_batch_);
+        for (uint32_t row : right_keys_.GetRows()) {
+          ProbeRow(partition, row);
+        }
+        return true;
+      }
+      if (build_page_ < partition.build_file_.GetNumPages()) {
+        LoadNextChunk(&partition);
+        probe_page_ = 0;
+        continue;
+      }
+    }
+    partition.build_file_.Release();
+    partition.probe_file_.Release();
+    partition.table_.reset();
+    std::vector<Tuple>().swap(partition.tuples_);
+    spill_partition_++;
+    build_page_ = 0;
+    probe_page_ = 0;
+  }
+  return false;
+}
+
+void GraceHashJoinExecutor::LoadNextChunk(Partition *partition) {
+  partition->tuples_.clear();
+  partition->table_ = std::make_unique<JoinHashTable>();
+  partition->bytes_ = 0;
+  // at least one page, so that a budget smaller than a page still makes progress
+  do {
+    ReadPage(&partition->build_file_, build_page_++, left_executor_->GetOutputSchema(), &build_batch_);
+    left_keys_.Encode(build_batch_);
+    for (uint32_t row : left_keys_.GetRows()) {
+      partition->tuples_.push_back(build_batch_.GetTuple(row));
+      partition->table_->Insert(left_keys_.GetKey(row), left_keys_.GetHash(row),
+                                static_cast<uint32_t>(partition->tuples_.size() - 1));
+      partition->bytes_ += partition->tuples_.back().GetLength() + left_keys_.GetKey(row).size() +
+                           HashJoinExecutor::BUILD_TUPLE_OVERHEAD;
+    }
+  } while (build_page_ < partition->build_file_.GetNumPages() && partition->bytes_ < memory_budget_);
+}
+
+}  // namespace bustub
@@ -0,0 +1,545 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_aggregation_executor.cpp
+//
+// Identification: src/execution/hash_aggregation_executor.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <future>  // NOLINT
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/exception.h"
+#include "execution/executors/hash_aggregation_executor.h"
+#include "execution/executors/sort_executor.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+bool IsNumber(TypeId type) {
+  switch (type) {
+    case TypeId::TINYINT:
+    case TypeId::SMALLINT:
+    case TypeId::INTEGER:
+    case TypeId::BIGINT:
+    case TypeId::DECIMAL:
+      return true;
+    default:
+      return false;
+  }
+}
+
+int64_t IntegerOf(const Value &value) {
+  switch (value.GetTypeId()) {
+    case TypeId::TINYINT:
+      return value.GetAs<int8_t>();
+    case TypeId::SMALLINT:
+      return value.GetAs<int16_t>();
+    case TypeId::INTEGER:
+      return value.GetAs<int32_t>();
+    default:
+      return value.GetAs<int64_t>();
+  }
+}
+
+}  // namespace
+
+HashAggregationExecutor::HashAggregationExecutor(ExecutorContext *exec_ctx, const AggregationPlanNode *plan)
+    : AbstractExecutor(exec_ctx), plan_(plan) {
+  std::vector<Column> spill_columns;
+  for (const auto *group_by : plan_->GetGroupBys()) {
+    TypeId type = group_by->GetReturnType();
+    spill_columns.push_back(type == TypeId::VARCHAR ? Column("", type, uint32_t{0}) : Column("", type));
+  }
+  const auto &aggregates = plan_->GetAggregates();
+  const auto &agg_types = plan_->GetAggregateTypes();
+  for (size_t i = 0; i < aggregates.size(); i++) {
+    TypeId type = aggregates[i]->GetReturnType();
+    bool decimal = type == TypeId::DECIMAL;
+    switch (agg_types[i]) {
+      case AggregationType::CountAggregate:
+        accumulates_.push_back(Accumulate::COUNT);
+        break;
+      case AggregationType::SumAggregate:
+        accumulates_.push_back(decimal ? Accumulate::SUM_DECIMAL : Accumulate::SUM_INTEGER);
+        break;
+      case AggregationType::MinAggregate:
+        accumulates_.push_back(decimal ? Accumulate::MIN_DECIMAL : Accumulate::MIN_INTEGER);
+        break;
+      case AggregationType::MaxAggregate:
+        accumulates_.push_back(decimal ? Accumulate::MAX_DECIMAL : Accumulate::MAX_INTEGER);
+        break;
+    }
+    // integers are added up as INTEGER like Value::Add does from 0, BIGINT stays BIGINT
+    if (agg_types[i] == AggregationType::CountAggregate) {
+      result_types_.push_back(TypeId::INTEGER);
+    } else if (decimal || type == TypeId::BIGINT) {
+      result_types_.push_back(type);
+    } else {
+      result_types_.push_back(TypeId::INTEGER);
+    }
+    bool decimal_state = decimal && accumulates_.back() != Accumulate::COUNT;
+    spill_columns.emplace_back("", decimal_state ? TypeId::DECIMAL : TypeId::BIGINT);
+  }
+  spill_schema_ = std::make_unique<Schema>(spill_columns);
+}
+
+bool HashAggregationExecutor::CanExecute(const AggregationPlanNode *plan) {
+  for (const auto *group_by : plan->GetGroupBys()) {
+    switch (group_by->GetReturnType()) {
+      case TypeId::BOOLEAN:
+      case TypeId::TINYINT:
+      case TypeId::SMALLINT:
+      case TypeId::INTEGER:
+      case TypeId::BIGINT:
+      case TypeId::TIMESTAMP:
+      case TypeId::DECIMAL:
+      case TypeId::VARCHAR:
+        break;
+      default:
+        return false;
+    }
+  }
+  for (size_t i = 0; i < plan->GetAggregates().size(); i++) {
+    if (plan->GetAggregateTypes()[i] != AggregationType::CountAggregate &&
+        !IsNumber(plan->GetAggregates()[i]->GetReturnType())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void HashAggregationExecutor::Init() {
+  if (exec_ctx_->GetParallelContext() != nullptr) {
+    // below a gather, the child is the part of the gather's plan of this worker and is read on this thread
+    parallel_ctx_.reset();
+    executors_.clear();
+    executors_.emplace_back();
+    executors_[0].executor_ = ExecutorFactory::CreateExecutor(exec_ctx_, plan_->GetChildPlan());
+  } else {
+    size_t num_workers =
+        ParallelContext::NumWorkers(exec_ctx_->GetThreadPool(), plan_->GetChildPlan(), plan_->GetNumWorkers());
+    parallel_ctx_ = std::make_unique<ParallelContext>(num_workers, TableMorselQueue::DEFAULT_MORSEL_PAGES);
+    executors_ = ExecutorFactory::CreateWorkerExecutors(exec_ctx_, parallel_ctx_.get(), plan_->GetChildPlan());
+  }
+  BufferPoolManager *bpm = exec_ctx_->GetBufferPoolManager();
+  workers_ = std::vector<Worker>(executors_.size());
+  for (auto &worker : workers_) {
+    for (size_t p = 0; p < NUM_PARTITIONS; p++) {
+      worker.partitions_.push_back(std::make_unique<GroupTable>(bpm));
+    }
+  }
+  size_t memory_budget = plan_->GetMemoryBudget();
+  worker_budget_ = memory_budget == 0 ? 0 : std::max<size_t>(memory_budget / workers_.size(), 1);
+  partition_.reset();
+  next_partition_ = 0;
+  next_group_ = 0;
+
+  // the workers have to run at the same time, since a repartition below makes them wait for each other
+  RunTasks(workers_.size(), [this](size_t worker_id) { RunWorker(worker_id); });
+  num_spills_ = 0;
+  for (const auto &worker : workers_) {
+    num_spills_ += worker.num_spills_;
+  }
+}
+
+bool HashAggregationExecutor::Next(Tuple *tuple, RID *rid) {
+  std::vector<Value> values;
+  if (!NextGroup(&values)) {
+    return false;
+  }
+  *tuple = Tuple(values, GetOutputSchema());
+  return true;
+}
+
+bool HashAggregationExecutor::NextBatch(TupleBatch *batch) {
+  batch->Reset(GetOutputSchema());
+  std::vector<Value> values;
+  while (!batch->IsFull() && NextGroup(&values)) {
+    batch->Append(values, RID());
+  }
+  return !batch->IsEmpty();
+}
+
+bool HashAggregationExecutor::NextGroup(std::vector<Value> *values) {
+  size_t num_aggregates = accumulates_.size();
+  std::vector<Value> aggregates(num_aggregates);
+  // a partition is merged when Next gets to it and freed before the next one, so only one is held merged at a time
+  for (; next_partition_ < NUM_PARTITIONS; next_partition_++, next_group_ = 0) {
+    if (partition_ == nullptr) {
+      partition_ = MergePartition(next_partition_);
+    }
+    GroupTable *table = partition_.get();
+    while (next_group_ < table->group_bys_.size()) {
+      uint32_t group = next_group_++;
+      const auto &group_bys = table->group_bys_[group];
+      for (size_t i = 0; i < num_aggregates; i++) {
+        aggregates[i] = ResultOf(i, table->accumulators_[group * num_aggregates + i]);
+      }
+      if (plan_->GetHaving() != nullptr &&
+          !PassesPredicate(plan_->GetHaving()->EvaluateAggregate(group_bys, aggregates))) {
+        continue;
+      }
+      values->clear();
+      for (const auto &col : GetOutputSchema()->GetColumns()) {
+        values->push_back(col.GetExpr()->EvaluateAggregate(group_bys, aggregates));
+      }
+      return true;
+    }
+    partition_.reset();
+  }
+  workers_.clear();
+  return false;
+}
+
+void HashAggregationExecutor::RunTasks(size_t num_tasks, const std::function<void(size_t)> &task) {
+  ThreadPool *thread_pool = exec_ctx_->GetThreadPool();
+  if (thread_pool == nullptr || num_tasks == 1) {
+    for (size_t i = 0; i < num_tasks; i++) {
+      task(i);
+    }
+    return;
+  }
+  std::vector<std::function<void()>> tasks;
+  for (size_t i = 0; i < num_tasks; i++) {
+    tasks.emplace_back([&task, i] { task(i); });
+  }
+  std::vector<std::future<void>> futures = thread_pool->SubmitAll(std::move(tasks));
+  // every task finishes before the first error is rethrown, they use this executor
+  std::exception_ptr error;
+  for (auto &future : futures) {
+    try {
+      future.get();
+    } catch (...) {
+      if (error == nullptr) {
+        error = std::current_exception();
+      }
+    }
+  }
+  if (error != nullptr) {
+    std::rethrow_exception(error);
+  }
+}
+
+void HashAggregationExecutor::RunWorker(size_t worker_id) {
+  Worker &worker = workers_[worker_id];
+  AbstractExecutor *executor = executors_[worker_id].executor_.get();
+  if (parallel_ctx_ == nullptr) {
+    // the gather above stops this worker
+    executor->Init();
+    while (executor->NextBatch(&worker.batch_)) {
+      AddBatch(&worker);
+    }
+    return;
+  }
+  try {
+    executor->Init();
+    while (!parallel_ctx_->IsCancelled() && executor->NextBatch(&worker.batch_)) {
+      AddBatch(&worker);
+    }
+  } catch (...) {
+    // the other workers stop as well, Init rethrows the first error
+    parallel_ctx_->Cancel();
+    parallel_ctx_->WorkerDone(worker_id);
+    throw;
+  }
+  parallel_ctx_->WorkerDone(worker_id);
+}
+
+void HashAggregationExecutor::AddBatch(Worker *worker) {
+  const auto &group_bys = plan_->GetGroupBys();
+  const auto &aggregates = plan_->GetAggregates();
+  const TupleBatch &batch = worker->batch_;
+  worker->key_columns_.Resize(group_bys.size());
+  worker->val_columns_.Resize(aggregates.size());
+  for (size_t i = 0; i < group_bys.size(); i++) {
+    worker->key_columns_.Evaluate(i, group_bys[i], batch);
+  }
+  for (size_t i = 0; i < aggregates.size(); i++) {
+    worker->val_columns_.Evaluate(i, aggregates[i], batch);
+  }
+
+  // find the group of every row, then fold the rows into their groups an aggregate at a time
+  uint32_t num_rows = batch.GetNumRows();
+  worker->row_tables_.resize(num_rows);
+  worker->row_groups_.resize(num_rows);
+  for (uint32_t row = 0; row < num_rows; row++) {
+    worker->key_.clear();
+    for (size_t i = 0; i < group_bys.size(); i++) {
+      SortExecutor::EncodeSortKey(worker->key_columns_[i][row], OrderByType::ASC, &worker->key_);
+    }
+    uint64_t hash = FlatHashTable<uint32_t>::Hash(worker->key_);
+    GroupTable *table = worker->partitions_[PartitionOf(hash)].get();
+    worker->row_tables_[row] = table;
+    worker->row_groups_[row] = FindOrAddGroup(
+        table, worker->key_, hash,
+        [&](std::vector<Value> *values) {
+          for (size_t i = 0; i < group_bys.size(); i++) {
+            values->push_back(worker->key_columns_[i][row]);
+          }
+        },
+        &worker->bytes_);
+  }
+  for (size_t i = 0; i < aggregates.size(); i++) {
+    Fold(i, worker->val_columns_[i], worker->row_tables_, worker->row_groups_);
+  }
+
+  // spilling only between batches keeps the groups of the batch in place while it is folded
+  while (worker_budget_ != 0 && worker->bytes_ > worker_budget_) {
+    auto largest = std::max_element(worker->partitions_.begin(), worker->partitions_.end(),
+                                    [](const auto &a, const auto &b) { return a->bytes_ < b->bytes_; });
+    worker->bytes_ -= (*largest)->bytes_;
+    Spill(largest->get());
+    worker->num_spills_++;
+  }
+}
+
+uint32_t HashAggregationExecutor::FindOrAddGroup(GroupTable *table, std::string_view key, uint64_t hash,
+                                                 const std::function<void(std::vector<Value> *)> &group_bys,
+                                                 size_t *bytes) {
+  auto new_group = static_cast<uint32_t>(table->group_bys_.size());
+  auto [group, added] = table->index_.FindOrInsert(key, hash, [new_group] { return new_group; });
+  if (added) {
+    table->group_bys_.emplace_back();
+    group_bys(&table->group_bys_.back());
+    for (auto accumulate : accumulates_) {
+      Accumulator accumulator{};
+      switch (accumulate) {
+        case Accumulate::MIN_INTEGER:
+          accumulator.integer_ = BUSTUB_INT64_MAX;
+          break;
+        case Accumulate::MAX_INTEGER:
+          accumulator.integer_ = BUSTUB_INT64_MIN;
+          break;
+        case Accumulate::MIN_DECIMAL:
+          accumulator.decimal_ = BUSTUB_DECIMAL_MAX;
+          break;
+        case Accumulate::MAX_DECIMAL:
+          accumulator.decimal_ = BUSTUB_DECIMAL_MIN;
+          break;
+        case Accumulate::SUM_DECIMAL:
+          accumulator.decimal_ = 0;
+          break;
+        default:
+          accumulator.integer_ = 0;
+          break;
+      }
+      table->accumulators_.push_back(accumulator);
+    }
+    // the key bytes stand in for the characters of VARCHAR group-by values as well
+    size_t group_bytes = key.size() + table->group_bys_.back().size() * sizeof(Value) +
+                         accumulates_.size() * sizeof(Accumulator) + GROUP_OVERHEAD;
+    table->bytes_ += group_bytes;
+    *bytes += group_bytes;
+  }
+  return *group;
+}
+
+void HashAggregationExecutor::Fold(size_t i, const std::vector<Value> &column, const std::vector<GroupTable *> &tables,
+                                   const std::vector<uint32_t> &groups) const {
+  size_t num_aggregates = accumulates_.size();
+  auto accumulator = [&](size_t row) -> Accumulator & {
+    return tables[row]->accumulators_[groups[row] * num_aggregates + i];
+  };
+  switch (accumulates_[i]) {
+    case Accumulate::COUNT:
+      for (size_t row = 0; row < column.size(); row++) {
+        accumulator(row).integer_++;
+      }
+      break;
+    case Accumulate::SUM_INTEGER:
+      for (size_t row = 0; row < column.size(); row++) {
+        Accumulator &acc = accumulator(row);
+        if (column[row].IsNull()) {
+          acc.null_ = true;
+        } else if (__builtin_add_overflow(acc.integer_, IntegerOf(column[row]), &acc.integer_)) {
+          throw Exception(ExceptionType::OUT_OF_RANGE, "SUM overflows BIGINT");
+        }
+      }
+      break;
+    case Accumulate::SUM_DECIMAL:
+      for (size_t row = 0; row < column.size(); row++) {
+        Accumulator &acc = accumulator(row);
+        acc.null_ |= column[row].IsNull();
+        acc.decimal_ += column[row].IsNull() ? 0 : column[row].GetAs<double>();
+      }
+      break;
+    case Accumulate::MIN_INTEGER:
+      for (size_t row = 0; row < column.size(); row++) {
+        Accumulator &acc = accumulator(row);
+        acc.null_ |= column[row].IsNull();
+        acc.integer_ = column[row].IsNull() ? acc.integer_ : std::min(acc.integer_, IntegerOf(column[row]));
+      }
+      break;
+    case Accumulate::MIN_DECIMAL:
+      for (size_t row = 0; row < column.size(); row++) {
+        Accumulator &acc = accumulator(row);
+        acc.null_ |= column[row].IsNull();
+        acc.decimal_ = column[row].IsNull() ? acc.decimal_ : std::min(acc.decimal_, column[row].GetAs<double>());
+      }
+      break;
+    case Accumulate::MAX_INTEGER:
+      for (size_t row = 0; row < column.size(); row++) {
+        Accumulator &acc = accumulator(row);
+        acc.null_ |= column[row].IsNull();
+        acc.integer_ = column[row].IsNull() ? acc.integer_ : std::max(acc.integer_, IntegerOf(column[row]));
+      }
+      break;
+    case Accumulate::MAX_DECIMAL:
+      for (size_t row = 0; row < column.size(); row++) {
+        Accumulator &acc = accumulator(row);
+        acc.null_ |= column[row].IsNull();
+        acc.decimal_ = column[row].IsNull() ? acc.decimal_ : std::max(acc.decimal_, column[row].GetAs<double>());
+      }
+      break;
+  }
+}
+
+void HashAggregationExecutor::Combine(size_t i, Accumulator *into, const Accumulator &from) const {
+  into->null_ |= from.null_;
+  switch (accumulates_[i]) {
+    case Accumulate::COUNT:
+      into->integer_ += from.integer_;
+      break;
+    case Accumulate::SUM_INTEGER:
+      if (__builtin_add_overflow(into->integer_, from.integer_, &into->integer_)) {
+        throw Exception(ExceptionType::OUT_OF_RANGE, "SUM overflows BIGINT");
+      }
+      break;
+    case Accumulate::SUM_DECIMAL:
+      into->decimal_ += from.decimal_;
+      break;
+    case Accumulate::MIN_INTEGER:
+      into->integer_ = std::min(into->integer_, from.integer_);
+      break;
+    case Accumulate::MIN_DECIMAL:
+      into->decimal_ = std::min(into->decimal_, from.decimal_);
+      break;
+    case Accumulate::MAX_INTEGER:
+      into->integer_ = std::max(into->integer_, from.integer_);
+      break;
+    case Accumulate::MAX_DECIMAL:
+      into->decimal_ = std::max(into->decimal_, from.decimal_);
+      break;
+  }
+}
+
+void HashAggregationExecutor::Spill(GroupTable *table) {
+  size_t num_aggregates = accumulates_.size();
+  std::vector<Value> values;
+  for (uint32_t group = 0; group < table->group_bys_.size(); group++) {
+    values = table->group_bys_[group];
+    for (size_t i = 0; i < num_aggregates; i++) {
+      const Accumulator &accumulator = table->accumulators_[group * num_aggregates + i];
+      TypeId type = spill_schema_->GetColumn(values.size()).GetType();
+      if (accumulator.null_) {
+        values.push_back(ValueFactory::GetNullValueByType(type));
+      } else if (type == TypeId::DECIMAL) {
+        values.push_back(ValueFactory::GetDecimalValue(accumulator.decimal_));
+      } else {
+        values.push_back(ValueFactory::GetBigIntValue(accumulator.integer_));
+      }
+    }
+    table->spill_file_.Append(Tuple(values, spill_schema_.get()));
+  }
+  // a single page of the file stays pinned while it is written
+  table->spill_file_.Close();
+  table->index_.Clear();
+  std::vector<std::vector<Value>>().swap(table->group_bys_);
+  std::vector<Accumulator>().swap(table->accumulators_);
+  table->bytes_ = 0;
+}
+
+std::unique_ptr<HashAggregationExecutor::GroupTable> HashAggregationExecutor::MergePartition(size_t partition) {
+  std::unique_ptr<GroupTable> merged = std::move(workers_[0].partitions_[partition]);
+  MergeSpillFile(merged.get(), &merged->spill_file_);
+  for (size_t worker_id = 1; worker_id < workers_.size(); worker_id++) {
+    GroupTable *table = workers_[worker_id].partitions_[partition].get();
+    MergeTable(merged.get(), table);
+    MergeSpillFile(merged.get(), &table->spill_file_);
+    workers_[worker_id].partitions_[partition].reset();
+  }
+  return merged;
+}
+
+void HashAggregationExecutor::MergeTable(GroupTable *into, GroupTable *from) {
+  size_t num_aggregates = accumulates_.size();
+  size_t bytes = 0;
+  for (const auto &entry : from->index_) {
+    uint32_t from_group = entry.value_;
+    uint32_t group = FindOrAddGroup(
+        into, entry.Key(), entry.hash_,
+        [&](std::vector<Value> *values) { *values = std::move(from->group_bys_[from_group]); }, &bytes);
+    for (size_t i = 0; i < num_aggregates; i++) {
+      Combine(i, &into->accumulators_[group * num_aggregates + i],
+              from->accumulators_[from_group * num_aggregates + i]);
+    }
+  }
+}
+
+void HashAggregationExecutor::MergeSpillFile(GroupTable *into, TmpTupleFile *file) {
+  size_t num_group_bys = plan_->GetGroupBys().size();
+  size_t num_aggregates = accumulates_.size();
+  std::vector<Tuple> tuples;
+  std::string key;
+  size_t bytes = 0;
+  for (size_t page = 0; page < file->GetNumPages(); page++) {
+    file->ReadPage(page, &tuples);
+    for (const auto &tuple : tuples) {
+      std::vector<Value> values;
+      key.clear();
+      for (uint32_t i = 0; i < num_group_bys; i++) {
+        values.push_back(tuple.GetValue(spill_schema_.get(), i));
+        SortExecutor::EncodeSortKey(values.back(), OrderByType::ASC, &key);
+      }
+      uint32_t group = FindOrAddGroup(
+          into, key, FlatHashTable<uint32_t>::Hash(key), [&](std::vector<Value> *group_bys) { *group_bys = values; },
+          &bytes);
+      for (size_t i = 0; i < num_aggregates; i++) {
+        Value value = tuple.GetValue(spill_schema_.get(), num_group_bys + i);
+        Accumulator accumulator{};
+        accumulator.null_ = value.IsNull();
+        if (value.IsNull()) {
+          accumulator.integer_ = 0;
+        } else if (value.GetTypeId() == TypeId::DECIMAL) {
+          accumulator.decimal_ = value.GetAs<double>();
+        } else {
+          accumulator.integer_ = value.GetAs<int64_t>();
+        }
+        Combine(i, &into->accumulators_[group * num_aggregates + i], accumulator);
+      }
+    }
+  }
+  file->Release();
+}
+
+Value HashAggregationExecutor::ResultOf(size_t i, const Accumulator &accumulator) const {
+  TypeId type = result_types_[i];
+  if (accumulator.null_) {
+    return ValueFactory::GetNullValueByType(type);
+  }
+  switch (type) {
+    case TypeId::DECIMAL:
+      return ValueFactory::GetDecimalValue(accumulator.decimal_);
+    case TypeId::BIGINT:
+      return ValueFactory::GetBigIntValue(accumulator.integer_);
+    default:
+      if (accumulator.integer_ < BUSTUB_INT32_MIN || accumulator.integer_ > BUSTUB_INT32_MAX) {
+        throw Exception(ExceptionType::OUT_OF_RANGE, "aggregate is out of range for INTEGER");
+      }
+      return ValueFactory::GetIntegerValue(static_cast<int32_t>(accumulator.integer_));
+  }
+}
+
+}  // namespace bustub
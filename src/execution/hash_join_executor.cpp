@@ -0,0 +1,289 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_join_executor.cpp
+//
+// Identification: src/execution/hash_join_executor.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <unistd.h>
+
+#include <utility>
+#include <vector>
+
+#include "execution/executors/hash_join_executor.h"
+
+namespace bustub {
+
+namespace {
+
+bool IsIntegral(TypeId type_id) {
+  return type_id == TypeId::TINYINT || type_id == TypeId::SMALLINT || type_id == TypeId::INTEGER ||
+         type_id == TypeId::BIGINT;
+}
+
+}  // namespace
+
+TypeId JoinKeyEncoder::KeyType(TypeId left, TypeId right) {
+  // integers of any width compare as bigints, and as decimals against decimals
+  if (IsIntegral(left) && IsIntegral(right)) {
+    return TypeId::BIGINT;
+  }
+  if ((IsIntegral(left) || left == TypeId::DECIMAL) && (IsIntegral(right) || right == TypeId::DECIMAL)) {
+    return TypeId::DECIMAL;
+  }
+  return left;
+}
+
+std::vector<TypeId> JoinKeyEncoder::KeyTypes(const HashJoinPlanNode *plan) {
+  std::vector<TypeId> key_types;
+  for (size_t i = 0; i < plan->GetLeftKeys().size(); i++) {
+    key_types.push_back(KeyType(plan->GetLeftKeys()[i]->GetReturnType(), plan->GetRightKeys()[i]->GetReturnType()));
+  }
+  return key_types;
+}
+
+bool JoinKeyEncoder::EncodeKey(const BatchColumns &columns, uint32_t row, const std::vector<TypeId> &key_types,
+                               std::string *key) {
+  key->clear();
+  char buffer[sizeof(uint64_t)];
+  for (size_t i = 0; i < columns.GetNumColumns(); i++) {
+    const Value *value = &columns[i][row];
+    if (value->IsNull()) {
+      return false;
+    }
+    Value cast;
+    if (value->GetTypeId() != key_types[i]) {
+      cast = value->CastAs(key_types[i]);
+      value = &cast;
+    }
+    if (key_types[i] == TypeId::VARCHAR) {
+      // the length first, so that ("ab", "c") and ("a", "bc") differ
+      uint32_t length = value->GetLength();
+      key->append(reinterpret_cast<const char *>(&length), sizeof(length));
+      key->append(value->GetData(), length);
+    } else {
+      value->SerializeTo(buffer);
+      key->append(buffer, Type::GetTypeSize(key_types[i]));
+    }
+  }
+  return true;
+}
+
+void JoinKeyEncoder::Encode(const TupleBatch &batch) {
+  key_columns_.Resize(key_exprs_.size());
+  for (size_t i = 0; i < key_exprs_.size(); i++) {
+    key_columns_.Evaluate(i, key_exprs_[i], batch);
+  }
+  keys_.clear();
+  key_offsets_.assign(1, 0);
+  hashes_.clear();
+  rows_.clear();
+  std::string key;
+  for (uint32_t row = 0; row < batch.GetNumRows(); row++) {
+    // a NULL key joins nothing, the row gets an empty key and is skipped
+    bool has_key = EncodeKey(key_columns_, row, key_types_, &key);
+    if (has_key) {
+      keys_ += key;
+      rows_.push_back(row);
+    }
+    key_offsets_.push_back(keys_.size());
+    hashes_.push_back(has_key ? Hash(key) : 0);
+  }
+}
+
+HashJoinExecutor::HashJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan,
+                                   std::unique_ptr<AbstractExecutor> &&left_executor,
+                                   std::unique_ptr<AbstractExecutor> &&right_executor, size_t cache_size)
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      left_executor_(std::move(left_executor)),
+      right_executor_(std::move(right_executor)),
+      cache_size_(cache_size),
+      left_keys_(plan->GetLeftKeys(), JoinKeyEncoder::KeyTypes(plan)),
+      right_keys_(plan->GetRightKeys(), JoinKeyEncoder::KeyTypes(plan)) {}
+
+size_t HashJoinExecutor::CacheSize() {
+  static const size_t cache_size = [] {
+    long size = sysconf(_SC_LEVEL2_CACHE_SIZE);  // NOLINT
+    return size > 0 ? static_cast<size_t>(size) : DEFAULT_CACHE_SIZE;
+  }();
+  return cache_size;
+}
+
+size_t HashJoinExecutor::PartitionBits(size_t build_bytes, size_t cache_size) {
+  size_t bits = 0;
+  while (bits < MAX_PARTITION_BITS && (build_bytes >> bits) > cache_size) {
+    bits++;
+  }
+  return bits;
+}
+
+void HashJoinExecutor::Init() {
+  left_executor_->Init();
+  right_executor_->Init();
+  results_.Reset(GetOutputSchema());
+  next_result_ = 0;
+
+  // read the left side; its tuples and keys are staged in the order they are read
+  std::vector<char> build_data;
+  std::vector<size_t> build_offsets{0};
+  std::string build_keys;
+  std::vector<size_t> build_key_offsets{0};
+  std::vector<uint64_t> build_hashes;
+  size_t build_bytes = 0;
+  TupleBatch batch;
+  while (left_executor_->NextBatch(&batch)) {
+    left_keys_.Encode(batch);
+    for (uint32_t row : left_keys_.GetRows()) {
+      Tuple tuple = batch.GetTuple(row);
+      build_data.insert(build_data.end(), tuple.GetData(), tuple.GetData() + tuple.GetLength());
+      build_offsets.push_back(build_data.size());
+      build_keys.append(left_keys_.GetKey(row));
+      build_key_offsets.push_back(build_keys.size());
+      build_hashes.push_back(left_keys_.GetHash(row));
+      build_bytes += tuple.GetLength() + left_keys_.GetKey(row).size() + BUILD_TUPLE_OVERHEAD;
+    }
+  }
+
+  // one hash table per partition, small enough to stay in the cache while it is probed
+  partitions_.clear();
+  partitions_.resize(size_t{1} << PartitionBits(build_bytes, cache_size_));
+  // a histogram of the partitions, its prefix sums are where each partition starts in the order
+  std::vector<size_t> starts(partitions_.size() + 1, 0);
+  std::vector<size_t> partition_bytes(partitions_.size(), 0);
+  for (size_t i = 0; i < build_hashes.size(); i++) {
+    size_t p = PartitionOf(build_hashes[i]);
+    starts[p + 1]++;
+    partition_bytes[p] += build_offsets[i + 1] - build_offsets[i];
+  }
+  for (size_t p = 0; p < partitions_.size(); p++) {
+    partitions_[p].data_.reserve(partition_bytes[p]);
+    partitions_[p].offsets_.reserve(starts[p + 1] + 1);
+    partitions_[p].offsets_.push_back(0);
+    partitions_[p].table_ = std::make_unique<JoinHashTable>(starts[p + 1]);
+    starts[p + 1] += starts[p];
+  }
+  std::vector<uint32_t> order(build_hashes.size());
+  for (uint32_t i = 0; i < order.size(); i++) {
+    order[starts[PartitionOf(build_hashes[i])]++] = i;
+  }
+  // copy partition by partition, the tuples of a partition end up back to back and so do its keys in its arena
+  for (uint32_t i : order) {
+    Partition &partition = partitions_[PartitionOf(build_hashes[i])];
+    partition.data_.insert(partition.data_.end(), build_data.begin() + build_offsets[i],
+                           build_data.begin() + build_offsets[i + 1]);
+    partition.offsets_.push_back(partition.data_.size());
+    std::string_view key(build_keys.data() + build_key_offsets[i], build_key_offsets[i + 1] - build_key_offsets[i]);
+    partition.table_->Insert(key, build_hashes[i], static_cast<uint32_t>(partition.offsets_.size() - 2));
+  }
+
+  probe_buffers_.assign(partitions_.size(), ProbeBuffer());
+  probe_partition_ = partitions_.size();
+  probe_index_ = 0;
+  right_done_ = false;
+}
+
+bool HashJoinExecutor::Next(Tuple *tuple, RID *rid) {
+  while (next_result_ == results_.GetNumRows()) {
+    if (!JoinNextResults()) {
+      return false;
+    }
+  }
+  *tuple = results_.GetTuple(next_result_++);
+  return true;
+}
+
+bool HashJoinExecutor::NextBatch(TupleBatch *batch) {
+  batch->Reset(GetOutputSchema());
+  while (!batch->IsFull() && (next_result_ < results_.GetNumRows() || JoinNextResults())) {
+    next_result_ = batch->AppendFrom(results_, next_result_);
+  }
+  return !batch->IsEmpty();
+}
+
+bool HashJoinExecutor::FillProbeBuffers() {
+  for (auto &buffer : probe_buffers_) {
+    buffer.rows_.clear();
+    buffer.keys_.clear();
+  }
+  // a single partition stays in the cache anyway, a batch at a time is enough
+  size_t max_batches = partitions_.size() == 1 ? 1 : PROBE_BUFFER_BATCHES;
+  size_t num_batches = 0;
+  while (!right_done_ && num_batches < max_batches) {
+    if (num_batches == probe_batches_.size()) {
+      probe_batches_.emplace_back();
+    }
+    TupleBatch &batch = probe_batches_[num_batches];
+    if (!right_executor_->NextBatch(&batch)) {
+      right_done_ = true;
+      break;
+    }
+    right_keys_.Encode(batch);
+    for (uint32_t row : right_keys_.GetRows()) {
+      uint64_t hash = right_keys_.GetHash(row);
+      std::string_view key = right_keys_.GetKey(row);
+      ProbeBuffer &buffer = probe_buffers_[PartitionOf(hash)];
+      auto key_size = static_cast<uint32_t>(key.size());
+      buffer.rows_.push_back(ProbeRow{static_cast<uint32_t>(num_batches), row, hash, buffer.keys_.size(), key_size});
+      buffer.keys_.append(key);
+    }
+    num_batches++;
+  }
+  return num_batches > 0;
+}
+
+void HashJoinExecutor::Probe(size_t p, const ProbeRow &probe_row) {
+  const Schema *left_schema = left_executor_->GetOutputSchema();
+  const Schema *right_schema = right_executor_->GetOutputSchema();
+  const AbstractExpression *predicate = plan_->Predicate();
+  Partition &partition = partitions_[p];
+  std::string_view key(probe_buffers_[p].keys_.data() + probe_row.key_offset_, probe_row.key_size_);
+  Tuple right_tuple;
+  bool materialized = false;
+  partition.table_->ForEachMatch(key, probe_row.hash_, [&](uint32_t build_tuple) {
+    if (!materialized) {
+      right_tuple = probe_batches_[probe_row.batch_].GetTuple(probe_row.row_);
+      materialized = true;
+    }
+    size_t offset = partition.offsets_[build_tuple];
+    auto size = static_cast<uint32_t>(partition.offsets_[build_tuple + 1] - offset);
+    Tuple left_tuple(partition.data_.data() + offset, size);
+    if (predicate != nullptr &&
+        !PassesPredicate(predicate->EvaluateJoin(&left_tuple, left_schema, &right_tuple, right_schema))) {
+      return;
+    }
+    std::vector<Value> values;
+    for (const auto &col : GetOutputSchema()->GetColumns()) {
+      values.push_back(col.GetExpr()->EvaluateJoin(&left_tuple, left_schema, &right_tuple, right_schema));
+    }
+    results_.Append(values, RID());
+  });
+}
+
+bool HashJoinExecutor::JoinNextResults() {
+  results_.Clear();
+  next_result_ = 0;
+  // the buffers probe their partitions one after the other, so that only one hash table is in the cache at a time
+  while (!results_.IsFull()) {
+    if (probe_partition_ == partitions_.size()) {
+      if (!FillProbeBuffers()) {
+        return !results_.IsEmpty();
+      }
+      probe_partition_ = 0;
+      probe_index_ = 0;
+    } else if (probe_index_ == probe_buffers_[probe_partition_].rows_.size()) {
+      probe_partition_++;
+      probe_index_ = 0;
+    } else {
+      Probe(probe_partition_, probe_buffers_[probe_partition_].rows_[probe_index_++]);
+    }
+  }
+  return true;
+}
+
+}  // namespace bustub
@@ -9,14 +9,216 @@
 // Copyright (c) 2015-19, Carnegie Mellon University Database Group
 //
 //===----------------------------------------------------------------------===//
+#include <algorithm>
+
 #include "execution/executors/index_scan_executor.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "type/value_factory.h"
 
 namespace bustub {
+
+namespace {
+// add the table columns read by expr to columns
+void CollectColumns(const AbstractExpression *expr, std::vector<uint32_t> *columns) {
+  if (expr == nullptr) {
+    return;
+  }
+  if (const auto *column = dynamic_cast<const ColumnValueExpression *>(expr)) {
+    columns->push_back(column->GetColIdx());
+  }
+  for (const auto *child : expr->GetChildren()) {
+    CollectColumns(child, columns);
+  }
+}
+}  // namespace
+
 IndexScanExecutor::IndexScanExecutor(ExecutorContext *exec_ctx, const IndexScanPlanNode *plan)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx), plan_(plan) {}
+
+void IndexScanExecutor::Init() {
+  Catalog *catalog = exec_ctx_->GetCatalog();
+  index_info_ = catalog->GetIndex(plan_->GetIndexOid());
+  table_info_ = catalog->GetTable(index_info_->table_name_);
+  Index *index = index_info_->index_.get();
+
+  // the scan is index-only if the index stores every column the plan reads
+  std::vector<uint32_t> columns;
+  for (const auto &column : GetOutputSchema()->GetColumns()) {
+    CollectColumns(column.GetExpr(), &columns);
+  }
+  CollectColumns(plan_->GetPredicate(), &columns);
+  covering_ = index->Covers(columns);
+
+  const auto &entry_attrs = index->GetEntryAttrs();
+  entry_columns_.assign(table_info_->schema_.GetColumnCount(), -1);
+  for (size_t i = 0; i < entry_attrs.size(); i++) {
+    entry_columns_[entry_attrs[i]] = static_cast<int32_t>(i);
+  }
+  SetKeyRange();
+
+  switch (index_info_->key_size_) {
+    case 4:
+      OpenIterator<4>();
+      break;
+    case 8:
+      OpenIterator<8>();
+      break;
+    case 16:
+      OpenIterator<16>();
+      break;
+    case 32:
+      OpenIterator<32>();
+      break;
+    case 64:
+      OpenIterator<64>();
+      break;
+    default:
+      throw Exception(ExceptionType::NOT_IMPLEMENTED, "unsupported index key size");
+  }
+}
+
+template <size_t KeySize>
+void IndexScanExecutor::OpenIterator() {
+  using TreeIndex = BPlusTreeIndex<GenericKey<KeySize>, RID, GenericComparator<KeySize>>;
+  using TreeIterator = IndexIterator<GenericKey<KeySize>, RID, GenericComparator<KeySize>>;
+  auto *index = dynamic_cast<TreeIndex *>(index_info_->index_.get());
+  BUSTUB_ASSERT(index != nullptr, "Index scans are only supported on B+ tree indexes.");
+
+  std::shared_ptr<TreeIterator> iter;
+  if (key_range_) {
+    Schema *key_schema = index->GetKeySchema();
+    GenericKey<KeySize> low;
+    GenericKey<KeySize> high;
+    low.SetFromKey(Tuple(low_key_, key_schema));
+    high.SetFromKey(Tuple(high_key_, key_schema));
+    iter = std::make_shared<TreeIterator>(index->GetBeginIterator(low, high, low_inclusive_, high_inclusive_));
+  } else {
+    iter = std::make_shared<TreeIterator>(index->GetBeginIterator());
+  }
+  Schema *entry_schema = index->GetEntrySchema();
+  bool covering = covering_;
+  next_entry_ = [iter, entry_schema, covering](RID *rid, std::vector<Value> *entry) {
+    if (iter->isEnd()) {
+      return false;
+    }
+    const auto &item = **iter;
+    *rid = item.second;
+    if (covering) {
+      entry->clear();
+      for (uint32_t i = 0; i < entry_schema->GetColumnCount(); i++) {
+        entry->push_back(item.first.ToValue(entry_schema, i));
+      }
+    }
+    ++(*iter);
+    return true;
+  };
+}
+
+void IndexScanExecutor::SetKeyRange() {
+  key_range_ = false;
+  const auto *comparison = dynamic_cast<const ComparisonExpression *>(plan_->GetPredicate());
+  if (comparison == nullptr) {
+    return;
+  }
+  ComparisonType comp_type = comparison->GetComparisonType();
+  const auto *column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(0));
+  const auto *constant = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(1));
+  if (column == nullptr || constant == nullptr) {
+    // constant op column, turn it around
+    column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(1));
+    constant = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(0));
+    switch (comp_type) {
+      case ComparisonType::LessThan:
+        comp_type = ComparisonType::GreaterThan;
+        break;
+      case ComparisonType::LessThanOrEqual:
+        comp_type = ComparisonType::GreaterThanOrEqual;
+        break;
+      case ComparisonType::GreaterThan:
+        comp_type = ComparisonType::LessThan;
+        break;
+      case ComparisonType::GreaterThanOrEqual:
+        comp_type = ComparisonType::LessThanOrEqual;
+        break;
+      default:
+        break;
+    }
+  }
+  Index *index = index_info_->index_.get();
+  if (column == nullptr || constant == nullptr || comp_type == ComparisonType::NotEqual ||
+      column->GetColIdx() != index->GetKeyAttrs()[0]) {
+    return;
+  }
+  const Schema *key_schema = index->GetKeySchema();
+  for (const auto &key_column : key_schema->GetColumns()) {
+    if (!key_column.IsInlined()) {
+      return;
+    }
+  }
+
+  TypeId key_type = key_schema->GetColumn(0).GetType();
+  Value bound = constant->Evaluate(nullptr, nullptr);
+  if (bound.GetTypeId() != key_type || bound.IsNull()) {
+    return;
+  }
+  low_inclusive_ = comp_type != ComparisonType::GreaterThan;
+  high_inclusive_ = comp_type != ComparisonType::LessThan;
+  bool has_low = comp_type != ComparisonType::LessThan && comp_type != ComparisonType::LessThanOrEqual;
+  bool has_high = comp_type != ComparisonType::GreaterThan && comp_type != ComparisonType::GreaterThanOrEqual;
+  low_key_.assign(1, has_low ? bound : Type::GetMinValue(key_type));
+  high_key_.assign(1, has_high ? bound : Type::GetMaxValue(key_type));
+  // the remaining key columns are unconstrained, pad them so that the whole range is covered
+  for (uint32_t i = 1; i < key_schema->GetColumnCount(); i++) {
+    TypeId type = key_schema->GetColumn(i).GetType();
+    low_key_.push_back(low_inclusive_ ? Type::GetMinValue(type) : Type::GetMaxValue(type));
+    high_key_.push_back(high_inclusive_ ? Type::GetMaxValue(type) : Type::GetMinValue(type));
+  }
+  key_range_ = true;
+}
+
+Tuple IndexScanExecutor::RowFromEntry(const std::vector<Value> &entry) const {
+  const Schema &schema = table_info_->schema_;
+  std::vector<Value> values;
+  values.reserve(schema.GetColumnCount());
+  for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
+    if (entry_columns_[i] >= 0) {
+      values.push_back(entry[entry_columns_[i]]);
+    } else {
+      // a placeholder, the plan never reads columns missing from the index
+      values.push_back(ValueFactory::GetZeroValueByType(schema.GetColumn(i).GetType()));
+    }
+  }
+  return Tuple(values, &schema);
+}
 
-void IndexScanExecutor::Init() {}
+bool IndexScanExecutor::Next(Tuple *tuple, RID *rid) {
+  const Schema *schema = &table_info_->schema_;
+  const Schema *output_schema = GetOutputSchema();
+  RID entry_rid;
+  std::vector<Value> entry;
+  while (next_entry_(&entry_rid, &entry)) {
+    Tuple row;
+    if (covering_) {
+      row = RowFromEntry(entry);
+    } else if (!table_info_->table_->GetTuple(entry_rid, &row, exec_ctx_->GetTransaction())) {
+      continue;
+    }
+    if (plan_->GetPredicate() != nullptr && !PassesPredicate(plan_->GetPredicate()->Evaluate(&row, schema))) {
+      continue;
+    }
 
-bool IndexScanExecutor::Next(Tuple *tuple, RID *rid) { return false; }
+    std::vector<Value> values;
+    values.reserve(output_schema->GetColumnCount());
+    for (const auto &column : output_schema->GetColumns()) {
+      values.push_back(column.GetExpr()->Evaluate(&row, schema));
+    }
+    *tuple = Tuple(values, output_schema);
+    *rid = entry_rid;
+    return true;
+  }
+  return false;
+}
 
 }  // namespace bustub
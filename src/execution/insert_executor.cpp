@@ -27,22 +27,37 @@ InsertExecutor::InsertExecutor(ExecutorContext *exec_ctx, const InsertPlanNode *
 void InsertExecutor::Init() {
     const auto &catalog = exec_ctx_->GetCatalog();
     this->table = catalog->GetTable(plan_->TableOid());
+    this->indexes = catalog->GetTableIndexes(this->table->name_);
+    this->done_inserting = false;
     if(!plan_->IsRawInsert()){
         exec_child->Init();
     }
 
 }
 
+void InsertExecutor::InsertIntoIndexes(Tuple *t, RID r) {
+    // entries carry the key columns followed by the included ones
+    for (auto *index_info : this->indexes) {
+        Index *index = index_info->index_.get();
+        index->InsertEntry(t->KeyFromTuple(this->table->schema_, *index->GetEntrySchema(), index->GetEntryAttrs()), r,
+                           exec_ctx_->GetTransaction());
+    }
+}
+
 bool InsertExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) { 
+    // all the inserts happen in the first call, later calls report there is nothing left
+    if (this->done_inserting) return false;
+    this->done_inserting = true;
     Tuple t;
     RID r;
     if (plan_->IsRawInsert())    {
         auto num = plan_->RawValues().size();
         for(size_t i = 0; i < num; i++){
-            t = Tuple(plan_->RawValuesAt(i), this->GetOutputSchema());
+            t = Tuple(plan_->RawValuesAt(i), &this->table->schema_);
             auto done = this->table->table_->InsertTuple(t, &r, exec_ctx_->GetTransaction());
         //    LOG_DEBUG("Insert tuple successfully: %s", tuple->ToString(this->GetOutputSchema()).c_str());
             if (!done) return false;
+            InsertIntoIndexes(&t, r);
         }
       //  LOG_DEBUG("Insert %d tuples into table", int(plan_->RawValues().size()));
         return true;
@@ -53,6 +68,7 @@ bool InsertExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) {
            //LOG_DEBUG("Read tuple: %s", tuple->ToString(this->GetOutputSchema()).c_str());
             auto done = this->table->table_->InsertTuple(t, &r, exec_ctx_->GetTransaction());
             if (!done) return false;
+            InsertIntoIndexes(&t, r);
         }
         return true;
     }
@@ -16,10 +16,26 @@ namespace bustub {
 
 LimitExecutor::LimitExecutor(ExecutorContext *exec_ctx, const LimitPlanNode *plan,
                              std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {}
 
-void LimitExecutor::Init() {}
+void LimitExecutor::Init() {
+  child_executor_->Init();
+  num_returned_ = 0;
+  Tuple tuple;
+  RID rid;
+  for (size_t i = 0; i < plan_->GetOffset(); i++) {
+    if (!child_executor_->Next(&tuple, &rid)) {
+      break;
+    }
+  }
+}
 
-bool LimitExecutor::Next(Tuple *tuple, RID *rid) { return false; }
+bool LimitExecutor::Next(Tuple *tuple, RID *rid) {
+  if (num_returned_ == plan_->GetLimit() || !child_executor_->Next(tuple, rid)) {
+    return false;
+  }
+  num_returned_++;
+  return true;
+}
 
 }  // namespace bustub
@@ -0,0 +1,158 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// merge_join_executor.cpp
+//
+// Identification: src/execution/merge_join_executor.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <utility>
+#include <vector>
+
+#include "execution/executors/hash_join_executor.h"
+#include "execution/executors/merge_join_executor.h"
+#include "execution/executors/sort_executor.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+MergeJoinExecutor::MergeJoinExecutor(ExecutorContext *exec_ctx, const MergeJoinPlanNode *plan,
+                                     std::unique_ptr<AbstractExecutor> &&left_executor,
+                                     std::unique_ptr<AbstractExecutor> &&right_executor)
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      left_executor_(std::move(left_executor)),
+      right_executor_(std::move(right_executor)) {
+  for (size_t i = 0; i < plan_->GetLeftKeys().size(); i++) {
+    key_types_.push_back(JoinKeyEncoder::KeyType(plan_->GetLeftKeys()[i]->GetReturnType(),
+                                                 plan_->GetRightKeys()[i]->GetReturnType()));
+  }
+  left_.executor_ = left_executor_.get();
+  left_.key_exprs_ = &plan_->GetLeftKeys();
+  right_.executor_ = right_executor_.get();
+  right_.key_exprs_ = &plan_->GetRightKeys();
+}
+
+void MergeJoinExecutor::Init() {
+  for (Side *side : {&left_, &right_}) {
+    side->executor_->Init();
+    side->batch_.Clear();
+    side->row_ = 0;
+    side->done_ = false;
+    Seek(side);
+  }
+  right_run_.clear();
+  run_valid_ = false;
+  results_.Reset(GetOutputSchema());
+  next_result_ = 0;
+
+  const Schema *right_schema = right_executor_->GetOutputSchema();
+  std::vector<Value> nulls;
+  for (const auto &col : right_schema->GetColumns()) {
+    nulls.push_back(ValueFactory::GetNullValueByType(col.GetType()));
+  }
+  null_right_tuple_ = Tuple(nulls, right_schema);
+}
+
+bool MergeJoinExecutor::Next(Tuple *tuple, RID *rid) {
+  while (next_result_ == results_.GetNumRows()) {
+    if (!JoinNextLeft()) {
+      return false;
+    }
+  }
+  *tuple = results_.GetTuple(next_result_++);
+  return true;
+}
+
+bool MergeJoinExecutor::NextBatch(TupleBatch *batch) {
+  batch->Reset(GetOutputSchema());
+  while (!batch->IsFull() && (next_result_ < results_.GetNumRows() || JoinNextLeft())) {
+    next_result_ = batch->AppendFrom(results_, next_result_);
+  }
+  return !batch->IsEmpty();
+}
+
+void MergeJoinExecutor::Seek(Side *side) {
+  while (side->row_ == side->batch_.GetNumRows()) {
+    if (!side->executor_->NextBatch(&side->batch_)) {
+      side->done_ = true;
+      return;
+    }
+    side->row_ = 0;
+    side->key_columns_.Resize(side->key_exprs_->size());
+    for (size_t i = 0; i < side->key_exprs_->size(); i++) {
+      side->key_columns_.Evaluate(i, (*side->key_exprs_)[i], side->batch_);
+    }
+  }
+  side->key_.clear();
+  side->null_key_ = false;
+  for (size_t i = 0; i < side->key_columns_.GetNumColumns(); i++) {
+    const Value &value = side->key_columns_[i][side->row_];
+    side->null_key_ = side->null_key_ || value.IsNull();
+    if (value.GetTypeId() == key_types_[i]) {
+      SortExecutor::EncodeSortKey(value, OrderByType::ASC, &side->key_);
+    } else {
+      SortExecutor::EncodeSortKey(value.CastAs(key_types_[i]), OrderByType::ASC, &side->key_);
+    }
+  }
+}
+
+void MergeJoinExecutor::Advance(Side *side) {
+  side->row_++;
+  Seek(side);
+}
+
+void MergeJoinExecutor::BufferRun(const std::string &key) {
+  // NULL keys sort last, so the right side has no match left once it reaches one
+  while (!right_.done_ && !right_.null_key_ && right_.key_ < key) {
+    Advance(&right_);
+  }
+  right_run_.clear();
+  while (!right_.done_ && !right_.null_key_ && right_.key_ == key) {
+    right_run_.push_back(right_.batch_.GetTuple(right_.row_));
+    Advance(&right_);
+  }
+  run_key_ = key;
+  run_valid_ = true;
+}
+
+bool MergeJoinExecutor::JoinNextLeft() {
+  results_.Clear();
+  next_result_ = 0;
+  if (left_.done_) {
+    return false;
+  }
+  Tuple left_tuple = left_.batch_.GetTuple(left_.row_);
+  bool matched = false;
+  if (!left_.null_key_) {
+    // the left keys ascend, so a left key other than the run's is larger and starts a new run
+    if (!run_valid_ || left_.key_ != run_key_) {
+      BufferRun(left_.key_);
+    }
+    for (const auto &right_tuple : right_run_) {
+      Emit(left_tuple, right_tuple);
+    }
+    matched = !right_run_.empty();
+  }
+  if (!matched && plan_->GetJoinType() == JoinType::LEFT) {
+    Emit(left_tuple, null_right_tuple_);
+  }
+  Advance(&left_);
+  return true;
+}
+
+void MergeJoinExecutor::Emit(const Tuple &left_tuple, const Tuple &right_tuple) {
+  const Schema *left_schema = left_executor_->GetOutputSchema();
+  const Schema *right_schema = right_executor_->GetOutputSchema();
+  std::vector<Value> values;
+  for (const auto &col : GetOutputSchema()->GetColumns()) {
+    values.push_back(col.GetExpr()->EvaluateJoin(&left_tuple, left_schema, &right_tuple, right_schema));
+  }
+  results_.Append(values, RID());
+}
+
+}  // namespace bustub
@@ -10,6 +10,9 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <utility>
+#include <vector>
+
 #include "execution/executors/nested_loop_join_executor.h"
 
 namespace bustub {
@@ -17,10 +20,74 @@ namespace bustub {
 NestedLoopJoinExecutor::NestedLoopJoinExecutor(ExecutorContext *exec_ctx, const NestedLoopJoinPlanNode *plan,
                                                std::unique_ptr<AbstractExecutor> &&left_executor,
                                                std::unique_ptr<AbstractExecutor> &&right_executor)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      left_executor_(std::move(left_executor)),
+      right_executor_(std::move(right_executor)) {}
+
+void NestedLoopJoinExecutor::Init() {
+  left_executor_->Init();
+  left_tuples_.clear();
+  right_done_ = true;
+  results_.Reset(GetOutputSchema());
+  next_result_ = 0;
+}
+
+bool NestedLoopJoinExecutor::Next(Tuple *tuple, RID *rid) {
+  while (next_result_ == results_.GetNumRows()) {
+    if (!JoinNextBlock()) {
+      return false;
+    }
+  }
+  *tuple = results_.GetTuple(next_result_++);
+  return true;
+}
+
+bool NestedLoopJoinExecutor::NextBatch(TupleBatch *batch) {
+  batch->Reset(GetOutputSchema());
+  while (!batch->IsFull() && (next_result_ < results_.GetNumRows() || JoinNextBlock())) {
+    next_result_ = batch->AppendFrom(results_, next_result_);
+  }
+  return !batch->IsEmpty();
+}
 
-void NestedLoopJoinExecutor::Init() {}
+bool NestedLoopJoinExecutor::JoinNextBlock() {
+  results_.Clear();
+  next_result_ = 0;
+  if (right_done_) {
+    if (!left_executor_->NextBatch(&left_batch_)) {
+      return false;
+    }
+    left_tuples_.clear();
+    for (uint32_t row = 0; row < left_batch_.GetNumRows(); row++) {
+      left_tuples_.push_back(left_batch_.GetTuple(row));
+    }
+    right_executor_->Init();
+    right_done_ = false;
+  }
+  if (!right_executor_->NextBatch(&right_batch_)) {
+    right_done_ = true;
+    return true;
+  }
 
-bool NestedLoopJoinExecutor::Next(Tuple *tuple, RID *rid) { return false; }
+  const Schema *left_schema = left_executor_->GetOutputSchema();
+  const Schema *right_schema = right_executor_->GetOutputSchema();
+  const AbstractExpression *predicate = plan_->Predicate();
+  for (uint32_t row = 0; row < right_batch_.GetNumRows(); row++) {
+    Tuple right_tuple = right_batch_.GetTuple(row);
+    for (const auto &left_tuple : left_tuples_) {
+      if (predicate != nullptr &&
+          !PassesPredicate(predicate->EvaluateJoin(&left_tuple, left_schema, &right_tuple, right_schema))) {
+        continue;
+      }
+      std::vector<Value> values;
+      for (const auto &col : GetOutputSchema()->GetColumns()) {
+        values.push_back(col.GetExpr()->EvaluateJoin(&left_tuple, left_schema, &right_tuple, right_schema));
+      }
+      results_.Append(values, RID());
+    }
+  }
+  return true;
+}
 
 }  // namespace bustub
@@ -0,0 +1,133 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_context.cpp
+//
+// Identification: src/execution/parallel_context.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/parallel_context.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "execution/plans/seq_scan_plan.h"
+
+namespace bustub {
+
+RepartitionQueues::RepartitionQueues(size_t num_workers, const std::atomic<bool> *cancelled)
+    : queues_(num_workers), producer_done_(num_workers, false), cancelled_(cancelled) {}
+
+void RepartitionQueues::Push(size_t partition, std::vector<Tuple> *tuples) {
+  {
+    std::scoped_lock latch{latch_};
+    auto &queue = queues_[partition];
+    if (queue.empty()) {
+      queue.swap(*tuples);
+    } else {
+      for (auto &tuple : *tuples) {
+        queue.push_back(std::move(tuple));
+      }
+    }
+  }
+  tuples->clear();
+  not_empty_.notify_all();
+}
+
+void RepartitionQueues::ProducerDone(size_t worker_id) {
+  {
+    std::scoped_lock latch{latch_};
+    if (producer_done_[worker_id]) {
+      return;
+    }
+    producer_done_[worker_id] = true;
+    num_producers_done_++;
+  }
+  not_empty_.notify_all();
+}
+
+bool RepartitionQueues::Pop(size_t partition, std::vector<Tuple> *tuples, bool wait) {
+  tuples->clear();
+  std::unique_lock latch{latch_};
+  if (wait) {
+    not_empty_.wait(latch, [&] {
+      return !queues_[partition].empty() || num_producers_done_ == producer_done_.size() || *cancelled_;
+    });
+  }
+  if (*cancelled_) {
+    return false;
+  }
+  tuples->swap(queues_[partition]);
+  return !tuples->empty();
+}
+
+void RepartitionQueues::Wake() {
+  // the latch orders the wake-up after the check of a worker that is about to wait
+  { std::scoped_lock latch{latch_}; }
+  not_empty_.notify_all();
+}
+
+ParallelContext::ParallelContext(size_t num_workers, size_t morsel_pages)
+    : num_workers_(num_workers), morsel_pages_(morsel_pages), worker_done_(num_workers, false) {}
+
+bool ParallelContext::IsSplit(const AbstractPlanNode *plan) {
+  switch (plan->GetType()) {
+    case PlanType::SeqScan:
+      return static_cast<const SeqScanPlanNode *>(plan)->IsParallel();
+    case PlanType::Repartition:
+      return true;
+    case PlanType::Gather:
+      // a gather below runs workers of its own and returns all of its tuples to every copy
+      return false;
+    default:
+      return std::any_of(plan->GetChildren().begin(), plan->GetChildren().end(),
+                         [](const AbstractPlanNode *child) { return IsSplit(child); });
+  }
+}
+
+TableMorselQueue *ParallelContext::GetMorselQueue(const AbstractPlanNode *scan_plan, TableHeap *table_heap) {
+  std::scoped_lock latch{latch_};
+  auto &queue = morsel_queues_[scan_plan];
+  if (queue == nullptr) {
+    queue = std::make_unique<TableMorselQueue>(table_heap, morsel_pages_);
+  }
+  return queue.get();
+}
+
+RepartitionQueues *ParallelContext::GetRepartitionQueues(const AbstractPlanNode *repartition_plan) {
+  std::scoped_lock latch{latch_};
+  auto &queues = repartition_queues_[repartition_plan];
+  if (queues == nullptr) {
+    queues = std::make_unique<RepartitionQueues>(num_workers_, &cancelled_);
+    // workers that are done already produce nothing
+    for (size_t worker_id = 0; worker_id < num_workers_; worker_id++) {
+      if (worker_done_[worker_id]) {
+        queues->ProducerDone(worker_id);
+      }
+    }
+  }
+  return queues.get();
+}
+
+void ParallelContext::WorkerDone(size_t worker_id) {
+  std::scoped_lock latch{latch_};
+  worker_done_[worker_id] = true;
+  for (auto &[plan, queues] : repartition_queues_) {
+    queues->ProducerDone(worker_id);
+  }
+}
+
+void ParallelContext::Cancel() {
+  cancelled_ = true;
+  std::scoped_lock latch{latch_};
+  for (auto &[plan, queues] : repartition_queues_) {
+    queues->Wake();
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,120 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// repartition_executor.cpp
+//
+// Identification: src/execution/repartition_executor.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <utility>
+#include <vector>
+
+#include "execution/executors/repartition_executor.h"
+
+namespace bustub {
+
+namespace {
+
+// integers are hashed as BIGINT, so that integer keys of any width go to the same partition
+std::vector<TypeId> KeyTypes(const RepartitionPlanNode *plan) {
+  std::vector<TypeId> key_types;
+  for (const auto *key : plan->GetKeys()) {
+    key_types.push_back(JoinKeyEncoder::KeyType(key->GetReturnType(), key->GetReturnType()));
+  }
+  return key_types;
+}
+
+}  // namespace
+
+RepartitionExecutor::RepartitionExecutor(ExecutorContext *exec_ctx, const RepartitionPlanNode *plan,
+                                         std::unique_ptr<AbstractExecutor> &&child_executor)
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      child_executor_(std::move(child_executor)),
+      keys_(plan->GetKeys(), KeyTypes(plan)) {}
+
+void RepartitionExecutor::Init() {
+  child_executor_->Init();
+  ParallelContext *parallel_ctx = exec_ctx_->GetParallelContext();
+  queues_ = parallel_ctx == nullptr ? nullptr : parallel_ctx->GetRepartitionQueues(plan_);
+  partition_ = exec_ctx_->GetWorkerId();
+  partitions_.assign(parallel_ctx == nullptr ? 1 : parallel_ctx->GetNumWorkers(), {});
+  child_done_ = false;
+  tuples_.clear();
+  next_tuple_ = 0;
+}
+
+bool RepartitionExecutor::Next(Tuple *tuple, RID *rid) {
+  while (next_tuple_ == tuples_.size()) {
+    if (!ReadTuples()) {
+      return false;
+    }
+  }
+  *tuple = std::move(tuples_[next_tuple_++]);
+  *rid = tuple->GetRid();
+  return true;
+}
+
+bool RepartitionExecutor::NextBatch(TupleBatch *batch) {
+  batch->Reset(GetOutputSchema());
+  while (!batch->IsFull()) {
+    if (next_tuple_ == tuples_.size() && !ReadTuples()) {
+      break;
+    }
+    const Tuple &tuple = tuples_[next_tuple_++];
+    batch->Append(tuple, tuple.GetRid());
+  }
+  return !batch->IsEmpty();
+}
+
+bool RepartitionExecutor::ReadTuples() {
+  tuples_.clear();
+  next_tuple_ = 0;
+  // outside of a gather, the tuples pass through
+  if (queues_ == nullptr) {
+    if (!child_executor_->NextBatch(&batch_)) {
+      return false;
+    }
+    for (uint32_t row = 0; row < batch_.GetNumRows(); row++) {
+      tuples_.push_back(batch_.GetTuple(row));
+    }
+    return true;
+  }
+  // send tuples until some arrive for this worker, then wait for the other workers once the child is done
+  while (!queues_->Pop(partition_, &tuples_, child_done_)) {
+    if (child_done_) {
+      return false;
+    }
+    if (child_executor_->NextBatch(&batch_)) {
+      SendBatch();
+    } else {
+      child_done_ = true;
+      queues_->ProducerDone(partition_);
+    }
+  }
+  return true;
+}
+
+void RepartitionExecutor::SendBatch() {
+  keys_.Encode(batch_);
+  const auto &rows = keys_.GetRows();
+  size_t next = 0;
+  for (uint32_t row = 0; row < batch_.GetNumRows(); row++) {
+    // GetRows lists the rows with non-NULL keys in order
+    bool has_key = next < rows.size() && rows[next] == row;
+    size_t partition = has_key ? PartitionOf(keys_.GetHash(row)) : 0;
+    next += has_key ? 1 : 0;
+    partitions_[partition].push_back(batch_.GetTuple(row));
+  }
+  for (size_t partition = 0; partition < partitions_.size(); partition++) {
+    if (!partitions_[partition].empty()) {
+      queues_->Push(partition, &partitions_[partition]);
+    }
+  }
+}
+
+}  // namespace bustub
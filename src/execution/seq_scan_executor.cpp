@@ -9,32 +9,184 @@
 // Copyright (c) 2015-19, Carnegie Mellon University Database Group
 //
 //===----------------------------------------------------------------------===//
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
 #include "execution/executors/seq_scan_executor.h"
+#include "execution/expressions/column_value_expression.h"
 
 namespace bustub {
 
 SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan) : AbstractExecutor(exec_ctx), plan_(plan) {}
 
 void SeqScanExecutor::Init() {
-     const auto &catalog = exec_ctx_->GetCatalog();
-  this->table = catalog->GetTable(this->plan_->GetTableOid())->table_.get();
-  this->iter = std::make_unique<TableIterator>(this->table->Begin(exec_ctx_->GetTransaction()));
+  const auto &catalog = exec_ctx_->GetCatalog();
+  auto *table_info = catalog->GetTable(this->plan_->GetTableOid());
+  this->table = table_info->table_.get();
+  this->table_schema_ = &table_info->schema_;
+  ParallelContext *parallel_ctx = exec_ctx_->GetParallelContext();
+  if (this->plan_->IsParallel() && parallel_ctx != nullptr) {
+    this->morsels_ = parallel_ctx->GetMorselQueue(this->plan_, this->table);
+    this->next_page_id_ = INVALID_PAGE_ID;
+    this->pages_left_ = 0;
+  } else {
+    // the whole table is one morsel
+    this->morsels_ = nullptr;
+    this->next_page_id_ = this->table->GetFirstPageId();
+    this->pages_left_ = std::numeric_limits<size_t>::max();
+  }
+  this->page_tuples_.clear();
+  this->next_tuple_ = 0;
+  // predicates that cannot be compiled are interpreted
+  this->compiled_predicate_ = this->plan_->GetPredicate() == nullptr
+                                  ? nullptr
+                                  : CompiledPredicate::Compile(this->plan_->GetPredicate(), this->table_schema_);
+  this->filter_ = nullptr;
+  if (this->compiled_predicate_ != nullptr) {
+    const CompiledPredicate *predicate = this->compiled_predicate_.get();
+    this->filter_ = [predicate](const char *data) { return predicate->Evaluate(data); };
+  }
+  // an interpreted predicate needs the whole table tuple
+  this->projection_ = nullptr;
+  if (this->plan_->GetPredicate() == nullptr || this->compiled_predicate_ != nullptr) {
+    this->projection_ = MakeProjection();
+  }
+}
+
+std::unique_ptr<TupleProjection> SeqScanExecutor::MakeProjection() const {
+  const Schema *output_schema = plan_->OutputSchema();
+  std::vector<uint32_t> columns;
+  for (const auto &col : output_schema->GetColumns()) {
+    uint32_t col_idx;
+    if (col.GetExpr() == nullptr) {
+      col_idx = table_schema_->GetColIdx(col.GetName());
+    } else {
+      const auto *column_value = dynamic_cast<const ColumnValueExpression *>(col.GetExpr());
+      if (column_value == nullptr || column_value->GetTupleIdx() != 0) {
+        return nullptr;
+      }
+      col_idx = column_value->GetColIdx();
+    }
+    // the bytes are copied as they are, so the types must be the same
+    if (table_schema_->GetColumn(col_idx).GetType() != col.GetType()) {
+      return nullptr;
+    }
+    columns.push_back(col_idx);
+  }
+  return std::make_unique<TupleProjection>(table_schema_, output_schema, std::move(columns));
+}
+
+bool SeqScanExecutor::ReadNextPage() {
+  while (this->next_page_id_ == INVALID_PAGE_ID || this->pages_left_ == 0) {
+    TableMorsel morsel;
+    if (this->morsels_ == nullptr || !this->morsels_->Next(&morsel)) {
+      return false;
+    }
+    this->next_page_id_ = morsel.first_page_id_;
+    this->pages_left_ = morsel.num_pages_;
+  }
+  this->next_page_id_ = this->table->ScanPage(this->next_page_id_, &this->page_tuples_, exec_ctx_->GetTransaction(),
+                                              this->filter_, this->projection_.get());
+  this->pages_left_--;
+  this->next_tuple_ = 0;
+  return true;
+}
+
+Value SeqScanExecutor::OutputValue(uint32_t column, const Tuple &tuple) const {
+  const auto &col = plan_->OutputSchema()->GetColumn(column);
+  // output columns without an expression are taken from the table column of the same name
+  if (col.GetExpr() == nullptr) {
+    return tuple.GetValue(table_schema_, table_schema_->GetColIdx(col.GetName()));
+  }
+  return col.GetExpr()->Evaluate(&tuple, table_schema_);
 }
 
 bool SeqScanExecutor::Next(Tuple *tuple, RID *rid) {
-    auto &iterator = *(this->iter);
-  while (iterator != this->table->End()) {
-    auto tup = *(iterator++);
-    auto passed = true;
-    if (this->plan_->GetPredicate() != nullptr) {
-      passed = this->plan_->GetPredicate()->Evaluate(&tup, this->GetOutputSchema()).GetAs<bool>();
-    }
-    if (passed) {
-      *tuple = Tuple(tup);
+  while (true) {
+    while (this->next_tuple_ == this->page_tuples_.size()) {
+      if (!ReadNextPage()) {
+        return false;
+      }
+    }
+    auto &tup = this->page_tuples_[this->next_tuple_++];
+    // a compiled predicate has been evaluated in the page already
+    if (this->compiled_predicate_ == nullptr && this->plan_->GetPredicate() != nullptr &&
+        !PassesPredicate(this->plan_->GetPredicate()->Evaluate(&tup, this->table_schema_))) {
+      continue;
+    }
+    *rid = tup.GetRid();
+    if (this->projection_ != nullptr) {
+      *tuple = std::move(tup);
       return true;
     }
+    std::vector<Value> values;
+    for (uint32_t i = 0; i < GetOutputSchema()->GetColumnCount(); i++) {
+      values.push_back(OutputValue(i, tup));
+    }
+    *tuple = Tuple(values, GetOutputSchema());
+    return true;
+  }
+}
+
+bool SeqScanExecutor::NextBatch(TupleBatch *batch) {
+  batch->Reset(GetOutputSchema());
+  // the page tuples are output tuples that passed the predicate
+  if (this->projection_ != nullptr) {
+    while (!batch->IsFull()) {
+      if (this->next_tuple_ == this->page_tuples_.size()) {
+        if (!ReadNextPage()) {
+          break;
+        }
+        continue;
+      }
+      const auto &tup = this->page_tuples_[this->next_tuple_++];
+      batch->Append(tup, tup.GetRid());
+    }
+    return !batch->IsEmpty();
   }
-  return false;
- }
+
+  std::vector<Value> predicate;
+  bool done = false;
+  // a batch of table tuples can be filtered out entirely, then the next one is read
+  while (batch->IsEmpty() && !done) {
+    table_batch_.Reset(this->table_schema_);
+    while (table_batch_.GetNumRows() < batch->GetCapacity()) {
+      // a page can have no tuple left after the compiled predicate
+      if (this->next_tuple_ == this->page_tuples_.size()) {
+        if (!ReadNextPage()) {
+          done = true;
+          break;
+        }
+        continue;
+      }
+      const auto &tup = this->page_tuples_[this->next_tuple_++];
+      table_batch_.Append(tup, tup.GetRid());
+    }
+    if (this->plan_->GetPredicate() != nullptr && this->compiled_predicate_ == nullptr) {
+      this->plan_->GetPredicate()->EvaluateBatch(table_batch_, &predicate);
+      table_batch_.Filter(predicate);
+    }
+
+    // project the rows that passed into the output columns
+    std::vector<std::vector<Value>> columns(GetOutputSchema()->GetColumnCount());
+    for (uint32_t i = 0; i < columns.size(); i++) {
+      const auto &col = GetOutputSchema()->GetColumn(i);
+      if (col.GetExpr() == nullptr) {
+        columns[i] = table_batch_.GetColumn(table_schema_->GetColIdx(col.GetName()));
+      } else {
+        col.GetExpr()->EvaluateBatch(table_batch_, &columns[i]);
+      }
+    }
+    std::vector<RID> rids;
+    rids.reserve(table_batch_.GetNumRows());
+    for (uint32_t row = 0; row < table_batch_.GetNumRows(); row++) {
+      rids.push_back(table_batch_.GetRid(row));
+    }
+    batch->SetColumns(&columns, &rids);
+  }
+  return !batch->IsEmpty();
+}
 
 }  // namespace bustub
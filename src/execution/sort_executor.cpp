@@ -0,0 +1,207 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_executor.cpp
+//
+// Identification: src/execution/sort_executor.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "common/exception.h"
+#include "execution/executors/sort_executor.h"
+
+namespace bustub {
+
+namespace {
+
+void AppendBigEndian(uint64_t bits, size_t size, std::string *key) {
+  for (size_t i = size; i-- > 0;) {
+    key->push_back(static_cast<char>(bits >> (i * 8)));
+  }
+}
+
+// two's complement with the sign bit flipped orders like an unsigned number
+template <typename T>
+void AppendSigned(T value, std::string *key) {
+  using Unsigned = std::make_unsigned_t<T>;
+  auto bits = static_cast<Unsigned>(static_cast<Unsigned>(value) ^ (Unsigned{1} << (sizeof(T) * 8 - 1)));
+  AppendBigEndian(bits, sizeof(T), key);
+}
+
+}  // namespace
+
+SortExecutor::SortExecutor(ExecutorContext *exec_ctx, const SortPlanNode *plan,
+                           std::unique_ptr<AbstractExecutor> &&child_executor)
+    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {}
+
+void SortExecutor::EncodeSortKey(const Value &value, OrderByType order, std::string *key) {
+  size_t start = key->size();
+  // one byte first so that NULL goes after every value, and a shorter string before its extensions
+  if (value.IsNull()) {
+    key->push_back('\1');
+  } else {
+    key->push_back('\0');
+    switch (value.GetTypeId()) {
+      case TypeId::BOOLEAN:
+      case TypeId::TINYINT:
+        AppendSigned(value.GetAs<int8_t>(), key);
+        break;
+      case TypeId::SMALLINT:
+        AppendSigned(value.GetAs<int16_t>(), key);
+        break;
+      case TypeId::INTEGER:
+        AppendSigned(value.GetAs<int32_t>(), key);
+        break;
+      case TypeId::BIGINT:
+        AppendSigned(value.GetAs<int64_t>(), key);
+        break;
+      case TypeId::TIMESTAMP:
+        AppendBigEndian(value.GetAs<uint64_t>(), sizeof(uint64_t), key);
+        break;
+      case TypeId::DECIMAL: {
+        // positive doubles order like their bits with the sign bit set, negative ones like their inverted bits
+        double decimal = value.GetAs<double>();
+        uint64_t bits = 0;
+        if (decimal != 0) {
+          memcpy(&bits, &decimal, sizeof(bits));
+        }
+        bits = (bits >> 63) != 0 ? ~bits : bits | (uint64_t{1} << 63);
+        AppendBigEndian(bits, sizeof(bits), key);
+        break;
+      }
+      case TypeId::VARCHAR: {
+        // a 0 byte is escaped as 0 0xFF, so that the terminator 0 0 is smaller than any character
+        const char *data = value.GetData();
+        uint32_t length = value.GetLength() == 0 ? 0 : value.GetLength() - 1;
+        for (uint32_t i = 0; i < length; i++) {
+          key->push_back(data[i]);
+          if (data[i] == '\0') {
+            key->push_back('\xFF');
+          }
+        }
+        key->push_back('\0');
+        key->push_back('\0');
+        break;
+      }
+      default:
+        throw Exception(ExceptionType::MISMATCH_TYPE, "cannot sort values of this type");
+    }
+  }
+  if (order == OrderByType::DESC) {
+    for (size_t i = start; i < key->size(); i++) {
+      (*key)[i] = static_cast<char>(~(*key)[i]);
+    }
+  }
+}
+
+void SortExecutor::Init() {
+  child_executor_->Init();
+  entries_.clear();
+  bytes_ = 0;
+  num_spilled_runs_ = 0;
+  runs_.clear();
+  merge_.reset();
+
+  while (child_executor_->NextBatch(&batch_)) {
+    AddBatch(batch_, &entries_, plan_->GetMemoryBudget());
+  }
+
+  // the tuples left in memory are the last run, so that runs_ is in the child's order and the merge stable
+  std::stable_sort(entries_.begin(), entries_.end(),
+                   [](const SortEntry &a, const SortEntry &b) { return a.key_ < b.key_; });
+  runs_.emplace_back(exec_ctx_->GetBufferPoolManager());
+  runs_.back().entries_.swap(entries_);
+  bytes_ = 0;
+  merge_ = std::make_unique<LoserTree>(runs_.size(), [this](size_t a, size_t b) {
+    if (!HasHead(runs_[b])) {
+      return HasHead(runs_[a]);
+    }
+    if (!HasHead(runs_[a])) {
+      return false;
+    }
+    int cmp = runs_[a].entries_[runs_[a].next_entry_].key_.compare(runs_[b].entries_[runs_[b].next_entry_].key_);
+    return cmp < 0 || (cmp == 0 && a < b);
+  });
+}
+
+bool SortExecutor::Next(Tuple *tuple, RID *rid) {
+  Run &run = runs_[merge_->Winner()];
+  // the winner has no tuple left only if no run has
+  if (!HasHead(run)) {
+    return false;
+  }
+  *tuple = std::move(run.entries_[run.next_entry_].tuple_);
+  Advance(&run);
+  merge_->Replay();
+  return true;
+}
+
+void SortExecutor::AddBatch(const TupleBatch &batch, std::vector<SortEntry> *entries, size_t memory_budget) {
+  const auto &order_bys = plan_->GetOrderBy();
+  BatchColumns key_columns(order_bys.size());
+  for (size_t i = 0; i < order_bys.size(); i++) {
+    key_columns.Evaluate(i, order_bys[i].second, batch);
+  }
+  for (uint32_t row = 0; row < batch.GetNumRows(); row++) {
+    SortEntry entry;
+    for (size_t i = 0; i < order_bys.size(); i++) {
+      EncodeSortKey(key_columns[i][row], order_bys[i].first, &entry.key_);
+    }
+    entry.tuple_ = batch.GetTuple(row);
+    bytes_ += entry.key_.size() + entry.tuple_.GetLength() + ENTRY_OVERHEAD;
+    entries->push_back(std::move(entry));
+    if (memory_budget != 0 && bytes_ > memory_budget) {
+      SpillRun();
+    }
+  }
+}
+
+void SortExecutor::SpillRun() {
+  std::stable_sort(entries_.begin(), entries_.end(),
+                   [](const SortEntry &a, const SortEntry &b) { return a.key_ < b.key_; });
+  runs_.emplace_back(exec_ctx_->GetBufferPoolManager());
+  Run &run = runs_.back();
+  for (const auto &entry : entries_) {
+    run.file_.Append(entry.tuple_);
+  }
+  run.file_.Close();
+  entries_.clear();
+  bytes_ = 0;
+  num_spilled_runs_++;
+  LoadNextPage(&run);
+}
+
+void SortExecutor::Advance(Run *run) {
+  if (++run->next_entry_ == run->entries_.size()) {
+    LoadNextPage(run);
+  }
+}
+
+void SortExecutor::LoadNextPage(Run *run) {
+  run->entries_.clear();
+  run->next_entry_ = 0;
+  if (run->next_page_ == run->file_.GetNumPages()) {
+    run->file_.Release();
+    return;
+  }
+  // the keys are encoded again from the tuples
+  run->file_.ReadPage(run->next_page_++, &page_tuples_);
+  page_batch_.Reset(child_executor_->GetOutputSchema());
+  for (const auto &tuple : page_tuples_) {
+    page_batch_.Append(tuple, RID());
+  }
+  size_t bytes = bytes_;
+  AddBatch(page_batch_, &run->entries_, 0);
+  bytes_ = bytes;
+}
+
+}  // namespace bustub
@@ -0,0 +1,95 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// topn_executor.cpp
+//
+// Identification: src/execution/topn_executor.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "execution/executors/sort_executor.h"
+#include "execution/executors/topn_executor.h"
+#include "execution/tuple_batch.h"
+
+namespace bustub {
+
+TopNExecutor::TopNExecutor(ExecutorContext *exec_ctx, const LimitPlanNode *limit_plan, const SortPlanNode *sort_plan,
+                           std::unique_ptr<AbstractExecutor> &&child_executor)
+    : AbstractExecutor(exec_ctx),
+      limit_plan_(limit_plan),
+      sort_plan_(sort_plan),
+      child_executor_(std::move(child_executor)) {}
+
+size_t TopNExecutor::NumKept(const LimitPlanNode *limit_plan) {
+  size_t limit = limit_plan->GetLimit();
+  size_t offset = limit_plan->GetOffset();
+  return limit > std::numeric_limits<size_t>::max() - offset ? std::numeric_limits<size_t>::max() : limit + offset;
+}
+
+bool TopNExecutor::CanExecute(const LimitPlanNode *limit_plan, const SortPlanNode *sort_plan) {
+  size_t num_kept = NumKept(limit_plan);
+  if (num_kept > MAX_KEPT_TUPLES) {
+    return false;
+  }
+  size_t memory_budget = sort_plan->GetMemoryBudget();
+  // the inlined length of the tuples is a lower bound of their size
+  return memory_budget == 0 || num_kept <= memory_budget / (sort_plan->OutputSchema()->GetLength() + sizeof(HeapEntry));
+}
+
+void TopNExecutor::Init() {
+  child_executor_->Init();
+  heap_.clear();
+  next_entry_ = 0;
+  // the heap grows with the tuples read, a large limit over a small input does not allocate for the limit
+  size_t num_kept = NumKept(limit_plan_);
+  if (num_kept == 0) {
+    return;
+  }
+
+  const auto &order_bys = sort_plan_->GetOrderBy();
+  BatchColumns key_columns(order_bys.size());
+  TupleBatch batch;
+  std::string key;
+  size_t position = 0;
+  while (child_executor_->NextBatch(&batch)) {
+    for (size_t i = 0; i < order_bys.size(); i++) {
+      key_columns.Evaluate(i, order_bys[i].second, batch);
+    }
+    for (uint32_t row = 0; row < batch.GetNumRows(); row++, position++) {
+      key.clear();
+      for (size_t i = 0; i < order_bys.size(); i++) {
+        SortExecutor::EncodeSortKey(key_columns[i][row], order_bys[i].first, &key);
+      }
+      // a later tuple with the key of the worst one kept goes after it, so it is dropped as well
+      if (heap_.size() == num_kept && key >= heap_.front().key_) {
+        continue;
+      }
+      if (heap_.size() == num_kept) {
+        std::pop_heap(heap_.begin(), heap_.end(), Before);
+        heap_.pop_back();
+      }
+      heap_.push_back(HeapEntry{key, position, batch.GetTuple(row)});
+      std::push_heap(heap_.begin(), heap_.end(), Before);
+    }
+  }
+  std::sort_heap(heap_.begin(), heap_.end(), Before);
+  next_entry_ = limit_plan_->GetOffset();
+}
+
+bool TopNExecutor::Next(Tuple *tuple, RID *rid) {
+  if (next_entry_ >= heap_.size()) {
+    return false;
+  }
+  *tuple = std::move(heap_[next_entry_++].tuple_);
+  return true;
+}
+
+}  // namespace bustub
@@ -0,0 +1,106 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_batch.cpp
+//
+// Identification: src/execution/tuple_batch.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/tuple_batch.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "common/macros.h"
+#include "execution/expressions/abstract_expression.h"
+
+namespace bustub {
+
+TupleBatch::TupleBatch(const Schema *schema, uint32_t capacity) : schema_(nullptr), capacity_(capacity) {
+  BUSTUB_ASSERT(capacity > 0, "a batch must hold at least one tuple");
+  Reset(schema);
+}
+
+void TupleBatch::Reset(const Schema *schema) {
+  schema_ = schema;
+  columns_.resize(schema == nullptr ? 0 : schema->GetColumnCount());
+  Clear();
+}
+
+void TupleBatch::Clear() {
+  for (auto &column : columns_) {
+    column.clear();
+  }
+  rids_.clear();
+}
+
+void TupleBatch::Append(const Tuple &tuple, const RID &rid) {
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    columns_[i].push_back(tuple.GetValue(schema_, i));
+  }
+  rids_.push_back(rid);
+}
+
+void TupleBatch::Append(const std::vector<Value> &values, const RID &rid) {
+  BUSTUB_ASSERT(values.size() == columns_.size(), "one value per column");
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    columns_[i].push_back(values[i]);
+  }
+  rids_.push_back(rid);
+}
+
+uint32_t TupleBatch::AppendFrom(const TupleBatch &other, uint32_t begin) {
+  BUSTUB_ASSERT(other.columns_.size() == columns_.size(), "the batches must have the same columns");
+  uint32_t room = IsFull() ? 0 : capacity_ - GetNumRows();
+  uint32_t end = std::min(other.GetNumRows(), begin + room);
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    columns_[i].insert(columns_[i].end(), other.columns_[i].begin() + begin, other.columns_[i].begin() + end);
+  }
+  rids_.insert(rids_.end(), other.rids_.begin() + begin, other.rids_.begin() + end);
+  return end;
+}
+
+void TupleBatch::Filter(const std::vector<Value> &predicate) {
+  BUSTUB_ASSERT(predicate.size() == rids_.size(), "one predicate value per tuple");
+  uint32_t kept = 0;
+  for (uint32_t row = 0; row < rids_.size(); row++) {
+    if (!PassesPredicate(predicate[row])) {
+      continue;
+    }
+    if (kept != row) {
+      for (auto &column : columns_) {
+        column[kept] = column[row];
+      }
+      rids_[kept] = rids_[row];
+    }
+    kept++;
+  }
+  for (auto &column : columns_) {
+    column.resize(kept);
+  }
+  rids_.resize(kept);
+}
+
+void TupleBatch::SetColumns(std::vector<std::vector<Value>> *columns, std::vector<RID> *rids) {
+  BUSTUB_ASSERT(columns->size() == columns_.size(), "one vector per column");
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    BUSTUB_ASSERT((*columns)[i].size() == rids->size(), "columns must be as long as the rids");
+    columns_[i].swap((*columns)[i]);
+  }
+  rids_.swap(*rids);
+}
+
+Tuple TupleBatch::GetTuple(uint32_t row) const {
+  std::vector<Value> values;
+  values.reserve(columns_.size());
+  for (const auto &column : columns_) {
+    values.push_back(column[row]);
+  }
+  return Tuple(values, schema_);
+}
+
+}  // namespace bustub
@@ -167,7 +167,7 @@ class BufferPoolManager {
   Replacer *replacer_;
   /** List of free pages. */
   std::list<frame_id_t> free_list_;
-  /** This latch protects shared data structures. We recommend updating this comment to describe what it protects. */
+  /** This latch protects the page table, the free list, the replacer and the metadata of the frames. */
   std::mutex latch_;
 };
 }  // namespace bustub
@@ -10,6 +10,7 @@
 #include "catalog/schema.h"
 #include "storage/index/b_plus_tree_index.h"
 #include "storage/index/index.h"
+#include "storage/index/linear_probe_hash_table_index.h"
 #include "storage/table/table_heap.h"
 
 namespace bustub {
@@ -51,6 +52,8 @@ struct IndexInfo {
   index_oid_t index_oid_;
   std::string table_name_;
   const size_t key_size_;
+  /** Statistics of the index, refreshed by Catalog::AnalyzeIndex. */
+  IndexStatistics stats_;
 };
 
 /**
@@ -123,33 +126,131 @@ class Catalog {
    * @param key_schema the schema of the key
    * @param key_attrs key attributes
    * @param keysize size of the key
+   * @param included_attrs non-key attributes stored in every entry for index-only scans,
+   * keysize must hold the key and the included columns together
    * @return a pointer to the metadata of the new table
    */
   template <class KeyType, class ValueType, class KeyComparator>
   IndexInfo *CreateIndex(Transaction *txn, const std::string &index_name, const std::string &table_name,
                          const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs,
-                         size_t keysize) {
-  //   auto index_oid = next_index_oid_++;
-
-  // std::unordered_map<std::string, index_oid_t> inner;
-  // inner.insert(std::make_pair(index_name, index_oid));
-  // index_names_.insert(std::make_pair(table_name, inner));
-  // // static_cast<std::unique_ptr<IndexMetadata>>(indx)
-  //   // auto indx = new Index(index_name, table_name, &schema, key_attrs);
-  //   auto indx = new Index()
-  //   auto index_info = new IndexInfo{key_schema, index_name,static_cast<std::unique_ptr<Index>>(indx), index_oid,table_name, keysize};
-  //   indexes_.insert({index_oid, static_cast<std::unique_ptr<IndexInfo>>(index_info)});
-  //   return indexes_[index_oid].get();
-  return nullptr;
+                         size_t keysize, const std::vector<uint32_t> &included_attrs = {}) {
+    BUSTUB_ASSERT(index_names_[table_name].count(index_name) == 0, "Index names should be unique!");
+    auto *metadata = new IndexMetadata{index_name, table_name, &schema, key_attrs, included_attrs};
+    BUSTUB_ASSERT(metadata->GetEntrySchema()->GetLength() <= keysize, "Index entries should fit in the key size!");
+    auto index = std::make_unique<BPlusTreeIndex<KeyType, ValueType, KeyComparator>>(metadata, bpm_);
+
+    // populate the index with the tuples already in the table
+    TableHeap *table_heap = GetTable(table_name)->table_.get();
+    for (auto iter = table_heap->Begin(txn); iter != table_heap->End(); ++iter) {
+      index->InsertEntry(iter->KeyFromTuple(schema, *metadata->GetEntrySchema(), metadata->GetEntryAttrs()),
+                         iter->GetRid(), txn);
+    }
+    return AddIndex(std::move(index), index_name, table_name, key_schema, keysize);
+  }
+
+  /**
+   * Create a new linear probing hash index, populate existing data of the table and return its metadata.
+   * The rows are counted first, so that the hash table is sized for them, then bulk loaded in batches of
+   * INDEX_BUILD_BATCH_SIZE rows.
+   * @param txn the transaction in which the table is being created
+   * @param index_name the name of the new index
+   * @param table_name the name of the table
+   * @param schema the schema of the table
+   * @param key_schema the schema of the key
+   * @param key_attrs key attributes
+   * @param keysize size of the key
+   * @param hash_fn the hash function of the hash table
+   * @return a pointer to the metadata of the new table
+   */
+  template <class KeyType, class ValueType, class KeyComparator>
+  IndexInfo *CreateHashIndex(Transaction *txn, const std::string &index_name, const std::string &table_name,
+                             const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs,
+                             size_t keysize, const HashFunction<KeyType> &hash_fn = HashFunction<KeyType>()) {
+    BUSTUB_ASSERT(index_names_[table_name].count(index_name) == 0, "Index names should be unique!");
+    auto *metadata = new IndexMetadata{index_name, table_name, &schema, key_attrs};
+    BUSTUB_ASSERT(metadata->GetEntrySchema()->GetLength() <= keysize, "Index entries should fit in the key size!");
+    // a single bucket to start with, the index is sized for the rows before they are loaded
+    auto index = std::make_unique<LinearProbeHashTableIndex<KeyType, ValueType, KeyComparator>>(metadata, bpm_, 1,
+                                                                                                 hash_fn);
+
+    // populate the index with the tuples already in the table
+    TableHeap *table_heap = GetTable(table_name)->table_.get();
+    size_t num_rows = 0;
+    for (auto iter = table_heap->Begin(txn); iter != table_heap->End(); ++iter) {
+      num_rows++;
+    }
+    index->ReserveEntries(num_rows);
+    std::vector<Tuple> entries;
+    std::vector<RID> rids;
+    for (auto iter = table_heap->Begin(txn); iter != table_heap->End(); ++iter) {
+      entries.push_back(iter->KeyFromTuple(schema, *metadata->GetEntrySchema(), metadata->GetEntryAttrs()));
+      rids.push_back(iter->GetRid());
+      if (entries.size() == INDEX_BUILD_BATCH_SIZE) {
+        index->InsertEntries(entries, rids, txn);
+        entries.clear();
+        rids.clear();
+      }
+    }
+    index->InsertEntries(entries, rids, txn);
+    return AddIndex(std::move(index), index_name, table_name, key_schema, keysize);
+  }
+
+  IndexInfo *GetIndex(const std::string &index_name, const std::string &table_name) {
+    auto table_iter = index_names_.find(table_name);
+    if (table_iter == index_names_.end()) {
+      throw std::out_of_range{"The table has no index in the catalog."};
+    }
+    auto index_iter = table_iter->second.find(index_name);
+    if (index_iter == table_iter->second.end()) {
+      throw std::out_of_range{"The index doesn't exist in the catalog."};
+    }
+    return GetIndex(index_iter->second);
   }
 
-  IndexInfo *GetIndex(const std::string &index_name, const std::string &table_name) { return nullptr; }
+  IndexInfo *GetIndex(index_oid_t index_oid) {
+    auto iter = indexes_.find(index_oid);
+    if (iter == indexes_.end()) {
+      throw std::out_of_range{"The index doesn't exist in the catalog."};
+    }
+    return iter->second.get();
+  }
 
-  IndexInfo *GetIndex(index_oid_t index_oid) { return nullptr; }
+  std::vector<IndexInfo *> GetTableIndexes(const std::string &table_name) {
+    std::vector<IndexInfo *> result;
+    auto table_iter = index_names_.find(table_name);
+    if (table_iter == index_names_.end()) {
+      return result;
+    }
+    for (const auto &name_and_oid : table_iter->second) {
+      result.push_back(indexes_.find(name_and_oid.second)->second.get());
+    }
+    return result;
+  }
 
-  std::vector<IndexInfo *> GetTableIndexes(const std::string &table_name) { return std::vector<IndexInfo *>(); }
+  /**
+   * Refresh the statistics stored with an index by sampling it.
+   * @param index_info the index to analyze
+   * @param sample_leaves the number of leaf pages to sample
+   * @return the refreshed statistics, left invalid if the index type does not collect any
+   */
+  const IndexStatistics &AnalyzeIndex(IndexInfo *index_info,
+                                      size_t sample_leaves = IndexStatistics::DEFAULT_SAMPLE_LEAVES) {
+    index_info->stats_ = IndexStatistics();
+    index_info->index_->CollectStatistics(&index_info->stats_, sample_leaves);
+    return index_info->stats_;
+  }
 
  private:
+  /** Register a populated index of the table and return its metadata. */
+  IndexInfo *AddIndex(std::unique_ptr<Index> &&index, const std::string &index_name, const std::string &table_name,
+                      const Schema &key_schema, size_t keysize) {
+    index_oid_t index_oid = next_index_oid_++;
+    index_names_[table_name].insert({index_name, index_oid});
+    auto *index_info = new IndexInfo{key_schema, index_name, std::move(index), index_oid, table_name, keysize};
+    indexes_.insert({index_oid, std::unique_ptr<IndexInfo>(index_info)});
+    return index_info;
+  }
+
   [[maybe_unused]] BufferPoolManager *bpm_;
   [[maybe_unused]] LockManager *lock_manager_;
   [[maybe_unused]] LogManager *log_manager_;
@@ -27,6 +27,9 @@ extern std::atomic<bool> enable_logging;
 /** If ENABLE_LOGGING is true, the log should be flushed to disk every LOG_TIMEOUT. */
 extern std::chrono::duration<int64_t> log_timeout;
 
+/** Lazily-deleting B+ trees merge their underfull leaves in the background every INDEX_MERGE_INTERVAL. */
+extern std::chrono::milliseconds index_merge_interval;
+
 static constexpr int INVALID_PAGE_ID = -1;                                    // invalid page id
 static constexpr int INVALID_TXN_ID = -1;                                     // invalid transaction id
 static constexpr int INVALID_LSN = -1;                                        // invalid log sequence number
@@ -35,6 +38,9 @@ static constexpr int PAGE_SIZE = 4096;                                        //
 static constexpr int BUFFER_POOL_SIZE = 10;                                   // size of buffer pool
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                        // size of extendible hash bucket
+static constexpr int INDEX_MERGE_BATCH_SIZE = 16;                             // leaves merged per background pass
+static constexpr int HASH_TABLE_MIGRATE_BATCH_SIZE = 64;                      // slots rehashed per write in a resize
+static constexpr int INDEX_BUILD_BATCH_SIZE = 4096;                           // rows loaded at once by an index build
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
@@ -93,4 +93,32 @@ class ReaderWriterLatch {
   bool writer_entered_{false};
 };
 
+/**
+ * Holds the read latch of a ReaderWriterLatch while in scope.
+ */
+class ReadLatchGuard {
+ public:
+  explicit ReadLatchGuard(ReaderWriterLatch *latch) : latch_(latch) { latch_->RLock(); }
+  ~ReadLatchGuard() { latch_->RUnlock(); }
+
+  DISALLOW_COPY(ReadLatchGuard);
+
+ private:
+  ReaderWriterLatch *latch_;
+};
+
+/**
+ * Holds the write latch of a ReaderWriterLatch while in scope.
+ */
+class WriteLatchGuard {
+ public:
+  explicit WriteLatchGuard(ReaderWriterLatch *latch) : latch_(latch) { latch_->WLock(); }
+  ~WriteLatchGuard() { latch_->WUnlock(); }
+
+  DISALLOW_COPY(WriteLatchGuard);
+
+ private:
+  ReaderWriterLatch *latch_;
+};
+
 }  // namespace bustub
@@ -0,0 +1,100 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arena.h
+//
+// Identification: src/include/common/util/arena.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * Arena is a bump allocator for many small allocations that all die together,
+ * such as the keys of an operator's hash table. Memory is handed out from
+ * large chunks and is only given back by Reset or when the arena is destroyed.
+ */
+class Arena {
+ public:
+  static constexpr size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+  /** @param chunk_size size of the chunks that allocations are cut from */
+  explicit Arena(size_t chunk_size = DEFAULT_CHUNK_SIZE) : chunk_size_(chunk_size) {}
+
+  DISALLOW_COPY(Arena);
+
+  /**
+   * @param size number of bytes
+   * @param alignment alignment of the returned memory, a power of two
+   * @return memory that stays valid until Reset or the arena is destroyed
+   */
+  char *Allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+    auto cursor = reinterpret_cast<uintptr_t>(cursor_);
+    size_t padding = (alignment - (cursor & (alignment - 1))) & (alignment - 1);
+    if (cursor_ == nullptr || padding + size > static_cast<size_t>(end_ - cursor_)) {
+      // large allocations get a chunk of their own and leave the current chunk alone
+      if (size + alignment > chunk_size_ / 4) {
+        chunks_.emplace_back(new char[size + alignment]);
+        allocated_bytes_ += size + alignment;
+        auto start = reinterpret_cast<uintptr_t>(chunks_.back().get());
+        return chunks_.back().get() + ((alignment - (start & (alignment - 1))) & (alignment - 1));
+      }
+      NewChunk();
+      cursor = reinterpret_cast<uintptr_t>(cursor_);
+      padding = (alignment - (cursor & (alignment - 1))) & (alignment - 1);
+    }
+    char *result = cursor_ + padding;
+    cursor_ = result + size;
+    return result;
+  }
+
+  /** @return a copy of the bytes in the arena */
+  const char *Copy(const void *data, size_t size) {
+    char *copy = Allocate(size, 1);
+    if (size > 0) {
+      memcpy(copy, data, size);
+    }
+    return copy;
+  }
+
+  /** Frees everything allocated so far. */
+  void Reset() {
+    chunks_.clear();
+    cursor_ = nullptr;
+    end_ = nullptr;
+    allocated_bytes_ = 0;
+  }
+
+  /** @return bytes taken from the system, including the unused ends of chunks */
+  size_t GetAllocatedBytes() const { return allocated_bytes_; }
+
+ private:
+  void NewChunk() {
+    chunks_.emplace_back(new char[chunk_size_]);
+    allocated_bytes_ += chunk_size_;
+    cursor_ = chunks_.back().get();
+    end_ = cursor_ + chunk_size_;
+  }
+
+  size_t chunk_size_;
+  std::vector<std::unique_ptr<char[]>> chunks_;
+  char *cursor_{nullptr};
+  char *end_{nullptr};
+  size_t allocated_bytes_{0};
+};
+
+}  // namespace bustub
@@ -18,6 +18,7 @@
 #include <string>
 
 #include "common/macros.h"
+#include "common/util/hashers.h"
 #include "type/value.h"
 
 namespace bustub {
@@ -29,14 +30,7 @@ class HashUtil {
   static const hash_t prime_factor = 10000019;
 
  public:
-  static inline hash_t HashBytes(const char *bytes, size_t length) {
-    // https://github.com/greenplum-db/gpos/blob/b53c1acd6285de94044ff91fbee91589543feba1/libgpos/src/utils.cpp#L126
-    hash_t hash = length;
-    for (size_t i = 0; i < length; ++i) {
-      hash = ((hash << 5) ^ (hash >> 27)) ^ bytes[i];
-    }
-    return hash;
-  }
+  static inline hash_t HashBytes(const char *bytes, size_t length) { return XxHash3Hasher::Hash(bytes, length); }
 
   static inline hash_t CombineHashes(hash_t l, hash_t r) {
     hash_t both[2];
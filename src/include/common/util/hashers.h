@@ -0,0 +1,211 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hashers.h
+//
+// Identification: src/include/common/util/hashers.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#endif
+
+#include "common/macros.h"
+#include "murmur3/MurmurHash3.h"
+
+namespace bustub {
+
+/**
+ * Hashers turn the bytes of a key into 64 bits. Every hasher has a
+ * static uint64_t Hash(const void *data, size_t length), and mixes the input
+ * into all 64 bits: hash tables pick buckets with the low bits and tag slots
+ * with the top byte.
+ */
+class HashMixer {
+ public:
+  static inline uint64_t Read64(const void *p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+  }
+
+  static inline uint32_t Read32(const void *p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+  }
+
+  /** 64 x 64 bit multiply with the high and the low half of the product folded together */
+  static inline uint64_t MulFold64(uint64_t a, uint64_t b) {
+    __uint128_t product = static_cast<__uint128_t>(a) * b;
+    return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+  }
+
+  /** The finalizer of MurmurHash3, every input bit flips every output bit with probability 1/2 */
+  static inline uint64_t Fmix64(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ULL;
+    h ^= h >> 33;
+    return h;
+  }
+
+  static constexpr uint64_t PRIME64_1 = 0x9E3779B185EBCA87ULL;
+  static constexpr uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+  static constexpr uint64_t PRIME64_3 = 0x165667B19E3779F9ULL;
+  static constexpr uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+  static constexpr uint64_t PRIME64_5 = 0x27D4EB2F165667C5ULL;
+};
+
+/** 128-bit MurmurHash3, of which the first 64 bits are kept. Slow for short keys but well studied. */
+class MurmurHasher {
+ public:
+  static inline uint64_t Hash(const void *data, size_t length) {
+    uint64_t hash[2];
+    murmur3::MurmurHash3_x64_128(data, static_cast<int>(length), 0, reinterpret_cast<void *>(&hash));
+    return hash[0];
+  }
+};
+
+/**
+ * Multiply-shift hashing for keys of at most 8 bytes: one 64 x 64 bit
+ * multiply by an odd constant. Taking the folded 128-bit product instead of
+ * only its high half keeps the low bits as well mixed as the high ones.
+ */
+class MultiplyShiftHasher {
+ public:
+  static inline uint64_t Hash(const void *data, size_t length) {
+    BUSTUB_ASSERT(length <= sizeof(uint64_t), "multiply-shift hashing is for keys of at most 8 bytes");
+    uint64_t x = 0;
+    memcpy(&x, data, length);
+    return HashMixer::MulFold64(x ^ HashMixer::PRIME64_5, HashMixer::PRIME64_1);
+  }
+};
+
+/**
+ * CRC32C with the SSE4.2 crc32 instruction, 8 bytes per instruction, and a
+ * bitwise fallback where the instruction is not available. A CRC only has 32
+ * bits and is linear in its input, so the result is run through Fmix64.
+ */
+class Crc32cHasher {
+ public:
+  static inline uint64_t Hash(const void *data, size_t length) {
+    return HashMixer::Fmix64(Crc32c(data, length) ^ (static_cast<uint64_t>(length) << 32));
+  }
+
+  /** The plain CRC32C (Castagnoli) checksum of the bytes */
+  static inline uint32_t Crc32c(const void *data, size_t length) {
+    const auto *bytes = static_cast<const uint8_t *>(data);
+    uint32_t crc = ~0U;
+    size_t i = 0;
+#if defined(__SSE4_2__)
+    uint64_t crc64 = crc;
+    for (; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t)) {
+      crc64 = _mm_crc32_u64(crc64, HashMixer::Read64(bytes + i));
+    }
+    crc = static_cast<uint32_t>(crc64);
+    for (; i < length; i++) {
+      crc = _mm_crc32_u8(crc, bytes[i]);
+    }
+#else
+    for (; i < length; i++) {
+      crc ^= bytes[i];
+      for (int bit = 0; bit < 8; bit++) {
+        crc = (crc >> 1) ^ (0x82F63B78U & (0U - (crc & 1U)));
+      }
+    }
+#endif
+    return ~crc;
+  }
+
+  /** True if Hash runs on the crc32 instruction */
+  static constexpr bool IsHardwareAccelerated() {
+#if defined(__SSE4_2__)
+    return true;
+#else
+    return false;
+#endif
+  }
+};
+
+/**
+ * A hash in the style of xxHash3: 16 bytes at a time go through one folded
+ * multiply with a pair of secret words, inputs up to 16 bytes take a single
+ * folded multiply. Not bit-compatible with the reference xxHash3.
+ */
+class XxHash3Hasher {
+ public:
+  static inline uint64_t Hash(const void *data, size_t length) {
+    const auto *bytes = static_cast<const uint8_t *>(data);
+    uint64_t acc = length * HashMixer::PRIME64_1;
+    if (length > 16) {
+      // the last 16 bytes are mixed in separately, overlapping the blocks before them if needed
+      for (size_t i = 0; i + 16 < length; i += 16) {
+        const uint64_t *secret = SECRET + (i / 16 % 4) * 2;
+        acc += HashMixer::MulFold64(HashMixer::Read64(bytes + i) ^ secret[0],
+                                    HashMixer::Read64(bytes + i + 8) ^ secret[1]);
+      }
+      acc += HashMixer::MulFold64(HashMixer::Read64(bytes + length - 16) ^ SECRET[6],
+                                  HashMixer::Read64(bytes + length - 8) ^ SECRET[7]);
+      return Avalanche(acc);
+    }
+    if (length > 8) {
+      uint64_t low = HashMixer::Read64(bytes) ^ SECRET[0];
+      uint64_t high = HashMixer::Read64(bytes + length - 8) ^ SECRET[1];
+      return Avalanche(acc ^ HashMixer::MulFold64(low, high));
+    }
+    if (length >= 4) {
+      uint64_t combined =
+          HashMixer::Read32(bytes) | (static_cast<uint64_t>(HashMixer::Read32(bytes + length - 4)) << 32);
+      return Avalanche(acc ^ HashMixer::MulFold64(combined ^ SECRET[2], HashMixer::PRIME64_2));
+    }
+    if (length > 0) {
+      uint64_t combined = bytes[0] | (static_cast<uint64_t>(bytes[length / 2]) << 8) |
+                          (static_cast<uint64_t>(bytes[length - 1]) << 16);
+      return Avalanche(acc ^ HashMixer::MulFold64(combined ^ SECRET[3], HashMixer::PRIME64_3));
+    }
+    return Avalanche(acc ^ SECRET[4]);
+  }
+
+ private:
+  static inline uint64_t Avalanche(uint64_t h) {
+    h ^= h >> 37;
+    h *= HashMixer::PRIME64_3;
+    h ^= h >> 32;
+    return h;
+  }
+
+  static constexpr uint64_t SECRET[8] = {0xBE4BA423396CFEB8ULL, 0x1CAD21F72C81017CULL, 0xDB979083E96DD4DEULL,
+                                         0x1F67B3B7A4A44072ULL, 0x78E5C0CC4EE679CBULL, 0x2172FFCC7DD05A82ULL,
+                                         0x8E2443F7744608B8ULL, 0x4C263A81E69035E0ULL};
+};
+
+/**
+ * The hasher used for a key type unless another one is asked for: multiply-shift
+ * for integers, CRC32C for other keys when the crc32 instruction is available and
+ * the xxHash3-style hash otherwise. Key types may specialize it next to their
+ * definition, as GenericKey does for keys of up to 8 bytes.
+ */
+template <typename KeyType, typename Enable = void>
+struct DefaultHasher {
+  using type = std::conditional_t<Crc32cHasher::IsHardwareAccelerated(), Crc32cHasher, XxHash3Hasher>;
+};
+
+template <typename KeyType>
+struct DefaultHasher<KeyType, std::enable_if_t<std::is_integral_v<KeyType> && sizeof(KeyType) <= sizeof(uint64_t)>> {
+  using type = MultiplyShiftHasher;
+};
+
+}  // namespace bustub
@@ -0,0 +1,89 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// loser_tree.h
+//
+// Identification: src/include/common/util/loser_tree.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace bustub {
+
+/**
+ * LoserTree merges k sorted runs. It is a tournament tree over the heads of
+ * the runs: every inner node keeps the run that lost the match played there,
+ * and the root the overall winner, the run with the smallest head. After the
+ * winner's head is consumed, Replay plays only the matches on the path from
+ * the winner's leaf to the root: one comparison per level, where the sift
+ * down of a binary heap needs two.
+ *
+ * The runs are numbered 0 to k-1 and the tree only knows them through less.
+ */
+class LoserTree {
+ public:
+  /**
+   * Whether the head of run a goes before the head of run b. A run that has no
+   * head left goes after every run that has one. For a stable merge, equal heads
+   * are ordered by run number.
+   */
+  using Less = std::function<bool(size_t, size_t)>;
+
+  /**
+   * Plays the first tournament.
+   * @param num_runs the number of runs, at least 1
+   * @param less compares the heads of two runs
+   */
+  LoserTree(size_t num_runs, Less less) : num_runs_(num_runs), tree_(num_runs, NONE), less_(std::move(less)) {
+    // the leaves are nodes num_runs to 2 * num_runs - 1; the first run to reach an inner node waits there for its
+    // opponent, the second one plays it
+    for (size_t run = num_runs_; run-- > 0;) {
+      size_t winner = run;
+      size_t node = (run + num_runs_) / 2;
+      for (; node > 0; node /= 2) {
+        if (tree_[node] == NONE) {
+          tree_[node] = winner;
+          break;
+        }
+        if (less_(tree_[node], winner)) {
+          std::swap(tree_[node], winner);
+        }
+      }
+      if (node == 0) {
+        tree_[0] = winner;
+      }
+    }
+  }
+
+  /** @return the run with the smallest head */
+  size_t Winner() const { return tree_[0]; }
+
+  /** Finds the new winner after the head of the winner changed. */
+  void Replay() {
+    size_t winner = tree_[0];
+    for (size_t node = (winner + num_runs_) / 2; node > 0; node /= 2) {
+      if (less_(tree_[node], winner)) {
+        std::swap(tree_[node], winner);
+      }
+    }
+    tree_[0] = winner;
+  }
+
+ private:
+  static constexpr size_t NONE = static_cast<size_t>(-1);
+
+  size_t num_runs_;
+  std::vector<size_t> tree_;
+  Less less_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,142 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// thread_pool.h
+//
+// Identification: src/include/common/util/thread_pool.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>  // NOLINT
+#include <memory>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * ThreadPool runs tasks on a fixed set of threads, which are started once and
+ * reused by every query instead of being created per query.
+ *
+ * Tasks run in the order they are submitted. A task that blocks waiting for
+ * another task only makes progress if that task has a thread of its own, so
+ * callers submit tasks that wait for each other with one SubmitAll, and never
+ * more of them than GetNumThreads(). The tasks of one SubmitAll are queued
+ * together, so two queries submitting at the same time can not each get part
+ * of the threads and wait for the rest forever.
+ *
+ * A task that submits tasks of its own to the pool it runs on and waits for
+ * them holds a thread they may need, and can wait forever. Callers check
+ * IsPoolThread() and run the work on the calling thread instead.
+ */
+class ThreadPool {
+ public:
+  /** @param num_threads the number of threads, at least 1 */
+  explicit ThreadPool(size_t num_threads) {
+    BUSTUB_ASSERT(num_threads > 0, "a thread pool needs a thread");
+    for (size_t i = 0; i < num_threads; i++) {
+      threads_.emplace_back([this] { Work(); });
+    }
+  }
+
+  DISALLOW_COPY_AND_MOVE(ThreadPool);
+
+  /** Runs the tasks left, then stops the threads. */
+  ~ThreadPool() {
+    {
+      std::scoped_lock latch{latch_};
+      stopping_ = true;
+    }
+    not_empty_.notify_all();
+    for (auto &thread : threads_) {
+      thread.join();
+    }
+  }
+
+  /** @return the number of threads, the most tasks that run at the same time */
+  size_t GetNumThreads() const { return threads_.size(); }
+
+  /** @return whether the calling thread is one of the threads of this pool, running a task */
+  bool IsPoolThread() const { return current_pool == this; }
+
+  /**
+   * Queues a task.
+   * @param task the task to run on one of the threads
+   * @return a future that is ready when the task is done, and rethrows what the task threw
+   */
+  std::future<void> Submit(std::function<void()> task) {
+    auto packaged = std::make_shared<std::packaged_task<void()>>(std::move(task));
+    std::future<void> future = packaged->get_future();
+    {
+      std::scoped_lock latch{latch_};
+      tasks_.emplace_back([packaged] { (*packaged)(); });
+    }
+    not_empty_.notify_one();
+    return future;
+  }
+
+  /**
+   * Queues a batch of tasks next to each other, with no task of another caller in between.
+   * @param tasks the tasks to run, each on one of the threads
+   * @return a future per task, in the order of tasks
+   */
+  std::vector<std::future<void>> SubmitAll(std::vector<std::function<void()>> tasks) {
+    std::vector<std::future<void>> futures;
+    std::vector<std::function<void()>> wrapped;
+    for (auto &task : tasks) {
+      auto packaged = std::make_shared<std::packaged_task<void()>>(std::move(task));
+      futures.push_back(packaged->get_future());
+      wrapped.emplace_back([packaged] { (*packaged)(); });
+    }
+    {
+      std::scoped_lock latch{latch_};
+      for (auto &task : wrapped) {
+        tasks_.push_back(std::move(task));
+      }
+    }
+    not_empty_.notify_all();
+    return futures;
+  }
+
+ private:
+  void Work() {
+    current_pool = this;
+    while (true) {
+      std::function<void()> task;
+      {
+        std::unique_lock latch{latch_};
+        not_empty_.wait(latch, [this] { return stopping_ || !tasks_.empty(); });
+        if (tasks_.empty()) {
+          return;
+        }
+        task = std::move(tasks_.front());
+        tasks_.pop_front();
+      }
+      task();
+    }
+  }
+
+  // the pool whose thread this is, nullptr on other threads
+  static inline thread_local const ThreadPool *current_pool = nullptr;
+
+  std::mutex latch_;
+  std::condition_variable not_empty_;
+  std::deque<std::function<void()>> tasks_;
+  bool stopping_{false};
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace bustub
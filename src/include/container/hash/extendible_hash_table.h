@@ -0,0 +1,154 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_hash_table.h
+//
+// Identification: src/include/container/hash/extendible_hash_table.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "concurrency/transaction.h"
+#include "container/hash/hash_function.h"
+#include "container/hash/hash_table.h"
+#include "storage/page/hash_table_block_page.h"
+#include "storage/page/hash_table_directory_page.h"
+#include "storage/page/hash_table_page_defs.h"
+
+namespace bustub {
+
+#define EXTENDIBLE_HASH_TABLE_TYPE ExtendibleHashTable<KeyType, ValueType, KeyComparator>
+
+/**
+ * Implementation of extendible hash table that is backed by a buffer pool
+ * manager. Non-unique keys are supported. Supports insert and delete.
+ *
+ * A directory page maps the low global-depth bits of a key's hash to a
+ * bucket page. A full bucket is split in two by one more hash bit, doubling
+ * the directory only if the bucket already used all its bits; an emptied
+ * bucket is merged back into its split image. Growing therefore touches one
+ * bucket at a time instead of rehashing the whole table. A full bucket that
+ * is already at DIRECTORY_MAX_DEPTH continues on a chain of overflow pages,
+ * which are unlinked again once they empty.
+ *
+ * Bucket pages use the block page layout. Entries fill the lowest free slot,
+ * so the never-occupied slots of a bucket all come after the occupied ones.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class ExtendibleHashTable : public HashTable<KeyType, ValueType, KeyComparator> {
+ public:
+  /**
+   * Creates a new ExtendibleHashTable
+   *
+   * @param buffer_pool_manager buffer pool manager to be used
+   * @param comparator comparator for keys
+   * @param num_buckets number of entries the initial buckets should have room for
+   * @param hash_fn the hash function
+   */
+  explicit ExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
+                               const KeyComparator &comparator, size_t num_buckets, HashFunction<KeyType> hash_fn);
+
+  /**
+   * Inserts a key-value pair into the hash table.
+   * @param transaction the current transaction
+   * @param key the key to create
+   * @param value the value to be associated with the key
+   * @return true if insert succeeded, false otherwise
+   */
+  bool Insert(Transaction *transaction, const KeyType &key, const ValueType &value) override;
+
+  /**
+   * Deletes the associated value for the given key.
+   * @param transaction the current transaction
+   * @param key the key to delete
+   * @param value the value to delete
+   * @return true if remove succeeded, false otherwise
+   */
+  bool Remove(Transaction *transaction, const KeyType &key, const ValueType &value) override;
+
+  /**
+   * Performs a point query on the hash table.
+   * @param transaction the current transaction
+   * @param key the key to look up
+   * @param[out] result the value(s) associated with a given key
+   * @return the value(s) associated with the given key
+   */
+  bool GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) override;
+
+  /**
+   * @return the global depth of the directory
+   */
+  uint32_t GetGlobalDepth();
+
+  /**
+   * Asserts that the directory is consistent: every bucket of local depth d
+   * is referenced by exactly 2^(global depth - d) slots.
+   */
+  void VerifyIntegrity();
+
+ private:
+  // the directory indexes with the low bits of the hash, block pages tag slots with its top byte
+  uint64_t Hash(const KeyType &key) { return hash_fn_.GetHash(key); }
+
+  uint32_t DirectoryIndex(HashTableDirectoryPage *dir, uint64_t hash) {
+    return static_cast<uint32_t>(hash) & dir->GetGlobalDepthMask();
+  }
+
+  // call visit on the readable slots of the bucket whose tag matches, until it returns true. Returns true
+  // if visit stopped the scan.
+  template <typename SlotVisitor>
+  bool ScanBucket(HASH_TABLE_BLOCK_TYPE *bucket, uint8_t tag, SlotVisitor visit);
+
+  // fetch a page of the table, throws if the buffer pool is out of frames
+  Page *FetchPage(page_id_t page_id);
+
+  // allocate an empty bucket page, the returned page is pinned
+  Page *NewBucket(page_id_t *bucket_page_id);
+
+  // call visit on the first page of a bucket and then on its overflow pages, until it returns true. Returns
+  // true if visit stopped, the overflow page it stopped on is unpinned dirty if modify is set.
+  template <typename PageVisitor>
+  bool VisitChain(HASH_TABLE_BLOCK_TYPE *bucket, bool modify, PageVisitor visit);
+
+  // insert into the lowest free slot of the bucket's pages unless the pair is there. Returns false on a
+  // duplicate or if every page is full, *full tells the two apart.
+  bool InsertIntoBucket(HASH_TABLE_BLOCK_TYPE *bucket, const KeyType &key, const ValueType &value, uint64_t hash,
+                        bool *full);
+
+  // chain a new overflow page holding the pair to a bucket whose pages are all full
+  bool AppendOverflowPage(HASH_TABLE_BLOCK_TYPE *bucket, const KeyType &key, const ValueType &value, uint64_t hash);
+
+  // unlink and delete the overflow pages of the bucket that no longer hold an entry
+  void PruneChain(HASH_TABLE_BLOCK_TYPE *bucket);
+
+  // true if no slot of the page holds an entry
+  bool IsEmptyBucket(HASH_TABLE_BLOCK_TYPE *bucket);
+
+  // split the bucket of key until the pair fits, then insert it, requires the table latch in write mode
+  bool SplitInsert(const KeyType &key, const ValueType &value);
+
+  // fold the bucket of key and its split image together while one of them is empty, requires the table
+  // latch in write mode
+  void Merge(const KeyType &key);
+
+  // member variable
+  page_id_t directory_page_id_;
+  BufferPoolManager *buffer_pool_manager_;
+  KeyComparator comparator_;
+
+  // Readers are inserts, removes and lookups that stay in one bucket, writers split and merge buckets
+  ReaderWriterLatch table_latch_;
+
+  // Hash function
+  HashFunction<KeyType> hash_fn_;
+};
+
+}  // namespace bustub
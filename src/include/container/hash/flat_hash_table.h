@@ -0,0 +1,260 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// flat_hash_table.h
+//
+// Identification: src/include/container/hash/flat_hash_table.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "common/macros.h"
+#include "common/util/arena.h"
+#include "common/util/hashers.h"
+
+namespace bustub {
+
+/**
+ * FlatHashTable is an in-memory open addressing hash table for the transient
+ * state of an operator, such as the build side of a hash join or the groups
+ * of an aggregation. Nothing goes through the buffer pool and there is no
+ * latching, an operator owns its table.
+ *
+ * Keys are byte strings of any length, which the operator builds from the key
+ * columns of a tuple. They are copied into an arena. Entries are kept in one
+ * vector in insertion order, each with the full hash of its key, so growing
+ * the table never hashes a key again and iterating it is a sequential scan.
+ *
+ * The slots only hold the index of an entry and have a one byte control word
+ * each: EMPTY, or 7 bits of the hash of the key. A probe compares the control
+ * words of GROUP_SIZE slots at once with SSE2 and only looks at the entries
+ * whose bits match. Groups are probed quadratically.
+ *
+ * The table supports several entries per key (Insert) as well as unique keys
+ * (FindOrInsert). Entries are never removed one by one, only all at once by
+ * Clear. References to values stay valid until the next insert.
+ */
+template <typename ValueType, typename Hasher = DefaultHasher<std::string_view>::type>
+class FlatHashTable {
+ public:
+  static constexpr size_t GROUP_SIZE = 16;
+
+  struct Entry {
+    uint64_t hash_;
+    const char *key_;
+    uint32_t key_size_;
+    ValueType value_;
+
+    std::string_view Key() const { return {key_, key_size_}; }
+  };
+
+  /** @param expected_entries number of entries to make room for up front */
+  explicit FlatHashTable(size_t expected_entries = 0) { Reserve(expected_entries); }
+
+  DISALLOW_COPY(FlatHashTable);
+
+  /** @return the hash of a key, for callers that want to hash once and pass it to several calls */
+  static uint64_t Hash(std::string_view key) { return Hasher::Hash(key.data(), key.size()); }
+
+  /**
+   * Adds an entry, even if the key is in the table already.
+   * @return the value of the new entry
+   */
+  ValueType &Insert(std::string_view key, uint64_t hash, ValueType value) {
+    GrowIfFull();
+    size_t slot = FindEmptySlot(hash);
+    return Emplace(slot, key, hash, std::move(value));
+  }
+
+  ValueType &Insert(std::string_view key, ValueType value) { return Insert(key, Hash(key), std::move(value)); }
+
+  /**
+   * Looks up a key and adds it with make_value() as its value if it is not found.
+   * @return the value of the key and whether it was added
+   */
+  template <typename MakeValue>
+  std::pair<ValueType *, bool> FindOrInsert(std::string_view key, uint64_t hash, MakeValue make_value) {
+    GrowIfFull();
+    // no entry is ever removed, so the first empty slot of the probe is behind every entry of the key
+    uint8_t tag = TagOf(hash);
+    for (size_t group = GroupOf(hash), step = 1;; group = (group + step++) & (num_groups_ - 1)) {
+      const uint8_t *ctrl = &ctrl_[group * GROUP_SIZE];
+      for (uint32_t match = MatchByte(ctrl, tag); match != 0; match &= match - 1) {
+        Entry &entry = entries_[slots_[group * GROUP_SIZE + __builtin_ctz(match)]];
+        if (IsEqual(entry, key, hash)) {
+          return {&entry.value_, false};
+        }
+      }
+      uint32_t empty = MatchByte(ctrl, EMPTY);
+      if (empty != 0) {
+        return {&Emplace(group * GROUP_SIZE + __builtin_ctz(empty), key, hash, make_value()), true};
+      }
+    }
+  }
+
+  template <typename MakeValue>
+  std::pair<ValueType *, bool> FindOrInsert(std::string_view key, MakeValue make_value) {
+    return FindOrInsert(key, Hash(key), std::move(make_value));
+  }
+
+  /** @return the value of the first entry of a key, nullptr if there is none */
+  ValueType *Find(std::string_view key, uint64_t hash) {
+    ValueType *found = nullptr;
+    Probe(key, hash, [&found](Entry *entry) {
+      found = &entry->value_;
+      return false;
+    });
+    return found;
+  }
+
+  ValueType *Find(std::string_view key) { return Find(key, Hash(key)); }
+
+  /** Calls visit(value) for every entry of a key. */
+  template <typename Visit>
+  void ForEachMatch(std::string_view key, uint64_t hash, Visit visit) {
+    Probe(key, hash, [&visit](Entry *entry) {
+      visit(entry->value_);
+      return true;
+    });
+  }
+
+  /** Makes room for num_entries entries without growing. */
+  void Reserve(size_t num_entries) {
+    entries_.reserve(num_entries);
+    size_t num_groups = 1;
+    while (num_groups * GROUP_SIZE * MAX_LOAD_NUMERATOR < num_entries * MAX_LOAD_DENOMINATOR) {
+      num_groups *= 2;
+    }
+    if (num_groups > num_groups_) {
+      Rehash(num_groups);
+    }
+  }
+
+  /** Removes all entries and frees their keys, the slots are kept. */
+  void Clear() {
+    entries_.clear();
+    arena_.Reset();
+    memset(ctrl_.get(), EMPTY, num_groups_ * GROUP_SIZE);
+  }
+
+  /** @return the number of entries */
+  size_t Size() const { return entries_.size(); }
+
+  bool Empty() const { return entries_.empty(); }
+
+  /** @return the number of slots */
+  size_t Capacity() const { return num_groups_ * GROUP_SIZE; }
+
+  /** The entries in insertion order. */
+  typename std::vector<Entry>::iterator begin() { return entries_.begin(); }
+  typename std::vector<Entry>::iterator end() { return entries_.end(); }
+  typename std::vector<Entry>::const_iterator begin() const { return entries_.begin(); }
+  typename std::vector<Entry>::const_iterator end() const { return entries_.end(); }
+
+ private:
+  static constexpr uint8_t EMPTY = 0x80;
+  // at most 7 / 8 of the slots are used, every probe ends at an empty slot
+  static constexpr size_t MAX_LOAD_NUMERATOR = 7;
+  static constexpr size_t MAX_LOAD_DENOMINATOR = 8;
+
+  // the top 7 bits of the hash, the low bits pick the group
+  static uint8_t TagOf(uint64_t hash) { return static_cast<uint8_t>(hash >> 57); }
+
+  size_t GroupOf(uint64_t hash) const { return static_cast<size_t>(hash) & (num_groups_ - 1); }
+
+  // a mask with bit i set if control word i of the group equals byte
+  static uint32_t MatchByte(const uint8_t *ctrl, uint8_t byte) {
+#if defined(__SSE2__)
+    __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ctrl));
+    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(static_cast<char>(byte)))));
+#else
+    uint32_t mask = 0;
+    for (size_t i = 0; i < GROUP_SIZE; i++) {
+      mask |= static_cast<uint32_t>(ctrl[i] == byte) << i;
+    }
+    return mask;
+#endif
+  }
+
+  static bool IsEqual(const Entry &entry, std::string_view key, uint64_t hash) {
+    return entry.hash_ == hash && entry.key_size_ == key.size() && memcmp(entry.key_, key.data(), key.size()) == 0;
+  }
+
+  // calls visit(entry) for the entries of a key until it returns false
+  template <typename Visit>
+  void Probe(std::string_view key, uint64_t hash, Visit visit) {
+    uint8_t tag = TagOf(hash);
+    for (size_t group = GroupOf(hash), step = 1;; group = (group + step++) & (num_groups_ - 1)) {
+      const uint8_t *ctrl = &ctrl_[group * GROUP_SIZE];
+      for (uint32_t match = MatchByte(ctrl, tag); match != 0; match &= match - 1) {
+        Entry &entry = entries_[slots_[group * GROUP_SIZE + __builtin_ctz(match)]];
+        if (IsEqual(entry, key, hash) && !visit(&entry)) {
+          return;
+        }
+      }
+      if (MatchByte(ctrl, EMPTY) != 0) {
+        return;
+      }
+    }
+  }
+
+  size_t FindEmptySlot(uint64_t hash) const {
+    for (size_t group = GroupOf(hash), step = 1;; group = (group + step++) & (num_groups_ - 1)) {
+      uint32_t empty = MatchByte(&ctrl_[group * GROUP_SIZE], EMPTY);
+      if (empty != 0) {
+        return group * GROUP_SIZE + __builtin_ctz(empty);
+      }
+    }
+  }
+
+  ValueType &Emplace(size_t slot, std::string_view key, uint64_t hash, ValueType value) {
+    BUSTUB_ASSERT(entries_.size() < UINT32_MAX, "too many entries for a flat hash table");
+    ctrl_[slot] = TagOf(hash);
+    slots_[slot] = static_cast<uint32_t>(entries_.size());
+    const char *copy = arena_.Copy(key.data(), key.size());
+    entries_.push_back(Entry{hash, copy, static_cast<uint32_t>(key.size()), std::move(value)});
+    return entries_.back().value_;
+  }
+
+  void GrowIfFull() {
+    if ((entries_.size() + 1) * MAX_LOAD_DENOMINATOR > Capacity() * MAX_LOAD_NUMERATOR) {
+      Rehash(num_groups_ == 0 ? 1 : 2 * num_groups_);
+    }
+  }
+
+  // place the entries in num_groups groups by their stored hashes
+  void Rehash(size_t num_groups) {
+    num_groups_ = num_groups;
+    ctrl_.reset(new uint8_t[num_groups * GROUP_SIZE]);
+    slots_.reset(new uint32_t[num_groups * GROUP_SIZE]);
+    memset(ctrl_.get(), EMPTY, num_groups * GROUP_SIZE);
+    for (size_t i = 0; i < entries_.size(); i++) {
+      size_t slot = FindEmptySlot(entries_[i].hash_);
+      ctrl_[slot] = TagOf(entries_[i].hash_);
+      slots_[slot] = static_cast<uint32_t>(i);
+    }
+  }
+
+  size_t num_groups_{0};
+  std::unique_ptr<uint8_t[]> ctrl_;
+  std::unique_ptr<uint32_t[]> slots_;
+  std::vector<Entry> entries_;
+  Arena arena_;
+};
+
+}  // namespace bustub
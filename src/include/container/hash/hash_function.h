@@ -14,23 +14,22 @@
 
 #include <cstdint>
 
-#include "murmur3/MurmurHash3.h"
+#include "common/util/hashers.h"
 
 namespace bustub {
 
-template <typename KeyType>
+/**
+ * Hashes keys for the hash tables. The hasher is picked at compile time,
+ * by default from the key type (see DefaultHasher).
+ */
+template <typename KeyType, typename Hasher = typename DefaultHasher<KeyType>::type>
 class HashFunction {
  public:
   /**
    * @param key the key to be hashed
    * @return the hashed value
    */
-  virtual uint64_t GetHash(KeyType key) {
-    uint64_t hash[2];
-    murmur3::MurmurHash3_x64_128(reinterpret_cast<const void *>(&key), static_cast<int>(sizeof(KeyType)), 0,
-                                 reinterpret_cast<void *>(&hash));
-    return hash[0];
-  }
+  virtual uint64_t GetHash(KeyType key) { return Hasher::Hash(reinterpret_cast<const void *>(&key), sizeof(KeyType)); }
 };
 
 }  // namespace bustub
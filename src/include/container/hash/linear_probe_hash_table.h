@@ -12,11 +12,14 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <queue>
 #include <string>
 #include <vector>
 
 #include "buffer/buffer_pool_manager.h"
+#include "common/rwlatch.h"
 #include "concurrency/transaction.h"
 #include "container/hash/hash_function.h"
 #include "container/hash/hash_table.h"
@@ -31,7 +34,23 @@ namespace bustub {
 /**
  * Implementation of linear probing hash table that is backed by a buffer pool
  * manager. Non-unique keys are supported. Supports insert and delete. The
- * table dynamically grows once full.
+ * table dynamically grows once it is MAX_LOAD_FACTOR full, up to
+ * MAX_NUM_BUCKETS slots. A table of that size takes entries until every slot
+ * is used, then Insert returns false.
+ *
+ * Growing is incremental: a resize allocates a new generation of block pages
+ * and every later write moves HASH_TABLE_MIGRATE_BATCH_SIZE slots of the old
+ * generation into it. Until the old generation is drained, inserts go to the
+ * new generation and lookups and removes probe both. A resize asked for
+ * meanwhile starts once the old generation is drained. Removes leave
+ * tombstones behind, which later inserts on the same probe sequence reuse;
+ * once they take MAX_TOMBSTONE_FRACTION of the slots, the table is compacted
+ * the same way, into a new generation of the same size.
+ *
+ * Lookups take no latch. They probe a snapshot of the generations, which
+ * keeps their pages alive, and read the slots through the atomic occupied and
+ * readable bits of the block pages. Writers latch the block pages they
+ * modify. A probe pins and latches each block page once per run of slots.
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class LinearProbeHashTable : public HashTable<KeyType, ValueType, KeyComparator> {
@@ -52,7 +71,7 @@ class LinearProbeHashTable : public HashTable<KeyType, ValueType, KeyComparator>
    * @param transaction the current transaction
    * @param key the key to create
    * @param value the value to be associated with the key
-   * @return true if insert succeeded, false otherwise
+   * @return true if insert succeeded, false if the pair is there already or the table is full at MAX_NUM_BUCKETS
    */
   bool Insert(Transaction *transaction, const KeyType &key, const ValueType &value) override;
 
@@ -75,32 +94,170 @@ class LinearProbeHashTable : public HashTable<KeyType, ValueType, KeyComparator>
   bool GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) override;
 
   /**
-   * Resizes the table to at least twice the initial size provided.
+   * Loads a batch of distinct pairs, e.g. the entries of an index built over
+   * an existing table. An empty table is sized for the batch up front. If the
+   * batch fits in the table without a resize, every block page is filled in
+   * one pass, on up to num_threads threads. Otherwise the pairs are inserted
+   * one by one. Pairs already in the table are skipped, as Insert does. Throws
+   * OUT_OF_RANGE if an empty table would have to hold more than
+   * MAX_LOAD_FACTOR of MAX_NUM_BUCKETS pairs.
+   * @param entries the pairs to load, no pair may appear twice
+   * @param num_threads number of threads filling block pages
+   * @param[out] loaded if not nullptr, set to whether each pair was inserted
+   */
+  void BulkLoad(const std::vector<MappingType> &entries, size_t num_threads = 1, std::vector<bool> *loaded = nullptr);
+
+  /**
+   * Sizes an empty table for num_entries pairs, so that they can be bulk loaded
+   * in several batches without a resize. Does nothing to a table that is not
+   * empty. Throws OUT_OF_RANGE if num_entries is more than MAX_LOAD_FACTOR of
+   * MAX_NUM_BUCKETS.
+   * @param num_entries the number of pairs about to be loaded
+   */
+  void Reserve(size_t num_entries);
+
+  /**
+   * Resizes the table to twice the initial size provided, or MAX_NUM_BUCKETS
+   * if that is smaller. The new slots are allocated right away, the entries
+   * are moved by later writes. During another resize, this one starts once
+   * the other has moved its entries.
    * @param initial_size the initial size of the hash table
    */
   void Resize(size_t initial_size);
 
+  /**
+   * Rebuilds the table at its current size without its tombstones. Like a
+   * resize, the rebuild allocates the new slots right away and the entries
+   * are moved by later writes or by ResizeStep.
+   */
+  void Compact();
+
+  /**
+   * Moves a batch of entries of a resize or a compaction in progress, for
+   * callers that want to finish one without waiting for writes.
+   * @param num_slots number of old slots to move
+   * @return true while entries are still left to move
+   */
+  bool ResizeStep(size_t num_slots = HASH_TABLE_MIGRATE_BATCH_SIZE);
+
   /**
    * Gets the size of the hash table
    * @return current size of the hash table
    */
   size_t GetSize();
 
-  slot_offset_t GetSlotIndex(const KeyType &key);
-
   /**
-   * Access header page & block pages of the hashtable
+   * @return true while entries are still being moved to the new slots of a resize
    */
-  
+  bool IsResizing() const { return LoadGenerations()->old_ != nullptr; }
+
+  /** Fraction of occupied slots (tombstones included) that starts a resize. */
+  static constexpr double MAX_LOAD_FACTOR = 0.75;
+
+  /** Fraction of slots holding tombstones that starts a compaction. */
+  static constexpr double MAX_TOMBSTONE_FRACTION = 0.25;
+
+  /** Most slots a generation can have, limited by the block page ids that fit in its header page. */
+  static constexpr size_t MAX_NUM_BUCKETS =
+      (PAGE_SIZE - sizeof(HashTableHeaderPage)) / sizeof(page_id_t) * BLOCK_ARRAY_SIZE;
 
  private:
-  void appendBuckets(HashTableHeaderPage *header_page, size_t num_buckets);
+  /**
+   * The pages of one generation of slots. The header page never changes once
+   * the generation is built, so its contents are kept here and probes do not
+   * fetch it.
+   */
+  struct Generation {
+    // allocate the header and block pages of a generation with num_buckets slots
+    Generation(BufferPoolManager *buffer_pool_manager, size_t num_buckets);
+    // free the pages if the generation was retired, which happens once the last probe holding it is done
+    ~Generation();
+
+    BufferPoolManager *buffer_pool_manager_;
+    page_id_t header_page_id_;
+    size_t num_buckets_;
+    std::vector<page_id_t> block_page_ids_;
+    // set once a resize has moved every entry out
+    std::atomic<bool> retired_{false};
+  };
+
+  /** The generations a probe looks at. Replaced as a whole so that readers see a consistent pair. */
+  struct Generations {
+    std::shared_ptr<Generation> current_;
+    // generation being drained by a resize, nullptr if none
+    std::shared_ptr<Generation> old_;
+  };
+
+  std::shared_ptr<const Generations> LoadGenerations() const { return std::atomic_load(&generations_); }
+
+  // fetch a page of the table, throws if the buffer pool is out of frames
+  Page *FetchPage(page_id_t page_id);
+
+  // visit the slots on the probe sequence of hash whose tag matches, and the never used slot that ends the
+  // sequence, until visit returns true. Block pages are write latched if exclusive. If claim_tombstone, the
+  // sequence ends at the first tombstone of the block page run holding the never used slot instead. Returns false
+  // if the whole generation was visited without the sequence ending.
+  template <typename SlotVisitor>
+  bool Probe(const Generation &generation, uint64_t hash, bool exclusive, SlotVisitor visit,
+             bool claim_tombstone = false);
+
+  // insert into the generation unless the pair is there, reusing a tombstone if one precedes the free slot.
+  // Returns false on a duplicate or if no slot is free, *full tells the two apart.
+  bool InsertInto(const Generation &generation, const KeyType &key, const ValueType &value, uint64_t hash,
+                  bool *full);
+
+  // leave a tombstone in place of the pair, counted in num_tombstones_ if count_tombstone
+  bool RemoveFrom(const Generation &generation, const KeyType &key, const ValueType &value, uint64_t hash,
+                  bool count_tombstone);
+
+  bool Contains(const Generation &generation, const KeyType &key, const ValueType &value, uint64_t hash);
+
+  // replace the generation of an empty table by a larger one sized for num_entries, requires the table latch in
+  // write mode
+  void Regenerate(size_t num_entries);
+
+  // place a batch of entries in the free slots of the generation, block by block, and clear (*loaded)[i] for the
+  // pairs that were there already. Requires the table latch in write mode.
+  void LoadInto(const Generation &generation, const std::vector<MappingType> &entries, size_t num_threads,
+                std::vector<bool> *loaded);
+
+  // place the entries whose home slot is in block block_index, sorted by home slot, after the entries carried
+  // over from the previous block. Entries that run off the end of the block are left in *carry.
+  void FillBlock(const Generation &generation, size_t block_index, const std::vector<MappingType> &entries,
+                 const std::vector<uint64_t> &hashes, std::vector<size_t> *block_entries, std::vector<size_t> *carry);
+
+  // size of the generation that replaces the current one when it fills up: twice the size up to MAX_NUM_BUCKETS, or
+  // the same size if most of the occupied slots are tombstones and dropping them makes enough room. 0 if neither
+  // helps, which leaves a table of MAX_NUM_BUCKETS slots to take entries until it is full.
+  size_t GrowthTarget(const Generation &current, bool full) const;
+
+  // start moving the entries to a new generation of num_buckets slots, or once the old generation is drained if a
+  // resize is in progress. Requires the table latch in write mode.
+  void BeginResize(size_t num_buckets);
+
+  // move up to num_slots slots of the old generation, requires the table latch in write mode
+  void MigrateSlots(size_t num_slots);
+
+  // move a batch of slots if a resize is in progress, called by writers before they do their own work
+  void MigrateStep();
+
   // member variable
-  page_id_t header_page_id_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
 
-  // Readers includes inserts and removes, writer is only resize
+  // Current generations, accessed with std::atomic_load and std::atomic_store only
+  std::shared_ptr<const Generations> generations_;
+  // Occupied slots of the current generation, tombstones included
+  std::atomic<size_t> num_occupied_{0};
+  // Tombstones of the current generation
+  std::atomic<size_t> num_tombstones_{0};
+  // Slots of the old generation before this one have been moved
+  size_t migrate_cursor_{0};
+  // Size of the resize to start once the old generation is drained, 0 if none
+  size_t pending_num_buckets_{0};
+
+  // Readers are inserts and removes, writers are resize, compaction and the migration steps. Lookups do not take
+  // it.
   ReaderWriterLatch table_latch_;
 
   // Hash function
@@ -12,26 +12,45 @@
 
 #pragma once
 
+#include <memory>
+#include <thread>  // NOLINT
 #include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/catalog.h"
+#include "common/util/thread_pool.h"
 #include "concurrency/transaction_manager.h"
 #include "execution/executor_context.h"
 #include "execution/executor_factory.h"
 #include "execution/plans/abstract_plan.h"
 #include "storage/table/tuple.h"
 namespace bustub {
+/**
+ * ExecutionEngine runs query plans. Gather exchanges in a plan run their
+ * workers on the threads of the engine, the rest of the plan runs on the
+ * calling thread.
+ */
 class ExecutionEngine {
  public:
-  ExecutionEngine(BufferPoolManager *bpm, TransactionManager *txn_mgr, Catalog *catalog)
-      : bpm_(bpm), txn_mgr_(txn_mgr), catalog_(catalog) {}
+  /**
+   * @param bpm the buffer pool manager
+   * @param txn_mgr the transaction manager
+   * @param catalog the catalog
+   * @param num_threads the number of threads that gather exchanges run on, plans run on one thread if it is 1
+   */
+  ExecutionEngine(BufferPoolManager *bpm, TransactionManager *txn_mgr, Catalog *catalog,
+                  size_t num_threads = std::thread::hardware_concurrency())
+      : bpm_(bpm),
+        txn_mgr_(txn_mgr),
+        catalog_(catalog),
+        thread_pool_(num_threads > 1 ? std::make_unique<ThreadPool>(num_threads) : nullptr) {}
 
   DISALLOW_COPY_AND_MOVE(ExecutionEngine);
 
   bool Execute(const AbstractPlanNode *plan, std::vector<Tuple> *result_set, Transaction *txn,
                ExecutorContext *exec_ctx) {
     // construct executor
+    exec_ctx->SetThreadPool(thread_pool_.get());
     auto executor = ExecutorFactory::CreateExecutor(exec_ctx, plan);
 
     // prepare
@@ -57,6 +76,7 @@ class ExecutionEngine {
   [[maybe_unused]] BufferPoolManager *bpm_;
   [[maybe_unused]] TransactionManager *txn_mgr_;
   [[maybe_unused]] Catalog *catalog_;
+  std::unique_ptr<ThreadPool> thread_pool_;
 };
 
 }  // namespace bustub
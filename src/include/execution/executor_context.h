@@ -17,7 +17,9 @@
 #include <vector>
 
 #include "catalog/catalog.h"
+#include "common/util/thread_pool.h"
 #include "concurrency/transaction.h"
+#include "execution/parallel_context.h"
 #include "storage/page/tmp_tuple_page.h"
 
 namespace bustub {
@@ -60,12 +62,37 @@ class ExecutorContext {
   /** @return the transaction manager */
   TransactionManager *GetTransactionManager() { return txn_mgr_; }
 
+  /** @return the threads that gather exchanges run their workers on, nullptr to run queries on one thread */
+  ThreadPool *GetThreadPool() { return thread_pool_; }
+
+  /** Sets the threads that gather exchanges run their workers on. */
+  void SetThreadPool(ThreadPool *thread_pool) { thread_pool_ = thread_pool; }
+
+  /** @return the state shared with the other workers of a gather exchange, nullptr outside of a gather */
+  ParallelContext *GetParallelContext() { return parallel_ctx_; }
+
+  /** @return the number of the worker of a gather exchange running with this context */
+  size_t GetWorkerId() const { return worker_id_; }
+
+  /**
+   * Makes this the context of a worker of a gather exchange.
+   * @param parallel_ctx the state shared by the workers
+   * @param worker_id the number of this worker, less than the number of workers
+   */
+  void SetParallelContext(ParallelContext *parallel_ctx, size_t worker_id) {
+    parallel_ctx_ = parallel_ctx;
+    worker_id_ = worker_id;
+  }
+
  private:
   Transaction *transaction_;
   Catalog *catalog_;
   BufferPoolManager *bpm_;
   TransactionManager *txn_mgr_;
   LockManager *lock_mgr_;
+  ThreadPool *thread_pool_{nullptr};
+  ParallelContext *parallel_ctx_{nullptr};
+  size_t worker_id_{0};
 };
 
 }  // namespace bustub
@@ -13,11 +13,20 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
+#include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/parallel_context.h"
 #include "execution/plans/abstract_plan.h"
 
 namespace bustub {
+/** The executors of a plan that one worker of a parallel executor runs, and their context. */
+struct WorkerExecutor {
+  std::unique_ptr<ExecutorContext> exec_ctx_;
+  std::unique_ptr<AbstractExecutor> executor_;
+};
+
 /**
  * ExecutorFactory creates executors for arbitrary plan nodes.
  */
@@ -30,5 +39,16 @@ class ExecutorFactory {
    * @return an executor for the given plan and context
    */
   static std::unique_ptr<AbstractExecutor> CreateExecutor(ExecutorContext *exec_ctx, const AbstractPlanNode *plan);
+
+  /**
+   * Creates the executors of a plan for every worker of a parallel executor. Each worker gets an executor context of
+   * its own, with the transaction, catalog and buffer pool of exec_ctx, that points to parallel_ctx.
+   * @param exec_ctx the executor context of the parallel executor
+   * @param parallel_ctx the state shared by the workers, which also gives their number
+   * @param plan the plan node that every worker runs
+   * @return the executors of the workers, by worker id
+   */
+  static std::vector<WorkerExecutor> CreateWorkerExecutors(ExecutorContext *exec_ctx, ParallelContext *parallel_ctx,
+                                                           const AbstractPlanNode *plan);
 };
 }  // namespace bustub
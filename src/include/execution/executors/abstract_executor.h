@@ -13,11 +13,17 @@
 #pragma once
 
 #include "execution/executor_context.h"
+#include "execution/tuple_batch.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 /**
  * AbstractExecutor implements the Volcano tuple-at-a-time iterator model.
+ *
+ * Executors can also produce a batch of tuples per call with NextBatch. By
+ * default NextBatch collects the tuples of Next, so every executor can be
+ * pulled either way; executors that can do better override it. A parent
+ * pulls its child with only one of Next and NextBatch.
  */
 class AbstractExecutor {
  public:
@@ -44,6 +50,21 @@ class AbstractExecutor {
    */
   virtual bool Next(Tuple *tuple, RID *rid) = 0;
 
+  /**
+   * Produces the next tuples from this executor.
+   * @param[out] batch emptied, then filled with up to its capacity tuples in the columns of GetOutputSchema()
+   * @return true if any tuple was produced, false if there are no more tuples
+   */
+  virtual bool NextBatch(TupleBatch *batch) {
+    batch->Reset(GetOutputSchema());
+    Tuple tuple;
+    RID rid;
+    while (!batch->IsFull() && Next(&tuple, &rid)) {
+      batch->Append(tuple, rid);
+    }
+    return !batch->IsEmpty();
+  }
+
   /** @return the schema of the tuples that this executor produces */
   virtual const Schema *GetOutputSchema() = 0;
 
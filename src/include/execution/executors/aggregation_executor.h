@@ -97,12 +97,17 @@ class SimpleAggregationHashTable {
    * @param agg_val the value to be inserted
    */
   void InsertCombine(const AggregateKey &agg_key, const AggregateValue &agg_val) {
-    if (ht.count(agg_key) == 0) {
-      ht.insert({agg_key, GenerateInitialAggregateValue()});
+    // one lookup for a group that exists, the hash is computed again only to add a group
+    auto iter = ht.find(agg_key);
+    if (iter == ht.end()) {
+      iter = ht.emplace(agg_key, GenerateInitialAggregateValue()).first;
     }
-    CombineAggregateValues(&ht[agg_key], agg_val);
+    CombineAggregateValues(&iter->second, agg_val);
   }
 
+  /** Removes all the groups. */
+  void Clear() { ht.clear(); }
+
   /**
    * An iterator through the simplified aggregation hash table.
    */
@@ -168,10 +173,13 @@ class AggregationExecutor : public AbstractExecutor {
 
   const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
 
+  /** Builds the groups, reading the child a batch at a time. */
   void Init() override;
 
   bool Next(Tuple *tuple, RID *rid) override;
 
+  bool NextBatch(TupleBatch *batch) override;
+
   /** @return the tuple as an AggregateKey */
   AggregateKey MakeKey(const Tuple *tuple) {
     std::vector<Value> keys;
@@ -191,13 +199,16 @@ class AggregationExecutor : public AbstractExecutor {
   }
 
  private:
+  // the output values of the next group that passes the having clause, false when there are no more
+  bool NextGroup(std::vector<Value> *values);
+
   /** The aggregation plan node. */
   const AggregationPlanNode *plan_;
   /** The child executor whose tuples we are aggregating. */
   std::unique_ptr<AbstractExecutor> child_;
   /** Simple aggregation hash table. */
-  // Uncomment me! SimpleAggregationHashTable aht_;
+  SimpleAggregationHashTable aht_;
   /** Simple aggregation hash table iterator. */
-  // Uncomment me! SimpleAggregationHashTable::Iterator aht_iterator_;
+  SimpleAggregationHashTable::Iterator aht_iterator_;
 };
 }  // namespace bustub
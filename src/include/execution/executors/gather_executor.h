@@ -0,0 +1,98 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// gather_executor.h
+//
+// Identification: src/include/execution/executors/gather_executor.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <exception>
+#include <future>  // NOLINT
+#include <memory>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executor_factory.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/parallel_context.h"
+#include "execution/plans/gather_plan.h"
+#include "execution/tuple_batch.h"
+
+namespace bustub {
+/**
+ * GatherExecutor runs its child plan on the threads of the thread pool of its
+ * context. Every worker builds its own executors for the child plan, with an
+ * executor context of its own that points to the state the workers share,
+ * and pulls them a batch at a time; the batches are queued for Next.
+ *
+ * The workers run at the same time, on their own threads, because the
+ * workers of a repartition exchange wait for each other: there are never more
+ * workers than threads. The contexts of the workers have no thread pool, so a
+ * gather below a gather runs on one thread. Without a thread pool, or when
+ * Init is called on a thread of the pool, the child runs on the calling
+ * thread.
+ */
+class GatherExecutor : public AbstractExecutor {
+ public:
+  /** Number of batches that the workers queue before they wait for Next. */
+  static constexpr size_t MAX_QUEUED_BATCHES_PER_WORKER = 2;
+
+  /**
+   * Creates a new gather executor.
+   * @param exec_ctx the executor context
+   * @param plan the gather plan to be executed
+   */
+  GatherExecutor(ExecutorContext *exec_ctx, const GatherPlanNode *plan);
+
+  /** Stops the workers. */
+  ~GatherExecutor() override;
+
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
+
+  /** Starts the workers. */
+  void Init() override;
+
+  bool Next(Tuple *tuple, RID *rid) override;
+
+  bool NextBatch(TupleBatch *batch) override;
+
+  /** @return the number of workers the child runs on */
+  size_t GetNumWorkers() const { return workers_.size(); }
+
+ private:
+  // run a worker to completion, queueing its batches
+  void RunWorker(size_t worker_id);
+  // cancel the workers and wait for them
+  void Stop();
+  // take the next queued batch, false when every worker is done
+  bool PopBatch(TupleBatch *batch);
+
+  /** The gather plan node to be executed. */
+  const GatherPlanNode *plan_;
+
+  std::unique_ptr<ParallelContext> parallel_ctx_;
+  std::vector<WorkerExecutor> workers_;
+  std::vector<std::future<void>> futures_;
+
+  /** The batches of the workers, the number of workers still running and the first error of a worker. */
+  std::mutex latch_;
+  std::condition_variable not_empty_;
+  std::condition_variable not_full_;
+  std::deque<TupleBatch> batches_;
+  size_t num_running_{0};
+  std::exception_ptr error_;
+
+  /** The batch Next returns tuples of. */
+  TupleBatch batch_;
+  uint32_t next_row_{0};
+};
+}  // namespace bustub
@@ -0,0 +1,138 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// grace_hash_join_executor.h
+//
+// Identification: src/include/execution/executors/grace_hash_join_executor.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "container/hash/flat_hash_table.h"
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/executors/hash_join_executor.h"
+#include "execution/plans/hash_join_plan.h"
+#include "execution/tuple_batch.h"
+#include "storage/table/tmp_tuple_file.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+/**
+ * GraceHashJoinExecutor executes an equi-join whose left side may not fit in
+ * its memory budget (a hybrid hash join).
+ *
+ * Both sides are split into NUM_PARTITIONS partitions by their key hashes.
+ * Init reads the left side into one in-memory hash table per partition; when
+ * the tables outgrow the budget, the largest partition is spilled: its tuples
+ * and every later left tuple of the partition are written to TmpTuplePages.
+ * Next streams the right side, probing the partitions still in memory and
+ * writing the right tuples of spilled partitions to TmpTuplePages as well.
+ * Then the spilled partitions are joined one after the other, reading as much
+ * of the left side of a partition as the budget allows at a time.
+ *
+ * A partition that is spilled holds a single pinned page per side while it is
+ * written, so the join never pins more than NUM_PARTITIONS pages.
+ */
+class GraceHashJoinExecutor : public AbstractExecutor {
+ public:
+  /** Number of partitions both sides are split into. */
+  static constexpr size_t NUM_PARTITIONS = 8;
+
+  /**
+   * Creates a new grace hash join executor.
+   * @param exec_ctx the executor context
+   * @param plan the hash join plan to be executed, with a memory budget
+   * @param left_executor the child executor whose tuples the hash tables are built on
+   * @param right_executor the child executor whose tuples probe the hash tables
+   */
+  GraceHashJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan,
+                        std::unique_ptr<AbstractExecutor> &&left_executor,
+                        std::unique_ptr<AbstractExecutor> &&right_executor);
+
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
+
+  /** Builds the hash tables on the left child, spilling partitions that do not fit. */
+  void Init() override;
+
+  bool Next(Tuple *tuple, RID *rid) override;
+
+  bool NextBatch(TupleBatch *batch) override;
+
+  /** @return the number of partitions written to temporary pages */
+  size_t GetNumSpilledPartitions() const { return num_spilled_; }
+
+ private:
+  static_assert((NUM_PARTITIONS & (NUM_PARTITIONS - 1)) == 0, "the partitions are picked by bits of the hash");
+
+  using JoinHashTable = FlatHashTable<uint32_t>;
+
+  /** One partition of both sides. */
+  struct Partition {
+    explicit Partition(BufferPoolManager *bpm) : build_file_(bpm), probe_file_(bpm) {}
+
+    bool spilled_{false};
+    /** The left tuples in memory, the hash table maps their keys to their index, and their bytes. */
+    std::vector<Tuple> tuples_;
+    std::unique_ptr<JoinHashTable> table_;
+    size_t bytes_{0};
+    /** The tuples of a spilled partition, left and right. */
+    TmpTupleFile build_file_;
+    TmpTupleFile probe_file_;
+  };
+
+  // bits 40 and up of the hash, the hash tables use the lowest and highest bits
+  size_t PartitionOf(uint64_t hash) const { return (hash >> 40) & (NUM_PARTITIONS - 1); }
+
+  // add the left tuple at row of batch to its partition, spilling partitions while over the budget
+  void AddBuildRow(Partition *partition, const TupleBatch &batch, uint32_t row);
+  // write the tuples of a partition to its build file, it keeps its later left tuples on disk
+  void Spill(Partition *partition);
+  // join the right tuple at row of probe_batch_ with the tuples in memory of a partition into results_
+  void ProbeRow(const Partition &partition, uint32_t row);
+
+  // read the tuples of a page of file into batch
+  void ReadPage(TmpTupleFile *file, size_t page_index, const Schema *schema, TupleBatch *batch);
+
+  // join the next right batch or spilled page into results_, false when the join is done
+  bool JoinNextResults();
+  // join the next right batch into results_, false when the right side is done
+  bool ProbeNextBatch();
+  // join the next page of the right side of a spilled partition into results_, false when all are joined
+  bool JoinNextSpilledPage();
+  // read the next left tuples of a spilled partition into its hash table, up to the budget
+  void LoadNextChunk(Partition *partition);
+
+  /** The hash join plan node to be executed. */
+  const HashJoinPlanNode *plan_;
+  std::unique_ptr<AbstractExecutor> left_executor_;
+  std::unique_ptr<AbstractExecutor> right_executor_;
+  size_t memory_budget_;
+  JoinKeyEncoder left_keys_;
+  JoinKeyEncoder right_keys_;
+
+  std::vector<Partition> partitions_;
+  size_t in_memory_bytes_{0};
+  size_t num_spilled_{0};
+
+  /** Whether the right side is still being read, then the spilled partition being joined and its next pages. */
+  bool probing_{true};
+  size_t spill_partition_{0};
+  size_t build_page_{0};
+  size_t probe_page_{0};
+
+  std::vector<Tuple> page_tuples_;
+  TupleBatch build_batch_;
+  TupleBatch probe_batch_;
+  /** The joined tuples of the current probe batch or page and the next one to return. */
+  TupleBatch results_;
+  uint32_t next_result_{0};
+};
+}  // namespace bustub
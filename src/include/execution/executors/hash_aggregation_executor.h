@@ -0,0 +1,196 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_aggregation_executor.h
+//
+// Identification: src/include/execution/executors/hash_aggregation_executor.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "container/hash/flat_hash_table.h"
+#include "execution/executor_context.h"
+#include "execution/executor_factory.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/expressions/abstract_expression.h"
+#include "execution/parallel_context.h"
+#include "execution/plans/aggregation_plan.h"
+#include "execution/tuple_batch.h"
+#include "storage/table/tmp_tuple_file.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+/**
+ * HashAggregationExecutor executes an aggregation whose aggregates are COUNTs
+ * or SUMs, MINs and MAXs of numbers, with accumulators specialized by type.
+ *
+ * The group-by values of a tuple are encoded into one normalized key (see
+ * SortExecutor::EncodeSortKey). The accumulators of a group are slots of a
+ * 64-bit integer or a double and a NULL flag, side by side in one vector, and
+ * a batch is folded into them one aggregate at a time, with the switch on the
+ * aggregate and its type outside of the loop over the rows.
+ *
+ * Init runs up to GetNumWorkers() workers on the thread pool of its context.
+ * Each worker reads a copy of the child, which a parallel scan splits among
+ * them, and pre-aggregates into tables of its own, split into NUM_PARTITIONS
+ * partitions by the key hash. When the groups of a worker outgrow its share of
+ * the memory budget, its largest partition is written to temporary pages as
+ * partial aggregates and emptied. Next merges partition p of every worker, and
+ * what they spilled of it, into one table once it gets to p, and frees the
+ * table before it merges partition p + 1. A child that is not split among the
+ * workers, such as a scan that is not parallel, is read by a single worker.
+ * Below a gather, the executor is a worker of the gather and aggregates its
+ * part of the child on its own thread.
+ *
+ * The NULLs of a group-by column all fall into one group, as in SQL. A NULL
+ * aggregated makes the SUM, MIN or MAX of its group NULL, as in
+ * AggregationExecutor, and COUNT counts every tuple.
+ */
+class HashAggregationExecutor : public AbstractExecutor {
+ public:
+  /** Number of partitions that the groups are split into, and merged by. */
+  static constexpr size_t NUM_PARTITIONS = 64;
+
+  /**
+   * Creates a new hash aggregation executor. Init creates the executors of the child plan, one per worker.
+   * @param exec_ctx the executor context
+   * @param plan the aggregation plan to be executed
+   */
+  HashAggregationExecutor(ExecutorContext *exec_ctx, const AggregationPlanNode *plan);
+
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
+
+  /** Reads the child into the groups of the workers, split into partitions. */
+  void Init() override;
+
+  bool Next(Tuple *tuple, RID *rid) override;
+
+  bool NextBatch(TupleBatch *batch) override;
+
+  /** @return the number of workers that read the child */
+  size_t GetNumWorkers() const { return executors_.size(); }
+
+  /** @return the number of times a partition was written to temporary pages */
+  size_t GetNumSpills() const { return num_spills_; }
+
+  /** @return whether this executor supports the aggregates of a plan */
+  static bool CanExecute(const AggregationPlanNode *plan);
+
+ private:
+  static_assert((NUM_PARTITIONS & (NUM_PARTITIONS - 1)) == 0, "the partitions are picked by bits of the hash");
+
+  /** How an aggregate folds its input into its accumulator. */
+  enum class Accumulate : uint8_t {
+    COUNT,
+    SUM_INTEGER,
+    SUM_DECIMAL,
+    MIN_INTEGER,
+    MIN_DECIMAL,
+    MAX_INTEGER,
+    MAX_DECIMAL,
+  };
+
+  /** The state of one aggregate of one group. */
+  struct Accumulator {
+    union {
+      int64_t integer_;
+      double decimal_;
+    };
+    bool null_;
+  };
+
+  /** The groups of a partition: the hash table maps their keys to their index. */
+  struct GroupTable {
+    explicit GroupTable(BufferPoolManager *bpm) : spill_file_(bpm) {}
+
+    FlatHashTable<uint32_t> index_;
+    std::vector<std::vector<Value>> group_bys_;
+    /** The accumulators of every aggregate of group 0, then of group 1, and so on. */
+    std::vector<Accumulator> accumulators_;
+    size_t bytes_{0};
+    /** The partial aggregates spilled, one tuple per group. */
+    TmpTupleFile spill_file_;
+  };
+
+  using Partitions = std::vector<std::unique_ptr<GroupTable>>;
+
+  /** The tables of a worker and the state of the batch it is adding. */
+  struct Worker {
+    Partitions partitions_;
+    size_t bytes_{0};
+    size_t num_spills_{0};
+    TupleBatch batch_;
+    BatchColumns key_columns_;
+    BatchColumns val_columns_;
+    std::string key_;
+    /** The table and the group of every row of the batch. */
+    std::vector<GroupTable *> row_tables_;
+    std::vector<uint32_t> row_groups_;
+  };
+
+  /** Bytes held for a group besides its key, values and accumulators: its entry and slot in the hash table. */
+  static constexpr size_t GROUP_OVERHEAD = sizeof(FlatHashTable<uint32_t>::Entry) + sizeof(uint32_t) + 1;
+
+  // bits 32 and up of the hash, the hash tables use the lowest bits and the highest ones
+  static size_t PartitionOf(uint64_t hash) { return (hash >> 32) & (NUM_PARTITIONS - 1); }
+
+  // run task(0) to task(num_tasks - 1) on the thread pool, or on this thread without one, rethrowing the first error
+  void RunTasks(size_t num_tasks, const std::function<void(size_t)> &task);
+
+  // read the copy of the child of a worker into its tables
+  void RunWorker(size_t worker_id);
+  // fold the tuples of the batch of a worker into its tables
+  void AddBatch(Worker *worker);
+  // find the group of a key, adding it with the group-by values given if it is new
+  uint32_t FindOrAddGroup(GroupTable *table, std::string_view key, uint64_t hash,
+                          const std::function<void(std::vector<Value> *)> &group_bys, size_t *bytes);
+  // fold column i of the aggregates of a batch into the accumulators of the groups of its rows
+  void Fold(size_t i, const std::vector<Value> &column, const std::vector<GroupTable *> &tables,
+            const std::vector<uint32_t> &groups) const;
+  // fold an accumulator of aggregate i into another one
+  void Combine(size_t i, Accumulator *into, const Accumulator &from) const;
+  // write the groups of a table to its spill file and empty it
+  void Spill(GroupTable *table);
+  // merge partition p of every worker into one table
+  std::unique_ptr<GroupTable> MergePartition(size_t partition);
+  // fold the groups of a table, or the groups it spilled, into another one
+  void MergeTable(GroupTable *into, GroupTable *from);
+  void MergeSpillFile(GroupTable *into, TmpTupleFile *file);
+
+  // the output values of the next group that passes the having clause, false when there are no more
+  bool NextGroup(std::vector<Value> *values);
+
+  // the accumulator of aggregate i as a Value of its result type
+  Value ResultOf(size_t i, const Accumulator &accumulator) const;
+
+  /** The aggregation plan node to be executed. */
+  const AggregationPlanNode *plan_;
+  /** How every aggregate is folded and the type of its result. */
+  std::vector<Accumulate> accumulates_;
+  std::vector<TypeId> result_types_;
+  /** The schema of the partial aggregates spilled: the group-by values, then the accumulators. */
+  std::unique_ptr<Schema> spill_schema_;
+
+  /** The state shared by the workers, nullptr below a gather. */
+  std::unique_ptr<ParallelContext> parallel_ctx_;
+  std::vector<WorkerExecutor> executors_;
+  std::vector<Worker> workers_;
+  size_t worker_budget_{0};
+  size_t num_spills_{0};
+
+  /** The merged groups of the partition Next is at, nullptr until it is merged, and the next group Next looks at. */
+  std::unique_ptr<GroupTable> partition_;
+  size_t next_partition_{0};
+  uint32_t next_group_{0};
+};
+}  // namespace bustub
@@ -0,0 +1,196 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_join_executor.h
+//
+// Identification: src/include/execution/executors/hash_join_executor.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "container/hash/flat_hash_table.h"
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/expressions/abstract_expression.h"
+#include "execution/plans/hash_join_plan.h"
+#include "execution/tuple_batch.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+/**
+ * JoinKeyEncoder evaluates the join keys of one side of a hash join over a
+ * batch, and encodes the keys of every row into bytes that are equal exactly
+ * when the keys are equal, so that they can be hashed and compared as bytes.
+ */
+class JoinKeyEncoder {
+ public:
+  /**
+   * @param key_exprs the key expressions of one side of the join
+   * @param key_types the type each key value is cast to first, see KeyTypes
+   */
+  JoinKeyEncoder(std::vector<const AbstractExpression *> key_exprs, std::vector<TypeId> key_types)
+      : key_exprs_(std::move(key_exprs)), key_types_(std::move(key_types)) {}
+
+  /** Encodes the keys of every row of a batch. */
+  void Encode(const TupleBatch &batch);
+
+  /** @return the rows of the batch whose keys have no NULL value, the others join nothing */
+  const std::vector<uint32_t> &GetRows() const { return rows_; }
+
+  std::string_view GetKey(uint32_t row) const {
+    return std::string_view(keys_).substr(key_offsets_[row], key_offsets_[row + 1] - key_offsets_[row]);
+  }
+
+  uint64_t GetHash(uint32_t row) const { return hashes_[row]; }
+  const std::vector<uint64_t> &GetHashes() const { return hashes_; }
+
+  /**
+   * Encodes the join key of a row.
+   * @param columns the values of every key expression
+   * @param row the row to encode
+   * @param key_types the type each key value is cast to first
+   * @param[out] key the encoded key
+   * @return false if the key has a NULL value, which equals no other key
+   */
+  static bool EncodeKey(const BatchColumns &columns, uint32_t row, const std::vector<TypeId> &key_types,
+                        std::string *key);
+
+  /** @return the type that a left key of type left and a right key of type right are compared in */
+  static TypeId KeyType(TypeId left, TypeId right);
+
+  /** @return the types that the keys of a hash join are compared in */
+  static std::vector<TypeId> KeyTypes(const HashJoinPlanNode *plan);
+
+  /** @return the hash of an encoded key */
+  static uint64_t Hash(std::string_view key) { return FlatHashTable<uint32_t>::Hash(key); }
+
+ private:
+  std::vector<const AbstractExpression *> key_exprs_;
+  std::vector<TypeId> key_types_;
+  BatchColumns key_columns_;
+  std::string keys_;
+  std::vector<size_t> key_offsets_;
+  std::vector<uint64_t> hashes_;
+  std::vector<uint32_t> rows_;
+};
+
+/**
+ * HashJoinExecutor executes an equi-join. Init reads the whole left child and
+ * builds an in-memory hash table on its join keys, then Next streams the right
+ * child a batch at a time and probes the table.
+ *
+ * When the left side is larger than the cache, the hash table is split into
+ * 2^k partitions by k bits of the key hashes (radix partitioning), each small
+ * enough to stay in the cache. The left tuples of a partition are stored back
+ * to back. The right side is read PROBE_BUFFER_BATCHES batches at a time into
+ * one buffer per partition, and the buffers probe their partition one after
+ * the other, so that every partition is in the cache for many rows at once.
+ */
+class HashJoinExecutor : public AbstractExecutor {
+ public:
+  /** Cache size used when the system does not report its L2 cache size. */
+  static constexpr size_t DEFAULT_CACHE_SIZE = 256 * 1024;
+  /** At most 2^MAX_PARTITION_BITS partitions, a pass over the rows writes to about as many pages as the TLB maps. */
+  static constexpr size_t MAX_PARTITION_BITS = 8;
+  /** Bytes held for a build tuple besides its data and key: the Tuple or offset, its entry and slot in the table. */
+  static constexpr size_t BUILD_TUPLE_OVERHEAD = sizeof(Tuple) + 48;
+  /** Number of right batches split into the probe buffers before they are probed, with more than one partition. */
+  static constexpr size_t PROBE_BUFFER_BATCHES = 64;
+
+  /**
+   * Creates a new hash join executor.
+   * @param exec_ctx the executor context
+   * @param plan the hash join plan to be executed
+   * @param left_executor the child executor whose tuples the hash table is built on
+   * @param right_executor the child executor whose tuples probe the hash table
+   * @param cache_size the size of one partition of the hash table in bytes
+   */
+  HashJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan,
+                   std::unique_ptr<AbstractExecutor> &&left_executor,
+                   std::unique_ptr<AbstractExecutor> &&right_executor, size_t cache_size = CacheSize());
+
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
+
+  /** Builds the hash table on the left child. */
+  void Init() override;
+
+  bool Next(Tuple *tuple, RID *rid) override;
+
+  bool NextBatch(TupleBatch *batch) override;
+
+  /** @return the number of partitions of the hash table, 1 if it fits in the cache */
+  size_t GetNumPartitions() const { return partitions_.size(); }
+
+  /** @return the L2 cache size of this machine */
+  static size_t CacheSize();
+
+  /** @return the number of radix bits that split build_bytes into partitions of at most cache_size bytes */
+  static size_t PartitionBits(size_t build_bytes, size_t cache_size);
+
+ private:
+  using JoinHashTable = FlatHashTable<uint32_t>;
+
+  /** One partition of the left side. */
+  struct Partition {
+    /** The bytes of the tuples back to back, tuple i from offsets_[i] to offsets_[i + 1]. */
+    std::vector<char> data_;
+    std::vector<size_t> offsets_;
+    /** Maps the keys of the tuples to their index. */
+    std::unique_ptr<JoinHashTable> table_;
+  };
+
+  /** A right row waiting in a probe buffer: where it is in probe_batches_ and its key. */
+  struct ProbeRow {
+    uint32_t batch_;
+    uint32_t row_;
+    uint64_t hash_;
+    size_t key_offset_;
+    uint32_t key_size_;
+  };
+
+  /** The right rows of one partition read since the last probe, and their keys back to back. */
+  struct ProbeBuffer {
+    std::vector<ProbeRow> rows_;
+    std::string keys_;
+  };
+
+  size_t PartitionOf(uint64_t hash) const { return (hash >> 32) & (partitions_.size() - 1); }
+
+  // read the next right batches into the probe buffers, false when the right side is done
+  bool FillProbeBuffers();
+  // join a buffered right row of partition p into results_
+  void Probe(size_t p, const ProbeRow &probe_row);
+  // probe the buffers into results_ until it holds a batch, false when the join is done
+  bool JoinNextResults();
+
+  /** The hash join plan node to be executed. */
+  const HashJoinPlanNode *plan_;
+  std::unique_ptr<AbstractExecutor> left_executor_;
+  std::unique_ptr<AbstractExecutor> right_executor_;
+  size_t cache_size_;
+  JoinKeyEncoder left_keys_;
+  JoinKeyEncoder right_keys_;
+
+  std::vector<Partition> partitions_;
+
+  /** The right batches read into the probe buffers, the buffers, and the next buffered row to probe. */
+  std::vector<TupleBatch> probe_batches_;
+  std::vector<ProbeBuffer> probe_buffers_;
+  size_t probe_partition_{0};
+  size_t probe_index_{0};
+  bool right_done_{false};
+  /** The joined tuples of the rows probed last and the next one to return. */
+  TupleBatch results_;
+  uint32_t next_result_{0};
+};
+}  // namespace bustub
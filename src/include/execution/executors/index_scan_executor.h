@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <functional>
 #include <vector>
 
 #include "common/rid.h"
@@ -24,6 +25,13 @@ namespace bustub {
 
 /**
  * IndexScanExecutor executes an index scan over a table.
+ *
+ * When every column read by the output schema and the predicate is stored in
+ * the index entries (as a key or an included column), rows are rebuilt from
+ * the leaf entries and the table heap is never touched.
+ *
+ * A predicate comparing the first key column with a constant narrows the scan
+ * to the matching key range; the predicate is still applied to every row.
  */
 
 class IndexScanExecutor : public AbstractExecutor {
@@ -42,7 +50,31 @@ class IndexScanExecutor : public AbstractExecutor {
   bool Next(Tuple *tuple, RID *rid) override;
 
  private:
+  /** Open an iterator over the B+ tree index instantiated for KeySize byte keys. */
+  template <size_t KeySize>
+  void OpenIterator();
+
+  /** Derive the key range of the scan from the predicate, if it compares the first key column with a constant. */
+  void SetKeyRange();
+
+  /** Rebuild a row of the table from the values of an index entry. */
+  Tuple RowFromEntry(const std::vector<Value> &entry) const;
+
   /** The index scan plan node to be executed. */
   const IndexScanPlanNode *plan_;
+  IndexInfo *index_info_{nullptr};
+  TableMetadata *table_info_{nullptr};
+  /** Moves to the next entry and returns its RID, and its values when covering_, false at the end of the index. */
+  std::function<bool(RID *, std::vector<Value> *)> next_entry_;
+  /** True if rows are rebuilt from the index entries instead of read from the table heap. */
+  bool covering_{false};
+  /** entry_columns_[i] is the entry column holding table column i, -1 if it is not stored in the index. */
+  std::vector<int32_t> entry_columns_;
+  /** The key range scanned when key_range_, one value per key column. Missing bounds hold the type's extremes. */
+  bool key_range_{false};
+  std::vector<Value> low_key_;
+  std::vector<Value> high_key_;
+  bool low_inclusive_{true};
+  bool high_inclusive_{true};
 };
 }  // namespace bustub
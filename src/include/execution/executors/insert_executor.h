@@ -14,6 +14,7 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
@@ -48,7 +49,12 @@ class InsertExecutor : public AbstractExecutor {
   /** The insert plan node to be executed. */
   const InsertPlanNode *plan_;
   TableMetadata *table;
+  std::vector<IndexInfo *> indexes;
+  bool done_inserting{false};
   std::unique_ptr<AbstractExecutor> exec_child;
 
+  // add the entries of a freshly inserted tuple to every index of the table
+  void InsertIntoIndexes(Tuple *t, RID r);
+
 };
 }  // namespace bustub
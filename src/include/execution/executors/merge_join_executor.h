@@ -0,0 +1,103 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// merge_join_executor.h
+//
+// Identification: src/include/execution/executors/merge_join_executor.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/expressions/abstract_expression.h"
+#include "execution/plans/merge_join_plan.h"
+#include "execution/tuple_batch.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+/**
+ * MergeJoinExecutor executes an equi-join of two children sorted on their
+ * keys. Both children are read once, a batch at a time, in step: for every
+ * left tuple the right side is advanced past the smaller keys, and the run of
+ * right tuples with the left key is held in memory, so that the left tuples
+ * with the same key are all joined with it. Memory holds a batch of each side
+ * and one run of duplicate right keys, however large the inputs are.
+ *
+ * The keys are compared as normalized keys (see SortExecutor::EncodeSortKey),
+ * after they are cast to the type both sides are compared in.
+ */
+class MergeJoinExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new merge join executor.
+   * @param exec_ctx the executor context
+   * @param plan the merge join plan to be executed
+   * @param left_executor the child executor that produces the left tuples, sorted on the left keys
+   * @param right_executor the child executor that produces the right tuples, sorted on the right keys
+   */
+  MergeJoinExecutor(ExecutorContext *exec_ctx, const MergeJoinPlanNode *plan,
+                    std::unique_ptr<AbstractExecutor> &&left_executor,
+                    std::unique_ptr<AbstractExecutor> &&right_executor);
+
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
+
+  void Init() override;
+
+  bool Next(Tuple *tuple, RID *rid) override;
+
+  bool NextBatch(TupleBatch *batch) override;
+
+ private:
+  /** One input of the join and the key of its current tuple. */
+  struct Side {
+    AbstractExecutor *executor_;
+    const std::vector<const AbstractExpression *> *key_exprs_;
+    TupleBatch batch_;
+    BatchColumns key_columns_;
+    uint32_t row_{0};
+    bool done_{false};
+    std::string key_;
+    bool null_key_{false};
+  };
+
+  // encode the key of the current tuple of a side, reading its next batch when the current one is used up
+  void Seek(Side *side);
+  // move a side to its next tuple
+  void Advance(Side *side);
+  // skip the right tuples with keys smaller than key and hold the run of the ones equal to it in right_run_
+  void BufferRun(const std::string &key);
+  // join the next left tuple into results_, false when the left side is done
+  bool JoinNextLeft();
+  // append the join of two tuples to results_
+  void Emit(const Tuple &left_tuple, const Tuple &right_tuple);
+
+  /** The merge join plan node to be executed. */
+  const MergeJoinPlanNode *plan_;
+  std::unique_ptr<AbstractExecutor> left_executor_;
+  std::unique_ptr<AbstractExecutor> right_executor_;
+  /** The types the keys are compared in. */
+  std::vector<TypeId> key_types_;
+
+  Side left_;
+  Side right_;
+  /** The right tuples with key run_key_, valid once a run was buffered. */
+  std::vector<Tuple> right_run_;
+  std::string run_key_;
+  bool run_valid_{false};
+  /** A right tuple of NULLs, for the left tuples of a left join that have no match. */
+  Tuple null_right_tuple_;
+
+  /** The joined tuples of the current left tuple and the next one to return. */
+  TupleBatch results_;
+  uint32_t next_result_{0};
+};
+}  // namespace bustub
@@ -14,16 +14,22 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/nested_loop_join_plan.h"
+#include "execution/tuple_batch.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 /**
  * NestedLoopJoinExecutor joins two tables using nested loop.
  * The child executor can either be a sequential scan
+ *
+ * The join runs block by block: the left child is read a batch at a time and
+ * the right child is scanned once per left batch instead of once per left
+ * tuple.
  */
 class NestedLoopJoinExecutor : public AbstractExecutor {
  public:
@@ -45,8 +51,24 @@ class NestedLoopJoinExecutor : public AbstractExecutor {
 
   bool Next(Tuple *tuple, RID *rid) override;
 
+  bool NextBatch(TupleBatch *batch) override;
+
  private:
+  // join the current left batch with the next right batch into results_, false when the left side is done
+  bool JoinNextBlock();
+
   /** The NestedLoop plan node to be executed. */
   const NestedLoopJoinPlanNode *plan_;
+  std::unique_ptr<AbstractExecutor> left_executor_;
+  std::unique_ptr<AbstractExecutor> right_executor_;
+  /** The tuples of the current left batch, joined with every right batch. */
+  std::vector<Tuple> left_tuples_;
+  /** True if the right child has been read to the end for the current left batch. */
+  bool right_done_{true};
+  TupleBatch left_batch_;
+  TupleBatch right_batch_;
+  /** The joined tuples of the current block and the next one to return. */
+  TupleBatch results_;
+  uint32_t next_result_{0};
 };
 }  // namespace bustub
@@ -0,0 +1,78 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// repartition_executor.h
+//
+// Identification: src/include/execution/executors/repartition_executor.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/executors/hash_join_executor.h"
+#include "execution/parallel_context.h"
+#include "execution/plans/repartition_plan.h"
+#include "execution/tuple_batch.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+/**
+ * RepartitionExecutor is the part of a repartition exchange that runs in one
+ * worker of a gather. It pulls batches of its child and sends every tuple to
+ * the partition of its key hash, and returns the tuples sent to the partition
+ * of its worker, by any worker. Once its child is done it waits for the other
+ * workers to send the rest. Tuples with a NULL key all go to partition 0.
+ */
+class RepartitionExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new repartition executor.
+   * @param exec_ctx the executor context, of a worker of a gather
+   * @param plan the repartition plan to be executed
+   * @param child_executor the child executor whose tuples are sent to the workers
+   */
+  RepartitionExecutor(ExecutorContext *exec_ctx, const RepartitionPlanNode *plan,
+                      std::unique_ptr<AbstractExecutor> &&child_executor);
+
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
+
+  void Init() override;
+
+  bool Next(Tuple *tuple, RID *rid) override;
+
+  bool NextBatch(TupleBatch *batch) override;
+
+ private:
+  // read the next tuples of the partition of this worker into tuples_, false when there are none left
+  bool ReadTuples();
+  // send the tuples of batch_ to their partitions
+  void SendBatch();
+  // bits 44 to 56 of the hash: the hash tables above use the lowest bits and the tags, the joins bits 32 and up
+  size_t PartitionOf(uint64_t hash) const { return ((hash >> 44) & 0x1FFF) % partitions_.size(); }
+
+  /** The repartition plan node to be executed. */
+  const RepartitionPlanNode *plan_;
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  JoinKeyEncoder keys_;
+
+  /** The queues shared by the workers, nullptr outside of a gather, and the partition of this worker. */
+  RepartitionQueues *queues_{nullptr};
+  size_t partition_{0};
+  bool child_done_{false};
+
+  TupleBatch batch_;
+  /** The tuples of the child to send to every partition. */
+  std::vector<std::vector<Tuple>> partitions_;
+  /** The tuples of the partition of this worker and the next one to return. */
+  std::vector<Tuple> tuples_;
+  size_t next_tuple_{0};
+};
+}  // namespace bustub
@@ -12,17 +12,31 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/expressions/compiled_predicate.h"
 #include "execution/plans/seq_scan_plan.h"
+#include "storage/table/table_heap.h"
+#include "storage/table/table_morsel_queue.h"
 #include "storage/table/tuple.h"
+#include "storage/table/tuple_projection.h"
 
 namespace bustub {
 
 /**
- * SeqScanExecutor executes a sequential scan over a table.
+ * SeqScanExecutor executes a sequential scan over a table, copying the tuples
+ * of one page at a time.
+ *
+ * A compiled predicate is evaluated on the tuples in the page, so that only
+ * the tuples that pass are copied. When every output column is a column of
+ * the table, only those columns are copied, into tuples of the output schema.
+ *
+ * In a worker of a gather, a parallel scan takes morsels of pages of the
+ * table from a queue that the workers share, so that each page is scanned
+ * by exactly one worker.
  */
 class SeqScanExecutor : public AbstractExecutor {
  public:
@@ -37,12 +51,38 @@ class SeqScanExecutor : public AbstractExecutor {
 
   bool Next(Tuple *tuple, RID *rid) override;
 
+  /** Reads a batch of table tuples at a time and filters and projects them a column at a time. */
+  bool NextBatch(TupleBatch *batch) override;
+
   const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
 
  private:
+  // the value of an output column for a tuple of the table
+  Value OutputValue(uint32_t column, const Tuple &tuple) const;
+  // read the tuples of the next page to scan into page_tuples_, false when the scan is done
+  bool ReadNextPage();
+  // the projection of the table tuples onto the output schema, nullptr if an output column is not a table column
+  std::unique_ptr<TupleProjection> MakeProjection() const;
+
   /** The sequential scan plan node to be executed. */
   const SeqScanPlanNode *plan_;
   TableHeap *table;
-  std::unique_ptr<TableIterator> iter;
+  const Schema *table_schema_;
+  /** The morsels of a parallel scan, nullptr when this executor scans the whole table. */
+  TableMorselQueue *morsels_{nullptr};
+  /** The next page to scan and the number of pages left to scan before the next morsel. */
+  page_id_t next_page_id_{INVALID_PAGE_ID};
+  size_t pages_left_{0};
+  /** The tuples of the page being scanned and the next one to return. */
+  std::vector<Tuple> page_tuples_;
+  size_t next_tuple_{0};
+  /** The predicate of the plan compiled for the tuples of the table, nullptr if it is interpreted. */
+  std::unique_ptr<CompiledPredicate> compiled_predicate_;
+  /** The compiled predicate evaluated in the page, nullptr if the page tuples are not filtered. */
+  TupleFilter filter_;
+  /** The projection done in the page, nullptr if page_tuples_ are tuples of the table. */
+  std::unique_ptr<TupleProjection> projection_;
+  /** The table tuples of the batch being produced. */
+  TupleBatch table_batch_;
 };
 }  // namespace bustub
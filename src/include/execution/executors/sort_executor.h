@@ -0,0 +1,119 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_executor.h
+//
+// Identification: src/include/execution/executors/sort_executor.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/util/loser_tree.h"
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/sort_plan.h"
+#include "execution/tuple_batch.h"
+#include "storage/table/tmp_tuple_file.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+/**
+ * SortExecutor executes an ORDER BY with an external merge sort.
+ *
+ * The sort keys of every tuple are encoded into one normalized key, a string
+ * of bytes that memcmp orders like the keys themselves, so sorting compares
+ * strings and not Values. Init reads the child into memory; when the tuples
+ * held exceed the memory budget they are sorted and written to temporary
+ * pages as a run. Next merges the runs and the tuples left in memory with a
+ * loser tree, holding one page of every run at a time.
+ *
+ * The sort is stable: tuples with equal keys come out in the child's order.
+ */
+class SortExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new sort executor.
+   * @param exec_ctx the executor context
+   * @param plan the sort plan to be executed
+   * @param child_executor the child executor whose tuples are sorted
+   */
+  SortExecutor(ExecutorContext *exec_ctx, const SortPlanNode *plan, std::unique_ptr<AbstractExecutor> &&child_executor);
+
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
+
+  /** Reads and sorts the tuples of the child, spilling sorted runs that do not fit. */
+  void Init() override;
+
+  bool Next(Tuple *tuple, RID *rid) override;
+
+  /** @return the number of runs written to temporary pages */
+  size_t GetNumSpilledRuns() const { return num_spilled_runs_; }
+
+  /**
+   * Appends the normalized key of a value to key. NULL sorts after every other value, as in PostgreSQL.
+   * @param value the value to encode
+   * @param order the direction of the sort, descending keys have their bytes inverted
+   * @param[out] key the key the encoded value is appended to
+   * @throws Exception if values of this type cannot be sorted
+   */
+  static void EncodeSortKey(const Value &value, OrderByType order, std::string *key);
+
+ private:
+  /** Bytes held for a tuple besides its data and key. */
+  static constexpr size_t ENTRY_OVERHEAD = sizeof(std::string) + sizeof(Tuple);
+
+  /** A tuple and its normalized key. */
+  struct SortEntry {
+    std::string key_;
+    Tuple tuple_;
+  };
+
+  /** A sorted run, read back a page at a time; the run left in memory has no pages. */
+  struct Run {
+    explicit Run(BufferPoolManager *bpm) : file_(bpm) {}
+
+    TmpTupleFile file_;
+    size_t next_page_{0};
+    std::vector<SortEntry> entries_;
+    size_t next_entry_{0};
+  };
+
+  // encode the keys of the tuples of a batch and append them to entries, spilling a run whenever the tuples in
+  // memory exceed memory_budget, unless it is 0
+  void AddBatch(const TupleBatch &batch, std::vector<SortEntry> *entries, size_t memory_budget);
+  // sort the tuples in memory and write them to a new run
+  void SpillRun();
+  // move to the next tuple of a run, reading its next page when the current one is used up
+  void Advance(Run *run);
+  // read the next page of a run, or release the run when it has none left
+  void LoadNextPage(Run *run);
+
+  static bool HasHead(const Run &run) { return run.next_entry_ < run.entries_.size(); }
+
+  /** The sort plan node to be executed. */
+  const SortPlanNode *plan_;
+  std::unique_ptr<AbstractExecutor> child_executor_;
+
+  /** The tuples in memory and their bytes. */
+  std::vector<SortEntry> entries_;
+  size_t bytes_{0};
+  size_t num_spilled_runs_{0};
+
+  /** The runs being merged, the one in memory is the last one. */
+  std::vector<Run> runs_;
+  std::unique_ptr<LoserTree> merge_;
+
+  TupleBatch batch_;
+  /** A page of a run being read back. */
+  std::vector<Tuple> page_tuples_;
+  TupleBatch page_batch_;
+};
+}  // namespace bustub
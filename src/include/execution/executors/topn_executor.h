@@ -0,0 +1,90 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// topn_executor.h
+//
+// Identification: src/include/execution/executors/topn_executor.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/limit_plan.h"
+#include "execution/plans/sort_plan.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+/**
+ * TopNExecutor executes a limit directly over a sort (ORDER BY ... LIMIT n
+ * OFFSET m) without sorting all the tuples of the child. It keeps the best
+ * n + m tuples seen so far in a max-heap on their normalized sort keys; a
+ * tuple whose key is not better than the worst one in the heap is dropped
+ * after one key comparison, before the tuple is built.
+ *
+ * Like SortExecutor, tuples with equal keys come out in the child's order.
+ * Past MAX_KEPT_TUPLES the heap is not used and the limit runs over an
+ * external sort, which stays within the sort's memory budget.
+ */
+class TopNExecutor : public AbstractExecutor {
+ public:
+  /** The most tuples kept in the heap, whatever the memory budget. */
+  static constexpr size_t MAX_KEPT_TUPLES = 1 << 16;
+
+  /**
+   * Creates a new top-n executor.
+   * @param exec_ctx the executor context
+   * @param limit_plan the limit plan to be executed
+   * @param sort_plan the sort plan under the limit plan
+   * @param child_executor the executor of the child of the sort plan
+   */
+  TopNExecutor(ExecutorContext *exec_ctx, const LimitPlanNode *limit_plan, const SortPlanNode *sort_plan,
+               std::unique_ptr<AbstractExecutor> &&child_executor);
+
+  const Schema *GetOutputSchema() override { return limit_plan_->OutputSchema(); };
+
+  /** Reads the child and keeps its best tuples. */
+  void Init() override;
+
+  bool Next(Tuple *tuple, RID *rid) override;
+
+  /**
+   * @return whether a limit over a sort runs as a TopNExecutor: there are no more than MAX_KEPT_TUPLES kept tuples,
+   * and they fit in the sort's memory budget, if it has one
+   */
+  static bool CanExecute(const LimitPlanNode *limit_plan, const SortPlanNode *sort_plan);
+
+ private:
+  // the number of tuples to keep, limit + offset, SIZE_MAX if the sum does not fit
+  static size_t NumKept(const LimitPlanNode *limit_plan);
+
+  /** A tuple, its normalized key and its position in the child's output. */
+  struct HeapEntry {
+    std::string key_;
+    size_t position_;
+    Tuple tuple_;
+  };
+
+  // the order of the output: by key, then by position
+  static bool Before(const HeapEntry &a, const HeapEntry &b) {
+    int cmp = a.key_.compare(b.key_);
+    return cmp < 0 || (cmp == 0 && a.position_ < b.position_);
+  }
+
+  const LimitPlanNode *limit_plan_;
+  const SortPlanNode *sort_plan_;
+  std::unique_ptr<AbstractExecutor> child_executor_;
+
+  /** A max-heap by Before while reading the child, the sorted output after Init. */
+  std::vector<HeapEntry> heap_;
+  size_t next_entry_{0};
+};
+}  // namespace bustub
@@ -16,6 +16,7 @@
 #include <vector>
 
 #include "catalog/schema.h"
+#include "execution/tuple_batch.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
@@ -39,6 +40,31 @@ class AbstractExpression {
   /** @return the value obtained by evaluating the tuple with the given schema */
   virtual Value Evaluate(const Tuple *tuple, const Schema *schema) const = 0;
 
+  /**
+   * Evaluates the expression on every tuple of a batch.
+   * @param batch the tuples, in the columns of batch.GetSchema()
+   * @param[out] result one value per tuple of the batch
+   */
+  virtual void EvaluateBatch(const TupleBatch &batch, std::vector<Value> *result) const {
+    // expressions without a batch version are evaluated tuple by tuple
+    result->clear();
+    for (uint32_t row = 0; row < batch.GetNumRows(); row++) {
+      Tuple tuple = batch.GetTuple(row);
+      result->push_back(Evaluate(&tuple, batch.GetSchema()));
+    }
+  }
+
+  /**
+   * Evaluates the expression on every tuple of a batch, without copying values the batch already holds.
+   * @param batch the tuples, in the columns of batch.GetSchema()
+   * @param scratch where the values are computed when they are not a column of the batch
+   * @return one value per tuple of the batch, either a column of batch or *scratch
+   */
+  virtual const std::vector<Value> &EvaluateBatchColumn(const TupleBatch &batch, std::vector<Value> *scratch) const {
+    EvaluateBatch(batch, scratch);
+    return *scratch;
+  }
+
   /**
    * Returns the value obtained by evaluating a join.
    * @param left_tuple the left tuple
@@ -73,4 +99,36 @@ class AbstractExpression {
   /** The return type of this expression. */
   TypeId ret_type_;
 };
+
+/**
+ * @return true if the result of evaluating a predicate keeps the tuple; NULL, like false, does not
+ */
+inline bool PassesPredicate(const Value &value) { return !value.IsNull() && value.GetAs<bool>(); }
+
+/**
+ * BatchColumns holds the values of a few expressions over one batch. The
+ * column of an expression that only reads a column of the batch is the
+ * batch's own, so the values are good until the batch changes.
+ */
+class BatchColumns {
+ public:
+  explicit BatchColumns(size_t num_columns = 0) { Resize(num_columns); }
+
+  void Resize(size_t num_columns) {
+    scratch_.resize(num_columns);
+    columns_.resize(num_columns, nullptr);
+  }
+
+  /** Evaluates expr on every tuple of batch into column i. */
+  void Evaluate(size_t i, const AbstractExpression *expr, const TupleBatch &batch) {
+    columns_[i] = &expr->EvaluateBatchColumn(batch, &scratch_[i]);
+  }
+
+  const std::vector<Value> &operator[](size_t i) const { return *columns_[i]; }
+  size_t GetNumColumns() const { return columns_.size(); }
+
+ private:
+  std::vector<std::vector<Value>> scratch_;
+  std::vector<const std::vector<Value> *> columns_;
+};
 }  // namespace bustub
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <functional>
 #include <utility>
 #include <vector>
 
@@ -40,6 +41,30 @@ class ComparisonExpression : public AbstractExpression {
     return ValueFactory::GetBooleanValue(PerformComparison(lhs, rhs));
   }
 
+  void EvaluateBatch(const TupleBatch &batch, std::vector<Value> *result) const override {
+    std::vector<Value> lhs_scratch;
+    std::vector<Value> rhs_scratch;
+    const std::vector<Value> &lhs = GetChildAt(0)->EvaluateBatchColumn(batch, &lhs_scratch);
+    const std::vector<Value> &rhs = GetChildAt(1)->EvaluateBatchColumn(batch, &rhs_scratch);
+    // the comparison is picked once per batch, not once per tuple
+    switch (comp_type_) {
+      case ComparisonType::Equal:
+        return CompareColumns(lhs, rhs, &Value::CompareEquals, std::equal_to<>(), result);
+      case ComparisonType::NotEqual:
+        return CompareColumns(lhs, rhs, &Value::CompareNotEquals, std::not_equal_to<>(), result);
+      case ComparisonType::LessThan:
+        return CompareColumns(lhs, rhs, &Value::CompareLessThan, std::less<>(), result);
+      case ComparisonType::LessThanOrEqual:
+        return CompareColumns(lhs, rhs, &Value::CompareLessThanEquals, std::less_equal<>(), result);
+      case ComparisonType::GreaterThan:
+        return CompareColumns(lhs, rhs, &Value::CompareGreaterThan, std::greater<>(), result);
+      case ComparisonType::GreaterThanOrEqual:
+        return CompareColumns(lhs, rhs, &Value::CompareGreaterThanEquals, std::greater_equal<>(), result);
+      default:
+        BUSTUB_ASSERT(false, "Unsupported comparison type.");
+    }
+  }
+
   Value EvaluateJoin(const Tuple *left_tuple, const Schema *left_schema, const Tuple *right_tuple,
                      const Schema *right_schema) const override {
     Value lhs = GetChildAt(0)->EvaluateJoin(left_tuple, left_schema, right_tuple, right_schema);
@@ -53,7 +78,36 @@ class ComparisonExpression : public AbstractExpression {
     return ValueFactory::GetBooleanValue(PerformComparison(lhs, rhs));
   }
 
+  /** @return the comparison made */
+  ComparisonType GetComparisonType() const { return comp_type_; }
+
  private:
+  /**
+   * Compares two columns row by row. INTEGER and BIGINT values of the same
+   * type are compared as integers in place, the others through their Type.
+   */
+  template <typename NativeCompare>
+  static void CompareColumns(const std::vector<Value> &lhs, const std::vector<Value> &rhs,
+                             CmpBool (Value::*compare)(const Value &) const, NativeCompare native_compare,
+                             std::vector<Value> *result) {
+    result->clear();
+    result->reserve(lhs.size());
+    for (uint32_t row = 0; row < lhs.size(); row++) {
+      const Value &left = lhs[row];
+      const Value &right = rhs[row];
+      TypeId type = left.GetTypeId();
+      if (type != right.GetTypeId() || left.IsNull() || right.IsNull()) {
+        result->push_back(ValueFactory::GetBooleanValue((left.*compare)(right)));
+      } else if (type == TypeId::INTEGER) {
+        result->push_back(ValueFactory::GetBooleanValue(native_compare(left.GetAs<int32_t>(), right.GetAs<int32_t>())));
+      } else if (type == TypeId::BIGINT) {
+        result->push_back(ValueFactory::GetBooleanValue(native_compare(left.GetAs<int64_t>(), right.GetAs<int64_t>())));
+      } else {
+        result->push_back(ValueFactory::GetBooleanValue((left.*compare)(right)));
+      }
+    }
+  }
+
   CmpBool PerformComparison(const Value &lhs, const Value &rhs) const {
     switch (comp_type_) {
       case ComparisonType::Equal:
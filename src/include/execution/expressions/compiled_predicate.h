@@ -0,0 +1,125 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compiled_predicate.h
+//
+// Identification: src/include/execution/expressions/compiled_predicate.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "execution/expressions/abstract_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * CompiledPredicate is a predicate compiled from an expression tree into a
+ * flat program that reads the bytes of a tuple itself, where Evaluate walks
+ * the tree with a virtual call and a Value at every node.
+ *
+ * The program is a list of instructions over numbered registers, each one an
+ * integer or a double and a NULL flag. Every instruction points to a handler
+ * that is a template specialized for the types it works on: a load of an
+ * INTEGER column, a comparison of two doubles. A comparison of a column with
+ * a constant, the usual predicate, is a single instruction.
+ *
+ * Comparisons, column values and constants of the fixed-size number types
+ * and BOOLEAN are compiled; Compile returns nullptr for any other expression,
+ * which is then interpreted. Comparisons work on the same types as Value
+ * does: integers as 64-bit integers, and as doubles with a DECIMAL.
+ */
+class CompiledPredicate {
+ public:
+  /**
+   * Compiles a predicate on the tuples of a schema.
+   * @param predicate a BOOLEAN expression on one tuple
+   * @param schema the schema of the tuples the predicate is evaluated on
+   * @return the compiled predicate, or nullptr if the predicate has a part that cannot be compiled
+   */
+  static std::unique_ptr<CompiledPredicate> Compile(const AbstractExpression *predicate, const Schema *schema);
+
+  /**
+   * @param data the bytes of a tuple of the schema, as in a table page
+   * @return whether the predicate is true for the tuple; NULL is not true
+   */
+  bool Evaluate(const char *data) const {
+    for (const auto &instruction : program_) {
+      instruction.handler_(instruction, data, registers_.data());
+    }
+    const Register &result = registers_.back();
+    return !result.null_ && result.integer_ != 0;
+  }
+
+  /** @return whether the predicate is true for a tuple of the schema; NULL is not true */
+  bool Evaluate(const Tuple &tuple) const { return Evaluate(tuple.GetData()); }
+
+  /** @return the number of instructions of the program */
+  size_t GetNumInstructions() const { return program_.size(); }
+
+ private:
+  struct Register {
+    union {
+      int64_t integer_;
+      double decimal_;
+    };
+    bool null_;
+  };
+
+  struct Instruction;
+  using Handler = void (*)(const Instruction &instruction, const char *data, Register *registers);
+
+  /** One step of the program: the handler writes register dst_ from registers or tuple bytes. */
+  struct Instruction {
+    Handler handler_;
+    uint32_t dst_;
+    /** The registers read. */
+    uint32_t left_;
+    uint32_t right_;
+    /** The offset of the column read in the tuple. */
+    uint32_t offset_;
+    /** The constant loaded or compared with. */
+    Register constant_;
+  };
+
+  CompiledPredicate() = default;
+
+  // the handlers, instantiated for the storage type T of a column and the type C a comparison is made in
+  template <typename T>
+  static void LoadColumn(const Instruction &instruction, const char *data, Register *registers);
+  static void LoadConstant(const Instruction &instruction, const char *data, Register *registers);
+  static void ToDecimal(const Instruction &instruction, const char *data, Register *registers);
+  template <ComparisonType Op, typename C>
+  static void Compare(const Instruction &instruction, const char *data, Register *registers);
+  template <typename T, ComparisonType Op, typename C>
+  static void CompareColumnConstant(const Instruction &instruction, const char *data, Register *registers);
+
+  // the handler of a comparison in C, and of a comparison of a column of storage type T with a constant
+  template <typename C>
+  static Handler CompareHandler(ComparisonType op);
+  template <typename T, typename C>
+  static Handler CompareColumnConstantHandler(ComparisonType op);
+  static Handler LoadColumnHandler(TypeId type);
+  static Handler ColumnConstantHandler(TypeId column_type, bool decimal, ComparisonType op);
+
+  // append the instructions that compute an expression, false if it cannot be compiled
+  bool CompileNode(const AbstractExpression *expr, const Schema *schema, uint32_t *dst, TypeId *type);
+  uint32_t NewRegister() { return num_registers_++; }
+
+  std::vector<Instruction> program_;
+  uint32_t num_registers_{0};
+  /** Scratch registers, the result is in the last one; Evaluate is const, a predicate is evaluated by one thread. */
+  mutable std::vector<Register> registers_;
+};
+
+}  // namespace bustub
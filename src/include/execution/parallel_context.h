@@ -0,0 +1,146 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_context.h
+//
+// Identification: src/include/execution/parallel_context.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <memory>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+#include "common/util/thread_pool.h"
+#include "execution/plans/abstract_plan.h"
+#include "storage/table/table_morsel_queue.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * RepartitionQueues holds the tuples that the workers of a repartition
+ * exchange send each other: worker i reads the tuples sent to partition i.
+ * Tuples are queued until they are read, there is no bound on the queues.
+ */
+class RepartitionQueues {
+ public:
+  /**
+   * @param num_workers the number of workers, each one produces tuples and reads one partition
+   * @param cancelled set when the query stops, which wakes the workers waiting for tuples
+   */
+  RepartitionQueues(size_t num_workers, const std::atomic<bool> *cancelled);
+
+  DISALLOW_COPY_AND_MOVE(RepartitionQueues);
+
+  /** Moves tuples to the queue of a partition. */
+  void Push(size_t partition, std::vector<Tuple> *tuples);
+
+  /** Records that a worker sends no more tuples. */
+  void ProducerDone(size_t worker_id);
+
+  /**
+   * Takes the tuples queued for a partition.
+   * @param partition the partition of the calling worker
+   * @param[out] tuples emptied, then filled with the tuples queued
+   * @param wait whether to wait for tuples until every worker is done producing
+   * @return false if no tuple was queued, and with wait, if none will be
+   */
+  bool Pop(size_t partition, std::vector<Tuple> *tuples, bool wait);
+
+  /** Wakes the workers waiting for tuples. */
+  void Wake();
+
+ private:
+  std::mutex latch_;
+  std::condition_variable not_empty_;
+  std::vector<std::vector<Tuple>> queues_;
+  std::vector<bool> producer_done_;
+  size_t num_producers_done_{0};
+  const std::atomic<bool> *cancelled_;
+};
+
+/**
+ * ParallelContext is the state that the workers of a gather exchange share:
+ * the morsel queues of their parallel scans and the queues of their
+ * repartition exchanges. Every worker runs its own copy of the executors
+ * below the gather; the copies of one plan node find their shared state here
+ * by the plan node.
+ */
+class ParallelContext {
+ public:
+  /**
+   * @param num_workers the number of workers
+   * @param morsel_pages the number of pages in a morsel of a parallel scan
+   */
+  ParallelContext(size_t num_workers, size_t morsel_pages);
+
+  DISALLOW_COPY_AND_MOVE(ParallelContext);
+
+  /** @return the number of workers */
+  size_t GetNumWorkers() const { return num_workers_; }
+
+  /**
+   * @param thread_pool the threads the workers would run on, nullptr if there are none
+   * @param plan the plan every worker runs a copy of
+   * @param max_workers the number of workers a plan asks for
+   * @return the number of workers to run: no more than there are threads, since workers can wait for each other,
+   * and one if the plan is not split among the workers, since every worker would produce all of its tuples. It is
+   * one as well while logging is on: the workers share the transaction of the query, and the lock manager updates
+   * its lock sets without synchronization. On a thread of the pool itself, workers that wait for each other could
+   * wait for a thread held by the caller, so there is one worker, run by the caller
+   */
+  static size_t NumWorkers(const ThreadPool *thread_pool, const AbstractPlanNode *plan, size_t max_workers) {
+    if (thread_pool == nullptr || thread_pool->IsPoolThread() || !IsSplit(plan) || enable_logging) {
+      return 1;
+    }
+    return std::clamp<size_t>(max_workers, 1, thread_pool->GetNumThreads());
+  }
+
+  /**
+   * @return whether the copies of a plan run by the workers produce disjoint parts of its tuples: the plan reads a
+   * parallel scan or a repartition exchange, below any node but a gather
+   */
+  static bool IsSplit(const AbstractPlanNode *plan);
+
+  /** @return the morsel queue of a parallel scan, created by the first worker that asks */
+  TableMorselQueue *GetMorselQueue(const AbstractPlanNode *scan_plan, TableHeap *table_heap);
+
+  /** @return the queues of a repartition exchange, created by the first worker that asks */
+  RepartitionQueues *GetRepartitionQueues(const AbstractPlanNode *repartition_plan);
+
+  /**
+   * Records that a worker is done. It produces no more tuples for the repartition exchanges, even those it never
+   * read, and the tuples sent to its partitions are never read.
+   */
+  void WorkerDone(size_t worker_id);
+
+  /** Stops the query: the workers waiting for tuples wake up and find none. */
+  void Cancel();
+
+  /** @return whether the query was stopped */
+  bool IsCancelled() const { return cancelled_; }
+
+ private:
+  size_t num_workers_;
+  size_t morsel_pages_;
+  std::atomic<bool> cancelled_{false};
+
+  std::mutex latch_;
+  std::unordered_map<const AbstractPlanNode *, std::unique_ptr<TableMorselQueue>> morsel_queues_;
+  std::unordered_map<const AbstractPlanNode *, std::unique_ptr<RepartitionQueues>> repartition_queues_;
+  std::vector<bool> worker_done_;
+};
+
+}  // namespace bustub
@@ -39,15 +39,20 @@ class AggregationPlanNode : public AbstractPlanNode {
    * @param group_bys the group by clause of the aggregation
    * @param aggregates the expressions that we are aggregating
    * @param agg_types the types that we are aggregating
+   * @param num_workers the largest number of threads that read the child and aggregate, each a copy of the child
+   * @param memory_budget the bytes of groups held in memory before partial aggregates are spilled, 0 for no limit
    */
   AggregationPlanNode(const Schema *output_schema, const AbstractPlanNode *child, const AbstractExpression *having,
                       std::vector<const AbstractExpression *> &&group_bys,
-                      std::vector<const AbstractExpression *> &&aggregates, std::vector<AggregationType> &&agg_types)
+                      std::vector<const AbstractExpression *> &&aggregates, std::vector<AggregationType> &&agg_types,
+                      size_t num_workers = 1, size_t memory_budget = 0)
       : AbstractPlanNode(output_schema, {child}),
         having_(having),
         group_bys_(std::move(group_bys)),
         aggregates_(std::move(aggregates)),
-        agg_types_(std::move(agg_types)) {}
+        agg_types_(std::move(agg_types)),
+        num_workers_(num_workers),
+        memory_budget_(memory_budget) {}
 
   PlanType GetType() const override { return PlanType::Aggregation; }
 
@@ -75,11 +80,19 @@ class AggregationPlanNode : public AbstractPlanNode {
   /** @return the aggregate types */
   const std::vector<AggregationType> &GetAggregateTypes() const { return agg_types_; }
 
+  /** @return the largest number of threads that aggregate; as below a gather, a parallel scan splits its table */
+  size_t GetNumWorkers() const { return num_workers_; }
+
+  /** @return the bytes of groups held in memory before partial aggregates are spilled, 0 for no limit */
+  size_t GetMemoryBudget() const { return memory_budget_; }
+
  private:
   const AbstractExpression *having_;
   std::vector<const AbstractExpression *> group_bys_;
   std::vector<const AbstractExpression *> aggregates_;
   std::vector<AggregationType> agg_types_;
+  size_t num_workers_;
+  size_t memory_budget_;
 };
 
 struct AggregateKey {
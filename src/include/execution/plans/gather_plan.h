@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// gather_plan.h
+//
+// Identification: src/include/execution/plans/gather_plan.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "execution/plans/abstract_plan.h"
+#include "storage/table/table_morsel_queue.h"
+
+namespace bustub {
+
+/**
+ * GatherPlanNode is an exchange that runs its child plan on several workers
+ * in parallel and returns the tuples of all of them, in no particular order.
+ *
+ * Each worker runs a copy of the child plan. Parallel scans split their table
+ * among the workers, and repartition exchanges send every tuple to one worker
+ * by its keys; every other plan node sees all of its input in every worker.
+ * The workers find the state they share by plan node, so a parallel scan or
+ * a repartition node appears once below a gather.
+ */
+class GatherPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Creates a new gather plan node.
+   * @param output_schema the output format of this gather node, the one of the child
+   * @param child the child plan that the workers run
+   * @param num_workers the largest number of workers, fewer when there are fewer threads
+   * @param morsel_pages the number of pages that the workers of a parallel scan take at a time
+   */
+  GatherPlanNode(const Schema *output_schema, const AbstractPlanNode *child, size_t num_workers,
+                 size_t morsel_pages = TableMorselQueue::DEFAULT_MORSEL_PAGES)
+      : AbstractPlanNode(output_schema, {child}), num_workers_(num_workers), morsel_pages_(morsel_pages) {}
+
+  PlanType GetType() const override { return PlanType::Gather; }
+
+  /** @return the child plan that the workers run */
+  const AbstractPlanNode *GetChildPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 1, "Gather should have exactly one child plan.");
+    return GetChildAt(0);
+  }
+
+  /** @return the largest number of workers */
+  size_t GetNumWorkers() const { return num_workers_; }
+
+  /** @return the number of pages that the workers of a parallel scan take at a time */
+  size_t GetMorselPages() const { return morsel_pages_; }
+
+ private:
+  size_t num_workers_;
+  size_t morsel_pages_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,85 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_join_plan.h
+//
+// Identification: src/include/execution/plans/hash_join_plan.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "execution/expressions/abstract_expression.h"
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+/**
+ * HashJoinPlanNode is an equi-join of two children: tuples are joined if their left and right keys are equal and
+ * the predicate, if any, holds.
+ */
+class HashJoinPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Creates a new hash join plan node.
+   * @param output_schema the output format of this hash join node
+   * @param children the left (build) and right (probe) children plans, by convention the left one is smaller
+   * @param predicate the rest of the join condition, tested after the keys matched, can be nullptr
+   * @param left_keys the key expressions evaluated on left tuples
+   * @param right_keys the key expressions evaluated on right tuples, one for each left key
+   * @param memory_budget the bytes the join may hold in memory before it spills partitions to temporary pages, 0 if
+   * the whole left side is held in memory
+   */
+  HashJoinPlanNode(const Schema *output_schema, std::vector<const AbstractPlanNode *> &&children,
+                   const AbstractExpression *predicate, std::vector<const AbstractExpression *> &&left_keys,
+                   std::vector<const AbstractExpression *> &&right_keys, size_t memory_budget = 0)
+      : AbstractPlanNode(output_schema, std::move(children)),
+        predicate_(predicate),
+        left_keys_(std::move(left_keys)),
+        right_keys_(std::move(right_keys)),
+        memory_budget_(memory_budget) {
+    BUSTUB_ASSERT(left_keys_.size() == right_keys_.size(), "Hash joins need as many left keys as right keys.");
+  }
+
+  PlanType GetType() const override { return PlanType::HashJoin; }
+
+  /** @return the predicate tested on the tuples whose keys match, can be nullptr */
+  const AbstractExpression *Predicate() const { return predicate_; }
+
+  /** @return the left plan node of the hash join, the hash table is built on its tuples */
+  const AbstractPlanNode *GetLeftPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 2, "Hash joins should have exactly two children plans.");
+    return GetChildAt(0);
+  }
+
+  /** @return the right plan node of the hash join, its tuples probe the hash table */
+  const AbstractPlanNode *GetRightPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 2, "Hash joins should have exactly two children plans.");
+    return GetChildAt(1);
+  }
+
+  /** @return the key expressions of the left side */
+  const std::vector<const AbstractExpression *> &GetLeftKeys() const { return left_keys_; }
+
+  /** @return the key expressions of the right side */
+  const std::vector<const AbstractExpression *> &GetRightKeys() const { return right_keys_; }
+
+  /** @return the bytes the join may hold in memory, 0 if unlimited */
+  size_t GetMemoryBudget() const { return memory_budget_; }
+
+ private:
+  /** The join condition besides the keys. */
+  const AbstractExpression *predicate_;
+  /** The key expressions of both sides. */
+  std::vector<const AbstractExpression *> left_keys_;
+  std::vector<const AbstractExpression *> right_keys_;
+  /** The memory budget of the join, 0 if unlimited. */
+  size_t memory_budget_;
+};
+
+}  // namespace bustub
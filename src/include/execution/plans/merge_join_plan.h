@@ -0,0 +1,80 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// merge_join_plan.h
+//
+// Identification: src/include/execution/plans/merge_join_plan.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "execution/expressions/abstract_expression.h"
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+
+/** JoinType is the kind of join: INNER drops the left tuples without a match, LEFT joins them with NULLs. */
+enum class JoinType { INNER, LEFT };
+
+/**
+ * MergeJoinPlanNode is an equi-join of two children that are both sorted on their keys, in ascending order with
+ * NULLs last, as a SortPlanNode or an index scan outputs them.
+ */
+class MergeJoinPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Creates a new merge join plan node.
+   * @param output_schema the output format of this merge join node
+   * @param children the left and right children plans, sorted on their keys
+   * @param left_keys the key expressions evaluated on left tuples
+   * @param right_keys the key expressions evaluated on right tuples, one for each left key
+   * @param join_type whether left tuples without a match are dropped or joined with NULLs
+   */
+  MergeJoinPlanNode(const Schema *output_schema, std::vector<const AbstractPlanNode *> &&children,
+                    std::vector<const AbstractExpression *> &&left_keys,
+                    std::vector<const AbstractExpression *> &&right_keys, JoinType join_type = JoinType::INNER)
+      : AbstractPlanNode(output_schema, std::move(children)),
+        left_keys_(std::move(left_keys)),
+        right_keys_(std::move(right_keys)),
+        join_type_(join_type) {
+    BUSTUB_ASSERT(left_keys_.size() == right_keys_.size(), "Merge joins need as many left keys as right keys.");
+  }
+
+  PlanType GetType() const override { return PlanType::MergeJoin; }
+
+  /** @return the left plan node of the merge join */
+  const AbstractPlanNode *GetLeftPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 2, "Merge joins should have exactly two children plans.");
+    return GetChildAt(0);
+  }
+
+  /** @return the right plan node of the merge join */
+  const AbstractPlanNode *GetRightPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 2, "Merge joins should have exactly two children plans.");
+    return GetChildAt(1);
+  }
+
+  /** @return the key expressions of the left side */
+  const std::vector<const AbstractExpression *> &GetLeftKeys() const { return left_keys_; }
+
+  /** @return the key expressions of the right side */
+  const std::vector<const AbstractExpression *> &GetRightKeys() const { return right_keys_; }
+
+  /** @return the kind of join */
+  JoinType GetJoinType() const { return join_type_; }
+
+ private:
+  /** The key expressions of both sides. */
+  std::vector<const AbstractExpression *> left_keys_;
+  std::vector<const AbstractExpression *> right_keys_;
+  JoinType join_type_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// repartition_plan.h
+//
+// Identification: src/include/execution/plans/repartition_plan.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "execution/expressions/abstract_expression.h"
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+
+/**
+ * RepartitionPlanNode is an exchange between the workers of a gather: it
+ * sends each tuple of its child to the worker picked by the hash of its keys,
+ * so that all the tuples with equal keys meet in one worker. A join or an
+ * aggregation on the same keys above it then runs in every worker on
+ * disjoint tuples.
+ *
+ * The child must split its input among the workers, with a parallel scan,
+ * or every worker sends all of it. Keys that are compared with each other,
+ * such as the keys of two sides of a join, must both be integers or have the
+ * same type. Outside of a gather, the tuples of the child pass through.
+ */
+class RepartitionPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Creates a new repartition plan node.
+   * @param output_schema the output format of this repartition node, the one of the child
+   * @param child the child plan whose tuples are sent to the workers
+   * @param keys the expressions whose values pick the worker of a tuple
+   */
+  RepartitionPlanNode(const Schema *output_schema, const AbstractPlanNode *child,
+                      std::vector<const AbstractExpression *> &&keys)
+      : AbstractPlanNode(output_schema, {child}), keys_(std::move(keys)) {}
+
+  PlanType GetType() const override { return PlanType::Repartition; }
+
+  /** @return the child plan whose tuples are sent to the workers */
+  const AbstractPlanNode *GetChildPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 1, "Repartition should have exactly one child plan.");
+    return GetChildAt(0);
+  }
+
+  /** @return the expressions whose values pick the worker of a tuple */
+  const std::vector<const AbstractExpression *> &GetKeys() const { return keys_; }
+
+ private:
+  std::vector<const AbstractExpression *> keys_;
+};
+
+}  // namespace bustub
@@ -19,6 +19,9 @@
 namespace bustub {
 /**
  * SeqScanPlanNode identifies a table that should be scanned with an optional predicate.
+ *
+ * Below a gather exchange, every worker runs the scan. A parallel scan splits the pages of the table among the
+ * workers, the others scan all of it in every worker.
  */
 class SeqScanPlanNode : public AbstractPlanNode {
  public:
@@ -27,9 +30,11 @@ class SeqScanPlanNode : public AbstractPlanNode {
    * @param output the output format of this scan plan node
    * @param predicate the predicate to scan with, tuples are returned if predicate(tuple) = true or predicate = nullptr
    * @param table_oid the identifier of table to be scanned
+   * @param parallel whether the workers of a gather exchange split the pages of the table among themselves
    */
-  SeqScanPlanNode(const Schema *output, const AbstractExpression *predicate, table_oid_t table_oid)
-      : AbstractPlanNode(output, {}), predicate_{predicate}, table_oid_(table_oid) {}
+  SeqScanPlanNode(const Schema *output, const AbstractExpression *predicate, table_oid_t table_oid,
+                  bool parallel = false)
+      : AbstractPlanNode(output, {}), predicate_{predicate}, table_oid_(table_oid), parallel_(parallel) {}
 
   PlanType GetType() const override { return PlanType::SeqScan; }
 
@@ -39,11 +44,16 @@ class SeqScanPlanNode : public AbstractPlanNode {
   /** @return the identifier of the table that should be scanned */
   table_oid_t GetTableOid() const { return table_oid_; }
 
+  /** @return whether the workers of a gather exchange split the pages of the table among themselves */
+  bool IsParallel() const { return parallel_; }
+
  private:
   /** The predicate that all returned tuples must satisfy. */
   const AbstractExpression *predicate_;
   /** The table whose tuples should be scanned. */
   table_oid_t table_oid_;
+  /** Whether the workers of a gather exchange each scan some of the pages. */
+  bool parallel_;
 };
 
 }  // namespace bustub
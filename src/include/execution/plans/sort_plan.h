@@ -0,0 +1,63 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_plan.h
+//
+// Identification: src/include/execution/plans/sort_plan.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "execution/expressions/abstract_expression.h"
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+
+/** OrderByType is the direction of one ORDER BY key. */
+enum class OrderByType { ASC, DESC };
+
+/**
+ * SortPlanNode orders the tuples of its child by a list of keys (ORDER BY). The tuples come out unchanged, so the
+ * output schema is the output schema of the child.
+ */
+class SortPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Creates a new sort plan node.
+   * @param output_schema the output schema of the child
+   * @param child the child plan to obtain tuples from
+   * @param order_bys the keys to sort by, the first one first, each an expression on the child's tuples
+   * @param memory_budget the bytes of tuples sorted in memory before a sorted run is spilled to temporary pages, 0
+   * if all tuples are sorted in memory
+   */
+  SortPlanNode(const Schema *output_schema, const AbstractPlanNode *child,
+               std::vector<std::pair<OrderByType, const AbstractExpression *>> &&order_bys, size_t memory_budget = 0)
+      : AbstractPlanNode(output_schema, {child}), order_bys_(std::move(order_bys)), memory_budget_(memory_budget) {}
+
+  PlanType GetType() const override { return PlanType::Sort; }
+
+  /** @return the child plan node of the sort */
+  const AbstractPlanNode *GetChildPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 1, "Sort should have exactly one child plan.");
+    return GetChildAt(0);
+  }
+
+  /** @return the keys to sort by */
+  const std::vector<std::pair<OrderByType, const AbstractExpression *>> &GetOrderBy() const { return order_bys_; }
+
+  /** @return the bytes the sort may hold in memory, 0 if unlimited */
+  size_t GetMemoryBudget() const { return memory_budget_; }
+
+ private:
+  std::vector<std::pair<OrderByType, const AbstractExpression *>> order_bys_;
+  size_t memory_budget_;
+};
+
+}  // namespace bustub
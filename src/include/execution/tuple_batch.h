@@ -0,0 +1,94 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_batch.h
+//
+// Identification: src/include/execution/tuple_batch.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/rid.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * TupleBatch holds up to a fixed number of tuples of one schema, column by
+ * column: column i of the batch is the vector of the values of column i of
+ * every tuple. Executors that work on batches evaluate an expression once
+ * per batch over whole columns instead of once per tuple.
+ *
+ * A batch is reused from call to call, Clear keeps the memory of the columns.
+ */
+class TupleBatch {
+ public:
+  /** Number of tuples in a batch unless asked otherwise. */
+  static constexpr uint32_t DEFAULT_CAPACITY = 1024;
+
+  /**
+   * @param schema the schema of the tuples, can be nullptr until the first Reset
+   * @param capacity the largest number of tuples in the batch
+   */
+  explicit TupleBatch(const Schema *schema = nullptr, uint32_t capacity = DEFAULT_CAPACITY);
+
+  /** Empties the batch and switches it to tuples of another schema. */
+  void Reset(const Schema *schema);
+
+  /** Empties the batch. */
+  void Clear();
+
+  /** Adds a tuple, split into the columns of the schema of the batch. */
+  void Append(const Tuple &tuple, const RID &rid);
+
+  /** Adds a tuple given as one value per column. */
+  void Append(const std::vector<Value> &values, const RID &rid);
+
+  /**
+   * Adds the tuples of another batch with the same columns, from row begin on, until this batch is full.
+   * @return the row of other after the last one added
+   */
+  uint32_t AppendFrom(const TupleBatch &other, uint32_t begin);
+
+  /**
+   * Keeps only the tuples whose predicate value is true, in their order.
+   * @param predicate one boolean value per tuple
+   */
+  void Filter(const std::vector<Value> &predicate);
+
+  /**
+   * Replaces the columns of the batch, for executors that compute a whole batch at once.
+   * @param columns one vector per column of the schema, all as long as rids
+   * @param rids the rid of every tuple
+   */
+  void SetColumns(std::vector<std::vector<Value>> *columns, std::vector<RID> *rids);
+
+  /** @return the tuple at row, put back together from the columns */
+  Tuple GetTuple(uint32_t row) const;
+
+  const Value &GetValue(uint32_t row, uint32_t column) const { return columns_[column][row]; }
+  const std::vector<Value> &GetColumn(uint32_t column) const { return columns_[column]; }
+  const RID &GetRid(uint32_t row) const { return rids_[row]; }
+  const Schema *GetSchema() const { return schema_; }
+
+  uint32_t GetNumRows() const { return static_cast<uint32_t>(rids_.size()); }
+  uint32_t GetCapacity() const { return capacity_; }
+  bool IsEmpty() const { return rids_.empty(); }
+  bool IsFull() const { return rids_.size() >= capacity_; }
+
+ private:
+  const Schema *schema_;
+  uint32_t capacity_;
+  std::vector<std::vector<Value>> columns_;
+  std::vector<RID> rids_;
+};
+
+}  // namespace bustub
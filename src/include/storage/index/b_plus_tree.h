@@ -10,12 +10,18 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <atomic>
+#include <mutex>  // NOLINT
 #include <queue>
+#include <set>
 #include <string>
+#include <thread>  // NOLINT
 #include <vector>
 
+#include "common/rwlatch.h"
 #include "concurrency/transaction.h"
 #include "storage/index/index_iterator.h"
+#include "storage/index/index_statistics.h"
 #include "storage/page/b_plus_tree_internal_page.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
 
@@ -32,6 +38,8 @@ namespace bustub {
  * (2) support insert & remove
  * (3) The structure should shrink and grow dynamically
  * (4) Implement index iterator for range scan
+ * (5) Lookups and scans share a tree-wide latch, changes to the tree take it
+ *     exclusively
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTree {
@@ -42,23 +50,56 @@ class BPlusTree {
   explicit BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
                      int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE);
 
+  ~BPlusTree();
+
   // Returns true if this B+ tree has no keys and values.
   bool IsEmpty() const;
 
   // Insert a key-value pair into this B+ tree.
   bool Insert(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
 
-  // Remove a key and its value from this B+ tree.
-  void Remove(const KeyType &key, Transaction *transaction = nullptr);
+  // Remove a key and its value from this B+ tree, return false if the key was not there.
+  bool Remove(const KeyType &key, Transaction *transaction = nullptr);
+
+  // In lazy remove mode, Remove only records leaves that became underfull instead of merging them right away.
+  // Turning the mode off merges everything still pending.
+  void SetLazyRemove(bool lazy_remove);
+
+  // Merge or redistribute up to max_leaves recorded underfull leaves, return how many were processed.
+  size_t MergeUnderfullLeaves(size_t max_leaves = INDEX_MERGE_BATCH_SIZE);
+
+  // Run MergeUnderfullLeaves every index_merge_interval on a background thread, backing off while removes run.
+  void StartBackgroundMerge();
+  void StopBackgroundMerge();
+
+  // Number of leaves recorded by lazy removes and not merged yet.
+  size_t GetNumUnderfullLeaves();
 
   // return the value associated with a given key
   bool GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction = nullptr);
 
+  // return the values associated with a batch of keys, descending the tree once for the whole batch
+  void GetValues(const std::vector<KeyType> &keys, std::vector<std::vector<ValueType>> *results,
+                 Transaction *transaction = nullptr);
+
+  // Fill in the shape fields of stats and sample the keys of up to max_sample_leaves leaves, in key order. If leaf_ends
+  // is given, it receives the end offset in sample of every sampled leaf.
+  void SampleLeaves(size_t max_sample_leaves, IndexStatistics *stats, std::vector<KeyType> *sample,
+                    std::vector<size_t> *leaf_ends = nullptr);
+
   // index iterator
   INDEXITERATOR_TYPE begin();
   INDEXITERATOR_TYPE Begin(const KeyType &key);
+  INDEXITERATOR_TYPE Begin(const KeyType &low, const KeyType &high, bool low_inclusive = true,
+                           bool high_inclusive = false);
   INDEXITERATOR_TYPE end();
 
+  // reverse index iterator, compares equal to end() once exhausted
+  INDEXITERATOR_TYPE rbegin();
+  INDEXITERATOR_TYPE RBegin(const KeyType &key);
+  INDEXITERATOR_TYPE RBegin(const KeyType &low, const KeyType &high, bool low_inclusive = true,
+                            bool high_inclusive = false);
+
   void Print(BufferPoolManager *bpm) {
     ToString(reinterpret_cast<BPlusTreePage *>(bpm->FetchPage(root_page_id_)->GetData()), bpm);
   }
@@ -71,13 +112,28 @@ class BPlusTree {
     out.close();
   }
 
+  // Copy out the leaf holding the first key at or after key (the last key at or before it when reverse), skipping
+  // key itself unless inclusive, or the first/last leaf if key is nullptr, along with the id of the leaf after it
+  // and the modification count of the tree. Used by the index iterator to seek without holding pins. Returns false
+  // if there is no such key.
+  bool ReadLeaf(const KeyType *key, bool inclusive, bool reverse, page_id_t *page_id, page_id_t *sibling_id,
+                uint64_t *version, std::vector<MappingType> *entries, int *index);
+
+  // Copy out the leaf *page_id, or the first non-empty one after it, along with the id of the leaf after that, if
+  // the tree has not been modified since version; *page_id is INVALID_PAGE_ID past the last leaf. Used by the index
+  // iterator to follow the sibling links of an unchanged tree. Returns false, leaving everything untouched, if the
+  // tree has been modified.
+  bool ReadSiblingLeaf(uint64_t version, bool reverse, page_id_t *page_id, page_id_t *sibling_id,
+                       std::vector<MappingType> *entries, int *index);
+
   // read data from file and insert one by one
   void InsertFromFile(const std::string &file_name, Transaction *transaction = nullptr);
 
   // read data from file and remove one by one
   void RemoveFromFile(const std::string &file_name, Transaction *transaction = nullptr);
-  // expose for test purpose
+  // expose for test purpose, the caller must hold the tree latch
   Page *FindLeafPage(const KeyType &key, bool leftMost = false);
+  Page *FindRightMostLeafPage();
 
  private:
   void StartNewTree(const KeyType &key, const ValueType &value);
@@ -102,6 +158,19 @@ class BPlusTree {
 
   bool AdjustRoot(BPlusTreePage *node);
 
+  void DeletePage(page_id_t page_id);
+
+  bool IsLiveLeaf(page_id_t page_id, BPlusTreePage *node);
+
+  void SetPrevPageId(page_id_t page_id, page_id_t prev_page_id);
+
+  void RunBackgroundMerge();
+
+  int ChildIndex(const InternalPage *node, const KeyType &key) const;
+
+  INDEXITERATOR_TYPE MakeIterator(const KeyType *key, bool inclusive, bool reverse, const KeyType *stop_key,
+                                  bool stop_inclusive);
+
   void UpdateRootPageId(int insert_record = 0);
 
   /* Debug Routines for FREE!! */
@@ -111,11 +180,25 @@ class BPlusTree {
 
   // member variable
   std::string index_name_;
-  page_id_t root_page_id_;
+  // read without the tree latch by IsEmpty
+  std::atomic<page_id_t> root_page_id_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
   int leaf_max_size_;
   int internal_max_size_;
+
+  // shared by lookups and iterator steps, exclusive for Insert, Remove and MergeUnderfullLeaves
+  ReaderWriterLatch tree_latch_;
+  std::atomic<bool> lazy_remove_{false};
+  // leaves left underfull by lazy removes
+  std::mutex underfull_latch_;
+  std::set<page_id_t> underfull_leaves_;
+  // bumped on every Remove, the background merge backs off while it moves
+  std::atomic<uint64_t> remove_count_{0};
+  // bumped under the exclusive tree latch by every operation that may change the leaves
+  uint64_t modify_count_{0};
+  std::atomic<bool> enable_background_merge_{false};
+  std::thread background_merge_thread_;
 };
 
 }  // namespace bustub
@@ -33,12 +33,25 @@ class BPlusTreeIndex : public Index {
 
   void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
 
+  void ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *result,
+                Transaction *transaction) override;
+
+  bool CollectStatistics(IndexStatistics *stats, size_t sample_leaves) override;
+
   INDEXITERATOR_TYPE GetBeginIterator();
 
   INDEXITERATOR_TYPE GetBeginIterator(const KeyType &key);
 
+  INDEXITERATOR_TYPE GetBeginIterator(const KeyType &low, const KeyType &high, bool low_inclusive = true,
+                                      bool high_inclusive = false);
+
   INDEXITERATOR_TYPE GetEndIterator();
 
+  INDEXITERATOR_TYPE GetReverseBeginIterator();
+
+  INDEXITERATOR_TYPE GetReverseBeginIterator(const KeyType &low, const KeyType &high, bool low_inclusive = true,
+                                             bool high_inclusive = false);
+
  protected:
   // comparator for key
   KeyComparator comparator_;
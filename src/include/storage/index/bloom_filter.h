@@ -0,0 +1,79 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// bloom_filter.h
+//
+// Identification: src/include/storage/index/bloom_filter.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>  // NOLINT
+
+namespace bustub {
+
+/**
+ * BloomFilter is an in-memory counting Bloom filter over 64-bit key hashes,
+ * kept next to an index so that lookups of absent keys can skip the index.
+ *
+ * The filter is split into blocks of 256 bits, each block one half of a
+ * cache line. A key sets one bit in each of the 8 32-bit words of a single
+ * block, so a lookup reads one block only. Every bit has an 8-bit counter of
+ * the keys that set it, which lets Remove clear the bit when the last one is
+ * gone. A counter that reaches its maximum sticks, its bit stays set.
+ *
+ * MayContain takes no latch. Insert and Remove of the same block are
+ * serialized on one of a fixed set of stripe latches.
+ */
+class BloomFilter {
+ public:
+  /** Default filter size per expected key, about 1% false positives. */
+  static constexpr size_t DEFAULT_BITS_PER_KEY = 10;
+  static constexpr size_t BLOCK_WORDS = 8;
+  static constexpr size_t BLOCK_BITS = BLOCK_WORDS * 32;
+
+  /**
+   * @param expected_entries number of keys the filter is sized for, more keys raise the false positive rate
+   * @param bits_per_key filter bits per expected key
+   */
+  explicit BloomFilter(size_t expected_entries, size_t bits_per_key = DEFAULT_BITS_PER_KEY);
+
+  /** Add a key. */
+  void Insert(uint64_t hash);
+
+  /** Remove a key that was added before. Removing a key that was never added can cause false negatives. */
+  void Remove(uint64_t hash);
+
+  /** @return false if the key was certainly not added, true if it may have been */
+  bool MayContain(uint64_t hash) const;
+
+  /** @return size of the filter in bits */
+  size_t GetNumBits() const { return num_blocks_ * BLOCK_BITS; }
+
+ private:
+  static constexpr size_t NUM_STRIPES = 64;
+  static constexpr uint8_t MAX_COUNT = UINT8_MAX;
+
+  // the block of a key, from the high half of the hash
+  size_t BlockOf(uint64_t hash) const {
+    return static_cast<size_t>(((hash >> 32) * static_cast<uint64_t>(num_blocks_)) >> 32);
+  }
+
+  // the bit of the key in each word of its block, from the low half of the hash
+  static std::array<uint32_t, BLOCK_WORDS> BitsOf(uint64_t hash);
+
+  size_t num_blocks_;
+  std::unique_ptr<std::atomic<uint32_t>[]> words_;
+  std::unique_ptr<uint8_t[]> counters_;
+  std::array<std::mutex, NUM_STRIPES> stripe_latches_;
+};
+
+}  // namespace bustub
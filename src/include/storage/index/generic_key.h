@@ -13,7 +13,9 @@
 #pragma once
 
 #include <cstring>
+#include <type_traits>
 
+#include "common/util/hashers.h"
 #include "storage/table/tuple.h"
 #include "type/value.h"
 
@@ -70,6 +72,15 @@ class GenericKey {
   char data_[KeySize];
 };
 
+/**
+ * Generic keys that fit in a word, such as one integer column, are hashed
+ * like integers: a multiply beats a CRC over so few bytes.
+ */
+template <size_t KeySize>
+struct DefaultHasher<GenericKey<KeySize>, std::enable_if_t<KeySize <= sizeof(uint64_t)>> {
+  using type = MultiplyShiftHasher;
+};
+
 /**
  * Function object returns true if lhs < rhs, used for trees
  */
@@ -12,12 +12,16 @@
 
 #pragma once
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "catalog/schema.h"
+#include "common/util/hashers.h"
+#include "storage/index/bloom_filter.h"
+#include "storage/index/index_statistics.h"
 #include "storage/table/tuple.h"
 #include "type/value.h"
 
@@ -37,12 +41,21 @@ class IndexMetadata {
   IndexMetadata() = delete;
 
   IndexMetadata(std::string index_name, std::string table_name, const Schema *tuple_schema,
-                std::vector<uint32_t> key_attrs)
-      : name_(std::move(index_name)), table_name_(std::move(table_name)), key_attrs_(std::move(key_attrs)) {
+                std::vector<uint32_t> key_attrs, std::vector<uint32_t> included_attrs = {})
+      : name_(std::move(index_name)),
+        table_name_(std::move(table_name)),
+        key_attrs_(std::move(key_attrs)),
+        included_attrs_(std::move(included_attrs)) {
     key_schema_ = Schema::CopySchema(tuple_schema, key_attrs_);
+    entry_attrs_ = key_attrs_;
+    entry_attrs_.insert(entry_attrs_.end(), included_attrs_.begin(), included_attrs_.end());
+    entry_schema_ = Schema::CopySchema(tuple_schema, entry_attrs_);
   }
 
-  ~IndexMetadata() { delete key_schema_; }
+  ~IndexMetadata() {
+    delete key_schema_;
+    delete entry_schema_;
+  }
 
   inline const std::string &GetName() const { return name_; }
 
@@ -60,6 +73,17 @@ class IndexMetadata {
   //  columns
   inline const std::vector<uint32_t> &GetKeyAttrs() const { return key_attrs_; }
 
+  // Returns the base table columns stored in each entry after the key columns,
+  // they are not compared but let an index scan answer a query without the table
+  inline const std::vector<uint32_t> &GetIncludedAttrs() const { return included_attrs_; }
+
+  // Returns the key columns followed by the included columns
+  inline const std::vector<uint32_t> &GetEntryAttrs() const { return entry_attrs_; }
+
+  // Returns a schema object pointer that represents a whole index entry. The key
+  // columns are a prefix of it, so an entry can be compared as a key.
+  inline Schema *GetEntrySchema() const { return entry_schema_; }
+
   // Get a string representation for debugging
   std::string ToString() const {
     std::stringstream os;
@@ -68,7 +92,7 @@ class IndexMetadata {
        << "Name = " << name_ << ", "
        << "Type = B+Tree, "
        << "Table name = " << table_name_ << "] :: ";
-    os << key_schema_->ToString();
+    os << entry_schema_->ToString();
 
     return os.str();
   }
@@ -78,8 +102,14 @@ class IndexMetadata {
   std::string table_name_;
   // The mapping relation between key schema and tuple schema
   const std::vector<uint32_t> key_attrs_;
+  // The non-key table columns copied into every entry
+  const std::vector<uint32_t> included_attrs_;
+  // key_attrs_ followed by included_attrs_
+  std::vector<uint32_t> entry_attrs_;
   // schema of the indexed key
   Schema *key_schema_;
+  // schema of an entry, the key followed by the included columns
+  Schema *entry_schema_;
 };
 
 /////////////////////////////////////////////////////////////////////
@@ -117,6 +147,23 @@ class Index {
 
   const std::vector<uint32_t> &GetKeyAttrs() const { return metadata_->GetKeyAttrs(); }
 
+  const std::vector<uint32_t> &GetIncludedAttrs() const { return metadata_->GetIncludedAttrs(); }
+
+  Schema *GetEntrySchema() const { return metadata_->GetEntrySchema(); }
+
+  const std::vector<uint32_t> &GetEntryAttrs() const { return metadata_->GetEntryAttrs(); }
+
+  // True if every base table column in columns is stored in the index entries
+  bool Covers(const std::vector<uint32_t> &columns) const {
+    const auto &entry_attrs = GetEntryAttrs();
+    for (auto column : columns) {
+      if (std::find(entry_attrs.begin(), entry_attrs.end(), column) == entry_attrs.end()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
   // Get a string representation for debugging
   std::string ToString() const {
     std::stringstream os;
@@ -129,7 +176,8 @@ class Index {
   ///////////////////////////////////////////////////////////////////
   // Point Modification
   ///////////////////////////////////////////////////////////////////
-  // designed for secondary indexes.
+  // designed for secondary indexes. key is laid out by the entry schema, the
+  // included columns (if any) following the key columns.
   virtual void InsertEntry(const Tuple &key, RID rid, Transaction *transaction) = 0;
 
   // delete the index entry linked to given tuple
@@ -137,6 +185,51 @@ class Index {
 
   virtual void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) = 0;
 
+  // prepare for num_entries entries about to be inserted, such as the rows of a table an index is built over.
+  // indexes that can size themselves up front should override this.
+  virtual void ReserveEntries(size_t num_entries) {}
+
+  // insert a batch of entries, such as all the rows of a table an index is built over. indexes that load a
+  // batch faster than entry by entry should override this.
+  virtual void InsertEntries(const std::vector<Tuple> &keys, const std::vector<RID> &rids, Transaction *transaction) {
+    for (size_t i = 0; i < keys.size(); i++) {
+      InsertEntry(keys[i], rids[i], transaction);
+    }
+  }
+
+  // point query for a batch of keys, (*result)[i] holds the matches of keys[i].
+  // indexes that can share work across keys should override this.
+  virtual void ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *result,
+                        Transaction *transaction) {
+    result->assign(keys.size(), std::vector<RID>());
+    for (size_t i = 0; i < keys.size(); i++) {
+      ScanKey(keys[i], &(*result)[i], transaction);
+    }
+  }
+
+  // collect shape and key distribution statistics, returns false if this index type does not support them
+  virtual bool CollectStatistics(IndexStatistics *stats, size_t sample_leaves) { return false; }
+
+  // keep a Bloom filter of the keys in memory, so that point queries for absent keys skip the index. Enable it
+  // while the index is empty, keys inserted before are not in the filter.
+  void EnableBloomFilter(size_t expected_entries, size_t bits_per_key = BloomFilter::DEFAULT_BITS_PER_KEY) {
+    bloom_filter_ = std::make_unique<BloomFilter>(expected_entries, bits_per_key);
+  }
+
+  BloomFilter *GetBloomFilter() const { return bloom_filter_.get(); }
+
+ protected:
+  // hash of the key columns of an index key for the Bloom filter. Included columns that follow the key columns
+  // are left out, point queries do not know them.
+  template <typename KeyType>
+  uint64_t BloomFilterHash(const KeyType &index_key) const {
+    size_t key_length = std::min<size_t>(GetKeySchema()->GetLength(), sizeof(KeyType));
+    return DefaultHasher<KeyType>::type::Hash(&index_key, key_length);
+  }
+
+  // in-memory Bloom filter of the keys, nullptr unless enabled
+  std::unique_ptr<BloomFilter> bloom_filter_;
+
  private:
   //===--------------------------------------------------------------------===//
   //  Data members
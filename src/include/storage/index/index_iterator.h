@@ -13,18 +13,64 @@
  * For range scan of b+ tree
  */
 #pragma once
+#include <vector>
+
 #include "storage/page/b_plus_tree_leaf_page.h"
 
 namespace bustub {
 
 #define INDEXITERATOR_TYPE IndexIterator<KeyType, ValueType, KeyComparator>
 
+INDEX_TEMPLATE_ARGUMENTS
+class BPlusTree;
+
+/**
+ * Iterates over the key/value pairs of the leaf level, either forward along
+ * the next-page links or backward along the prev-page links.
+ *
+ * The iterator holds a copy of the entries of its current leaf and no pin or
+ * latch between calls, so that the tree can change under it. Moving past the
+ * copied entries follows the sibling link saved with the copy if the tree has
+ * not been modified since, and otherwise looks up the leaf that now follows
+ * the last key returned; both under the tree's read latch. A bounded iterator
+ * stops by itself at the first key past its stop key and then compares equal
+ * to end().
+ */
 INDEX_TEMPLATE_ARGUMENTS
 class IndexIterator {
+  using Tree = BPlusTree<KeyType, ValueType, KeyComparator>;
+
  public:
-  // you may define your own constructor based on your member variables
+  // end iterator
   IndexIterator();
-  ~IndexIterator();
+
+  /**
+   * @param tree the tree iterated over
+   * @param page_id the leaf the entries were copied from
+   * @param sibling_id the leaf after it in the iteration direction
+   * @param version the modification count of the tree when the entries were copied
+   * @param entries the entries of the leaf
+   * @param index the entry to start from
+   * @param reverse iterate towards smaller keys
+   */
+  IndexIterator(Tree *tree, page_id_t page_id, page_id_t sibling_id, uint64_t version,
+                std::vector<MappingType> entries, int index, bool reverse = false);
+
+  /**
+   * Same as above, but stop at stop_key. Keys past stop_key (greater for a
+   * forward iterator, smaller for a reverse one), or equal to it when
+   * stop_inclusive is false, are never returned.
+   */
+  IndexIterator(Tree *tree, page_id_t page_id, page_id_t sibling_id, uint64_t version,
+                std::vector<MappingType> entries, int index, bool reverse, const KeyComparator *comparator,
+                const KeyType &stop_key, bool stop_inclusive);
+
+  IndexIterator(IndexIterator &&other) noexcept = default;
+  IndexIterator &operator=(IndexIterator &&other) noexcept = default;
+  IndexIterator(const IndexIterator &other) = delete;
+  IndexIterator &operator=(const IndexIterator &other) = delete;
+
+  ~IndexIterator() = default;
 
   bool isEnd();
 
@@ -32,12 +78,32 @@ class IndexIterator {
 
   IndexIterator &operator++();
 
-  bool operator==(const IndexIterator &itr) const { throw std::runtime_error("unimplemented"); }
+  bool operator==(const IndexIterator &itr) const {
+    if (tree_ == nullptr || itr.tree_ == nullptr) {
+      return tree_ == itr.tree_;
+    }
+    return page_id_ == itr.page_id_ && index_ == itr.index_;
+  }
 
-  bool operator!=(const IndexIterator &itr) const { throw std::runtime_error("unimplemented"); }
+  bool operator!=(const IndexIterator &itr) const { return !(*this == itr); }
 
  private:
-  // add your own private member variables here
+  // end the iteration if the current key is past the stop key
+  void CheckStop();
+
+  // the tree, nullptr once the iteration has ended
+  Tree *tree_{nullptr};
+  page_id_t page_id_{INVALID_PAGE_ID};
+  page_id_t sibling_id_{INVALID_PAGE_ID};
+  uint64_t version_{0};
+  std::vector<MappingType> entries_;
+  int index_{0};
+  bool reverse_{false};
+
+  // stop condition, unbounded if comparator_ is nullptr
+  const KeyComparator *comparator_{nullptr};
+  KeyType stop_key_{};
+  bool stop_inclusive_{false};
 };
 
 }  // namespace bustub
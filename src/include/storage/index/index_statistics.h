@@ -0,0 +1,85 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_statistics.h
+//
+// Identification: src/include/storage/index/index_statistics.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * One bucket of an equi-depth histogram. Buckets are ordered; a bucket holds
+ * the keys greater than the previous bucket's upper bound and not greater
+ * than its own.
+ */
+struct HistogramBucket {
+  HistogramBucket(Value upper_bound, uint64_t count) : upper_bound_(std::move(upper_bound)), count_(count) {}
+
+  /** The largest value of the first key column that falls in this bucket. */
+  Value upper_bound_;
+  /** Estimated number of index entries in this bucket. */
+  uint64_t count_;
+};
+
+/**
+ * IndexStatistics describes the shape and the key distribution of an index,
+ * for the optimizer to cost index scans against sequential scans.
+ *
+ * The shape is exact for internal pages and estimated for leaves; the key
+ * distribution (histogram and distinct count, on the first key column) is
+ * estimated from a sample of leaves.
+ */
+class IndexStatistics {
+ public:
+  /** Number of leaves sampled when collecting statistics. */
+  static constexpr size_t DEFAULT_SAMPLE_LEAVES = 64;
+  /** Number of buckets in the equi-depth histogram. */
+  static constexpr size_t DEFAULT_HISTOGRAM_BUCKETS = 16;
+
+  /**
+   * Compute the distinct count and the histogram from sampled key values.
+   * @param sample values of the first key column, in ascending order
+   * @param run_ends end offsets in sample of the runs of consecutive index entries, one run per sampled leaf
+   * @param unique true if the first key column is the whole key, so that every entry has a distinct value
+   * @param num_buckets maximum number of histogram buckets
+   */
+  void BuildFromSample(const std::vector<Value> &sample, const std::vector<size_t> &run_ends, bool unique,
+                       size_t num_buckets = DEFAULT_HISTOGRAM_BUCKETS);
+
+  /**
+   * Estimate the fraction of index entries whose first key column lies in [low, high].
+   * @return selectivity in [0, 1], 1 if no histogram has been built
+   */
+  double EstimateSelectivity(const Value &low, const Value &high) const;
+
+  /** True once statistics have been collected. */
+  bool valid_{false};
+  /** Number of levels, 1 for a tree that is a single leaf. */
+  uint32_t height_{0};
+  uint64_t internal_page_count_{0};
+  uint64_t leaf_page_count_{0};
+  /** Estimated number of entries. */
+  uint64_t num_entries_{0};
+  /** Average leaf occupancy, in [0, 1]. */
+  double fill_factor_{0};
+  /** Estimated number of distinct values of the first key column. */
+  uint64_t distinct_keys_{0};
+  /** The smallest sampled value of the first key column, the lower bound of the first histogram bucket. */
+  Value lower_bound_;
+  std::vector<HistogramBucket> histogram_;
+};
+
+}  // namespace bustub
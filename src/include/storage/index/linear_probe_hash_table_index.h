@@ -16,15 +16,21 @@
 #include <string>
 #include <vector>
 
+#include "container/hash/extendible_hash_table.h"
 #include "container/hash/hash_function.h"
 #include "container/hash/linear_probe_hash_table.h"
 #include "storage/index/index.h"
 
 namespace bustub {
 
-#define HASH_TABLE_INDEX_TYPE LinearProbeHashTableIndex<KeyType, ValueType, KeyComparator>
+#define HASH_TABLE_INDEX_TYPE LinearProbeHashTableIndex<KeyType, ValueType, KeyComparator, HashTableType>
 
-template <typename KeyType, typename ValueType, typename KeyComparator>
+/**
+ * Hash index over a disk-backed hash table. The table is a linear probing
+ * one by default, ExtendibleHashTableIndex uses an extendible hash table.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator,
+          typename HashTableType = LinearProbeHashTable<KeyType, ValueType, KeyComparator>>
 class LinearProbeHashTableIndex : public Index {
  public:
   LinearProbeHashTableIndex(IndexMetadata *metadata, BufferPoolManager *buffer_pool_manager, size_t num_buckets,
@@ -38,11 +44,20 @@ class LinearProbeHashTableIndex : public Index {
 
   void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
 
+  // a linear probing table is sized up front and bulk loaded, in parallel across its block pages
+  void ReserveEntries(size_t num_entries) override;
+
+  void InsertEntries(const std::vector<Tuple> &keys, const std::vector<RID> &rids, Transaction *transaction) override;
+
  protected:
   // comparator for key
   KeyComparator comparator_;
   // container
-  LinearProbeHashTable<KeyType, ValueType, KeyComparator> container_;
+  HashTableType container_;
 };
 
+template <typename KeyType, typename ValueType, typename KeyComparator>
+using ExtendibleHashTableIndex =
+    LinearProbeHashTableIndex<KeyType, ValueType, KeyComparator, ExtendibleHashTable<KeyType, ValueType, KeyComparator>>;
+
 }  // namespace bustub
@@ -13,6 +13,7 @@
 #pragma once
 
 #include <atomic>
+#include <cstdint>
 #include <utility>
 #include <vector>
 
@@ -32,6 +33,9 @@ namespace bustub {
  *
  *  Here '+' means concatenation.
  *
+ * Every slot also has a one byte tag taken from the hash of its key. A probe
+ * compares the tags of TAG_GROUP_SIZE slots at once with SIMD instructions
+ * and only runs the key comparator on the slots whose tag matches.
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class HashTableBlockPage {
@@ -55,20 +59,32 @@ class HashTableBlockPage {
    */
   ValueType ValueAt(slot_offset_t bucket_ind) const;
 
+  /**
+   * Copies the pair at an index if it is readable, for readers without the
+   * latch. An insert may reuse a tombstone while the pair is copied, so the
+   * copy is retried until no such overwrite ran during it.
+   *
+   * @param bucket_ind the index in the block to get the pair at
+   * @param[out] pair the pair at index bucket_ind of the block
+   * @return true if the index is readable
+   */
+  bool ReadPair(slot_offset_t bucket_ind, MappingType *pair) const;
+
   /**
    * Attempts to insert a key and value into an index in the block.
-   * The insert is thread safe. It uses compare and swap to claim the index,
-   * and then writes the key and value into the index, and then marks the
-   * index as readable.
+   * Writers must hold the page's write latch. The key and value are written
+   * first and then the index is marked as occupied and readable, so readers
+   * that test IsReadable before KeyAt and ValueAt need no latch. A tombstone
+   * is overwritten in place, readers without the latch see it through ReadPair.
    *
    * @param bucket_ind index to write the key and value to
    * @param key key to insert
    * @param value value to insert
+   * @param tag the tag of the key, TagOf(hash of key)
    * @return If the value is inserted successfully, it returns true. If the
-   * index is marked as occupied before the key and value can be inserted,
-   * Insert returns false.
+   * index already holds a readable pair, Insert returns false.
    */
-  bool Insert(slot_offset_t bucket_ind, const KeyType &key, const ValueType &value);
+  bool Insert(slot_offset_t bucket_ind, const KeyType &key, const ValueType &value, uint8_t tag = 0);
 
   /**
    * Removes a key and value at index.
@@ -93,11 +109,70 @@ class HashTableBlockPage {
    */
   bool IsReadable(slot_offset_t bucket_ind) const;
 
+  /**
+   * @param bucket_ind index to look at
+   * @return the tag stored with the pair at the index
+   */
+  uint8_t TagAt(slot_offset_t bucket_ind) const { return tags_[bucket_ind]; }
+
+  /**
+   * Finds the readable slots of a group whose tag equals tag.
+   *
+   * @param group the group of slots [group * TAG_GROUP_SIZE, (group + 1) * TAG_GROUP_SIZE)
+   * @param tag the tag to look for
+   * @return a mask with bit i set if slot group * TAG_GROUP_SIZE + i matches
+   */
+  uint32_t MatchTag(size_t group, uint8_t tag) const;
+
+  /**
+   * @return a mask with bit i set if slot group * TAG_GROUP_SIZE + i is occupied
+   */
+  uint32_t OccupiedMask(size_t group) const;
+
+  /**
+   * @return a mask with bit i set if slot group * TAG_GROUP_SIZE + i is readable
+   */
+  uint32_t ReadableMask(size_t group) const;
+
+  /**
+   * @return the mask of the slots of a group that exist, all ones except for a trailing partial group
+   */
+  static uint32_t GroupMask(size_t group) {
+    size_t slots = BLOCK_ARRAY_SIZE - group * TAG_GROUP_SIZE;
+    return slots >= TAG_GROUP_SIZE ? ~0U : (1U << slots) - 1;
+  }
+
+  /**
+   * @param hash the full hash of a key
+   * @return the tag of the key, its top byte, which is independent of the low bits that pick a slot
+   */
+  static uint8_t TagOf(uint64_t hash) { return static_cast<uint8_t>(hash >> 56); }
+
+  /**
+   * @return the next page of an extendible hash table bucket's overflow chain, INVALID_PAGE_ID at its end
+   */
+  page_id_t GetNextPageId() const { return next_page_id_; }
+
+  /**
+   * @param next_page_id the next page of the overflow chain
+   */
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
  private:
+  // gather the flag bits of one group from a bitmap
+  static uint32_t GroupBits(const std::atomic_char *bitmap, size_t group);
+
   std::atomic_char occupied_[(BLOCK_ARRAY_SIZE - 1) / 8 + 1];
 
   // 0 if tombstone/brand new (never occupied), 1 otherwise.
   std::atomic_char readable_[(BLOCK_ARRAY_SIZE - 1) / 8 + 1];
+
+  // tag of each slot, padded to whole groups so a group can be loaded at once
+  uint8_t tags_[BLOCK_TAG_GROUPS * TAG_GROUP_SIZE];
+  // overflow chain of an extendible hash table bucket, fits in BLOCK_PAGE_RESERVED
+  page_id_t next_page_id_;
+  // odd while a tombstone is overwritten, ReadPair retries a copy that overlapped an overwrite
+  std::atomic<uint32_t> version_;
   MappingType array_[0];
 };
 
@@ -0,0 +1,117 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_directory_page.h
+//
+// Identification: src/include/storage/page/hash_table_directory_page.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/** Number of directory slots, the directory can grow to a global depth of 9. */
+static constexpr uint32_t DIRECTORY_ARRAY_SIZE = 512;
+/** Largest global depth a directory page can hold. */
+static constexpr uint32_t DIRECTORY_MAX_DEPTH = 9;
+
+/**
+ *
+ * Directory Page for extendible hash table.
+ *
+ * Directory format (size in byte):
+ * ---------------------------------------------------------------------------------------------
+ * | LSN (4) | PageId (4) | GlobalDepth (4) | LocalDepths (512) | BucketPageIds (2048) | Free (1524)
+ * ---------------------------------------------------------------------------------------------
+ *
+ * Slot i of the directory serves the keys whose hash ends with the low
+ * GlobalDepth bits of i. A bucket of local depth d is shared by the
+ * 2^(GlobalDepth - d) slots that agree on the low d bits.
+ */
+class HashTableDirectoryPage {
+ public:
+  /**
+   * @return the page ID of this page
+   */
+  page_id_t GetPageId() const;
+
+  /**
+   * Sets the page ID of this page
+   *
+   * @param page_id the page id for the page id field to be set to
+   */
+  void SetPageId(page_id_t page_id);
+
+  /**
+   * @return the lsn of this page
+   */
+  lsn_t GetLSN() const;
+
+  /**
+   * Sets the LSN of this page
+   *
+   * @param lsn the log sequence number for the lsn field to be set to
+   */
+  void SetLSN(lsn_t lsn);
+
+  /**
+   * @return the number of low hash bits used to pick a directory slot
+   */
+  uint32_t GetGlobalDepth() const;
+
+  /**
+   * @return a mask of GetGlobalDepth() low bits
+   */
+  uint32_t GetGlobalDepthMask() const;
+
+  /**
+   * Doubles the directory, the new upper half pointing to the same buckets as the lower one.
+   */
+  void IncrGlobalDepth();
+
+  /**
+   * Halves the directory, only valid if CanShrink().
+   */
+  void DecrGlobalDepth();
+
+  /**
+   * @return true if every bucket has a local depth below the global depth
+   */
+  bool CanShrink() const;
+
+  /**
+   * @return the number of directory slots in use, 2^GlobalDepth
+   */
+  uint32_t Size() const;
+
+  page_id_t GetBucketPageId(uint32_t bucket_idx) const;
+
+  void SetBucketPageId(uint32_t bucket_idx, page_id_t bucket_page_id);
+
+  uint32_t GetLocalDepth(uint32_t bucket_idx) const;
+
+  void SetLocalDepth(uint32_t bucket_idx, uint32_t local_depth);
+
+  /**
+   * @return the slot of the bucket a split of bucket_idx's bucket would create (or a merge would join),
+   * the slot that differs in the highest bit of the local depth
+   */
+  uint32_t GetSplitImageIndex(uint32_t bucket_idx) const;
+
+ private:
+  lsn_t lsn_;
+  page_id_t page_id_;
+  uint32_t global_depth_;
+  uint8_t local_depths_[DIRECTORY_ARRAY_SIZE];
+  page_id_t bucket_page_ids_[DIRECTORY_ARRAY_SIZE];
+};
+
+}  // namespace bustub
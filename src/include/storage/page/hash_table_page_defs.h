@@ -14,11 +14,19 @@
 
 #define MappingType std::pair<KeyType, ValueType>
 
-/** BLOCK_ARRAY_SIZE is the number of (key, value) pairs that can be stored in   * a block page. It is an approximate
+/** BLOCK_ARRAY_SIZE is the number of (key, value) pairs that can be stored in a block page. It is an approximate
  * calculation based on the size of MappingType (which is a std::pair of KeyType and ValueType). For each key/value
- * pair, we need two additional bits for occupied_ and readable_. 4 * PAGE_SIZE / (4 * sizeof (MappingType) + 1) =
- * PAGE_SIZE/(sizeof (MappingType) + 0.25) because 0.25 bytes = 2 bits is the space required to maintain the occupied
- * and readable flags for a key value pair.*/
-#define BLOCK_ARRAY_SIZE (4 * PAGE_SIZE / (4 * sizeof(MappingType) + 1))
+ * pair, we need two additional bits for occupied_ and readable_ and one byte for its tag. 4 * PAGE_SIZE / (4 * sizeof
+ * (MappingType) + 5) = PAGE_SIZE/(sizeof (MappingType) + 1.25) because 1.25 bytes = 2 bits + 1 byte is the space
+ * required to maintain the flags and the tag of a key value pair. BLOCK_PAGE_RESERVED bytes are kept for rounding the
+ * tag array up to whole groups, the overflow chain link, the overwrite version and alignment.*/
+#define BLOCK_PAGE_RESERVED 64
+#define BLOCK_ARRAY_SIZE (4 * (PAGE_SIZE - BLOCK_PAGE_RESERVED) / (4 * sizeof(MappingType) + 5))
+
+/** Slots whose tags are compared at once by HashTableBlockPage::MatchTag. */
+#define TAG_GROUP_SIZE 32
+
+/** Number of tag groups in a block page. */
+#define BLOCK_TAG_GROUPS ((BLOCK_ARRAY_SIZE - 1) / TAG_GROUP_SIZE + 1)
 
 #define HASH_TABLE_BLOCK_TYPE HashTableBlockPage<KeyType, ValueType, KeyComparator>
@@ -122,6 +122,16 @@ class TablePage : public Page {
    */
   bool GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, LockManager *lock_manager);
 
+  /**
+   * Read a tuple in place, taking the same lock as GetTuple but copying nothing.
+   * @param rid rid of the tuple to read
+   * @param[out] size the size of the tuple
+   * @param txn transaction performing the read
+   * @param lock_manager the lock manager
+   * @return the bytes of the tuple in this page, valid while the page is latched; nullptr if the read failed
+   */
+  const char *ReadTuple(const RID &rid, uint32_t *size, Transaction *txn, LockManager *lock_manager);
+
   /** @return the rid of the first tuple in this page */
 
   /**
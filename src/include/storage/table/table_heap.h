@@ -12,14 +12,21 @@
 
 #pragma once
 
+#include <functional>
+#include <vector>
+
 #include "buffer/buffer_pool_manager.h"
 #include "recovery/log_manager.h"
 #include "storage/page/table_page.h"
 #include "storage/table/table_iterator.h"
 #include "storage/table/tuple.h"
+#include "storage/table/tuple_projection.h"
 
 namespace bustub {
 
+/** A predicate on the bytes of a tuple in a table page. */
+using TupleFilter = std::function<bool(const char *data)>;
+
 /**
  * TableHeap represents a physical table on disk.
  * This is just a doubly-linked list of pages.
@@ -99,6 +106,27 @@ class TableHeap {
    */
   bool GetTuple(const RID &rid, Tuple *tuple, Transaction *txn);
 
+  /**
+   * Read the tuples of a page of the table, latching and pinning the page once. A filter and a projection work on the
+   * tuples in the page, so that only the tuples that pass are copied, and of those only the columns asked for.
+   * @param page_id id of a page of this table
+   * @param[out] tuples emptied, then filled with the tuples of the page that pass the filter
+   * @param txn transaction performing the read
+   * @param filter whether to keep a tuple, given its bytes in the page; nullptr keeps every tuple
+   * @param projection the columns to copy out of the tuples that are kept; nullptr copies whole tuples
+   * @return the id of the next page of this table, INVALID_PAGE_ID after the last page
+   * @throws Exception if the page cannot be brought into the buffer pool
+   */
+  page_id_t ScanPage(page_id_t page_id, std::vector<Tuple> *tuples, Transaction *txn,
+                     const TupleFilter &filter = nullptr, const TupleProjection *projection = nullptr);
+
+  /**
+   * @param page_id id of a page of this table
+   * @return the id of the page after it, INVALID_PAGE_ID after the last page
+   * @throws Exception if the page cannot be brought into the buffer pool
+   */
+  page_id_t GetNextPageId(page_id_t page_id);
+
   /** @return the begin iterator of this table */
   TableIterator Begin(Transaction *txn);
 
@@ -0,0 +1,67 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_morsel_queue.h
+//
+// Identification: src/include/storage/table/table_morsel_queue.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <mutex>  // NOLINT
+
+#include "common/config.h"
+#include "common/macros.h"
+#include "storage/table/table_heap.h"
+
+namespace bustub {
+
+/** A morsel is a range of pages of a table heap: num_pages_ pages that follow each other from first_page_id_ on. */
+struct TableMorsel {
+  page_id_t first_page_id_{INVALID_PAGE_ID};
+  size_t num_pages_{0};
+};
+
+/**
+ * TableMorselQueue splits the pages of a table heap into morsels for the
+ * workers of a parallel scan. A worker takes the next morsel whenever it is
+ * done with its last one, so a faster worker scans more of the table and all
+ * of them finish at about the same time.
+ *
+ * The pages of a table heap form a list, so handing out a morsel reads the
+ * headers of its pages to find where the next morsel starts.
+ */
+class TableMorselQueue {
+ public:
+  /** Number of pages in a morsel unless asked otherwise. */
+  static constexpr size_t DEFAULT_MORSEL_PAGES = 16;
+
+  /**
+   * @param table_heap the table heap whose pages are handed out
+   * @param morsel_pages the number of pages in a morsel, at least 1
+   */
+  explicit TableMorselQueue(TableHeap *table_heap, size_t morsel_pages = DEFAULT_MORSEL_PAGES);
+
+  DISALLOW_COPY_AND_MOVE(TableMorselQueue);
+
+  /**
+   * Takes the next morsel, thread-safe.
+   * @param[out] morsel the pages to scan
+   * @return false if every page was handed out
+   */
+  bool Next(TableMorsel *morsel);
+
+ private:
+  std::mutex latch_;
+  TableHeap *table_heap_;
+  size_t morsel_pages_;
+  /** The first page of the next morsel. */
+  page_id_t next_page_id_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,71 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tmp_tuple_file.h
+//
+// Identification: src/include/storage/table/tmp_tuple_file.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/macros.h"
+#include "storage/page/tmp_tuple_page.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * TmpTupleFile is a list of TmpTuplePages that tuples are appended to, for
+ * executors that spill what does not fit in memory. Only the page being
+ * written is pinned, the others are left to the buffer pool to write out.
+ * The pages are deleted when the file is released or destroyed.
+ */
+class TmpTupleFile {
+ public:
+  explicit TmpTupleFile(BufferPoolManager *bpm) : bpm_(bpm) {}
+
+  TmpTupleFile(TmpTupleFile &&other) noexcept
+      : bpm_(other.bpm_), pages_(std::move(other.pages_)), page_(std::exchange(other.page_, nullptr)) {}
+
+  ~TmpTupleFile() { Release(); }
+
+  DISALLOW_COPY(TmpTupleFile);
+
+  /**
+   * Appends a tuple to the last page of the file, or to a new page if it is full.
+   * @throws Exception if the buffer pool has no free frame, or the tuple is larger than a page
+   */
+  void Append(const Tuple &tuple);
+
+  /** Unpins the page being written, the next Append starts a new page. */
+  void Close();
+
+  /** Deletes the pages of the file. */
+  void Release();
+
+  /**
+   * Reads the tuples of a page of the file.
+   * @param page_index the index of the page in the file
+   * @param[out] tuples the tuples of the page, in the order they were appended
+   */
+  void ReadPage(size_t page_index, std::vector<Tuple> *tuples);
+
+  size_t GetNumPages() const { return pages_.size(); }
+  bool IsEmpty() const { return pages_.empty(); }
+
+ private:
+  BufferPoolManager *bpm_;
+  std::vector<page_id_t> pages_;
+  /** The last page while it is written and pinned, else nullptr. */
+  TmpTuplePage *page_{nullptr};
+};
+
+}  // namespace bustub
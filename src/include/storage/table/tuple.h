@@ -34,6 +34,8 @@ class Tuple {
 
   friend class TableIterator;
 
+  friend class TupleProjection;
+
  public:
   // Default constructor (to create a dummy tuple)
   Tuple() = default;
@@ -44,12 +46,21 @@ class Tuple {
   // constructor for creating a new tuple based on input value
   Tuple(std::vector<Value> values, const Schema *schema);
 
+  // constructor for a tuple over size bytes that it does not own, the bytes must outlive it
+  Tuple(char *data, uint32_t size) : size_(size), data_(data) {}
+
   // copy constructor, deep copy
   Tuple(const Tuple &other);
 
   // assign operator, deep copy
   Tuple &operator=(const Tuple &other);
 
+  // move constructor, takes the data of other, which is left empty
+  Tuple(Tuple &&other) noexcept;
+
+  // move assign operator, takes the data of other, which is left empty
+  Tuple &operator=(Tuple &&other) noexcept;
+
   ~Tuple() {
     if (allocated_) {
       delete[] data_;
@@ -0,0 +1,53 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_projection.h
+//
+// Identification: src/include/storage/table/tuple_projection.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/rid.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * TupleProjection copies some of the columns of a tuple into a tuple of
+ * another schema, byte for byte, without going through a Value per column.
+ * A table scan uses it to copy out of a page only the columns it returns.
+ */
+class TupleProjection {
+ public:
+  /**
+   * @param schema the schema of the tuples projected
+   * @param projected_schema the schema of the projections, column i of the same type as column columns[i] of schema
+   * @param columns the column of schema that every column of projected_schema is copied from
+   */
+  TupleProjection(const Schema *schema, const Schema *projected_schema, std::vector<uint32_t> columns);
+
+  /**
+   * Writes the projection of a tuple.
+   * @param data the bytes of a tuple of the schema, as in a table page
+   * @param rid the rid of the tuple, the projection keeps it
+   * @param[out] tuple the projection
+   */
+  void Project(const char *data, const RID &rid, Tuple *tuple) const;
+
+  const Schema *GetProjectedSchema() const { return projected_schema_; }
+
+ private:
+  const Schema *schema_;
+  const Schema *projected_schema_;
+  std::vector<uint32_t> columns_;
+};
+
+}  // namespace bustub
@@ -9,7 +9,10 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <numeric>
 #include <string>
+#include <type_traits>
 
 #include "common/exception.h"
 #include "common/rid.h"
@@ -27,11 +30,14 @@ BPLUSTREE_TYPE::BPlusTree(std::string name, BufferPoolManager *buffer_pool_manag
       leaf_max_size_(leaf_max_size),
       internal_max_size_(internal_max_size) {}
 
+INDEX_TEMPLATE_ARGUMENTS
+BPLUSTREE_TYPE::~BPlusTree() { StopBackgroundMerge(); }
+
 /*
  * Helper function to decide whether current b+tree is empty
  */
 INDEX_TEMPLATE_ARGUMENTS
-bool BPLUSTREE_TYPE::IsEmpty() const { return true; }
+bool BPLUSTREE_TYPE::IsEmpty() const { return root_page_id_ == INVALID_PAGE_ID; }
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
@@ -42,7 +48,94 @@ bool BPLUSTREE_TYPE::IsEmpty() const { return true; }
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction) {
-  return false;
+  ReadLatchGuard guard(&tree_latch_);
+  if (IsEmpty()) {
+    return false;
+  }
+  Page *page = FindLeafPage(key);
+  ValueType value;
+  bool found = reinterpret_cast<LeafPage *>(page->GetData())->Lookup(key, &value, comparator_);
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  if (found) {
+    result->push_back(value);
+  }
+  return found;
+}
+
+/*
+ * Batched point query. (*results)[i] receives the value associated with
+ * keys[i], or stays empty if keys[i] does not exist.
+ * Keys are probed in sorted order while the pages on the current
+ * root-to-leaf path stay pinned, so consecutive keys only re-descend from
+ * the lowest node whose key range still covers them and every leaf is
+ * visited at most once, left to right.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::GetValues(const std::vector<KeyType> &keys, std::vector<std::vector<ValueType>> *results,
+                               Transaction *transaction) {
+  results->assign(keys.size(), std::vector<ValueType>());
+  ReadLatchGuard guard(&tree_latch_);
+  if (keys.empty() || IsEmpty()) {
+    return;
+  }
+
+  std::vector<size_t> order(keys.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&](size_t lhs, size_t rhs) { return comparator_(keys[lhs], keys[rhs]) < 0; });
+
+  // a pinned page on the current path and the exclusive upper bound of its key range
+  struct PathEntry {
+    Page *page;
+    bool bounded;
+    KeyType high_key;
+  };
+  std::vector<PathEntry> path;
+
+  for (size_t idx : order) {
+    const KeyType &key = keys[idx];
+    // keys arrive in ascending order, so only the upper bounds can stop covering them
+    while (!path.empty() && path.back().bounded && comparator_(key, path.back().high_key) >= 0) {
+      buffer_pool_manager_->UnpinPage(path.back().page->GetPageId(), false);
+      path.pop_back();
+    }
+    if (path.empty()) {
+      Page *root = buffer_pool_manager_->FetchPage(root_page_id_);
+      if (root == nullptr) {
+        throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch root page for batched lookup");
+      }
+      path.push_back({root, false, KeyType{}});
+    }
+
+    auto *node = reinterpret_cast<BPlusTreePage *>(path.back().page->GetData());
+    while (!node->IsLeafPage()) {
+      auto *internal = reinterpret_cast<InternalPage *>(node);
+      int child_index = ChildIndex(internal, key);
+      PathEntry child{nullptr, path.back().bounded, path.back().high_key};
+      if (child_index + 1 < internal->GetSize()) {
+        child.bounded = true;
+        child.high_key = internal->KeyAt(child_index + 1);
+      }
+      child.page = buffer_pool_manager_->FetchPage(internal->ValueAt(child_index));
+      if (child.page == nullptr) {
+        for (auto &entry : path) {
+          buffer_pool_manager_->UnpinPage(entry.page->GetPageId(), false);
+        }
+        throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch child page for batched lookup");
+      }
+      path.push_back(child);
+      node = reinterpret_cast<BPlusTreePage *>(child.page->GetData());
+    }
+
+    ValueType value;
+    if (reinterpret_cast<LeafPage *>(node)->Lookup(key, &value, comparator_)) {
+      (*results)[idx].push_back(value);
+    }
+  }
+
+  for (auto &entry : path) {
+    buffer_pool_manager_->UnpinPage(entry.page->GetPageId(), false);
+  }
 }
 
 /*****************************************************************************
@@ -56,7 +149,15 @@ bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
  * keys return false, otherwise return true.
  */
 INDEX_TEMPLATE_ARGUMENTS
-bool BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) { return false; }
+bool BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) {
+  WriteLatchGuard guard(&tree_latch_);
+  modify_count_++;
+  if (IsEmpty()) {
+    StartNewTree(key, value);
+    return true;
+  }
+  return InsertIntoLeaf(key, value, transaction);
+}
 /*
  * Insert constant key & value pair into an empty tree
  * User needs to first ask for new page from buffer pool manager(NOTICE: throw
@@ -64,7 +165,19 @@ bool BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
  * tree's root page id and insert entry directly into leaf page.
  */
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {}
+void BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {
+  page_id_t page_id;
+  Page *page = buffer_pool_manager_->NewPage(&page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate root page");
+  }
+  auto *root = reinterpret_cast<LeafPage *>(page->GetData());
+  root->Init(page_id, INVALID_PAGE_ID, leaf_max_size_);
+  root->Insert(key, value, comparator_);
+  root_page_id_ = page_id;
+  UpdateRootPageId(1);
+  buffer_pool_manager_->UnpinPage(page_id, true);
+}
 
 /*
  * Insert constant key & value pair into leaf page
@@ -76,7 +189,20 @@ void BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {}
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType &key, const ValueType &value, Transaction *transaction) {
-  return false;
+  Page *page = FindLeafPage(key);
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  int old_size = leaf->GetSize();
+  if (leaf->Insert(key, value, comparator_) == old_size) {
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    return false;
+  }
+  if (leaf->GetSize() >= leaf->GetMaxSize()) {
+    LeafPage *new_leaf = Split(leaf);
+    InsertIntoParent(leaf, new_leaf->KeyAt(0), new_leaf, transaction);
+    buffer_pool_manager_->UnpinPage(new_leaf->GetPageId(), true);
+  }
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+  return true;
 }
 
 /*
@@ -84,12 +210,32 @@ bool BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType &key, const ValueType &value,
  * Using template N to represent either internal page or leaf page.
  * User needs to first ask for new page from buffer pool manager(NOTICE: throw
  * an "out of memory" exception if returned value is nullptr), then move half
- * of key & value pairs from input page to newly created page
+ * of key & value pairs from input page to newly created page. A new leaf is
+ * linked in both directions: its prev is the input page, and the page that
+ * used to follow the input page now points back to it.
  */
 INDEX_TEMPLATE_ARGUMENTS
 template <typename N>
 N *BPLUSTREE_TYPE::Split(N *node) {
-  return nullptr;
+  page_id_t page_id;
+  Page *page = buffer_pool_manager_->NewPage(&page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate page to split into");
+  }
+  auto *new_node = reinterpret_cast<N *>(page->GetData());
+  new_node->Init(page_id, node->GetParentPageId(), node->GetMaxSize());
+  if constexpr (std::is_same_v<N, LeafPage>) {
+    node->MoveHalfTo(new_node);
+    new_node->SetNextPageId(node->GetNextPageId());
+    new_node->SetPrevPageId(node->GetPageId());
+    if (node->GetNextPageId() != INVALID_PAGE_ID) {
+      SetPrevPageId(node->GetNextPageId(), page_id);
+    }
+    node->SetNextPageId(page_id);
+  } else {
+    node->MoveHalfTo(new_node, buffer_pool_manager_);
+  }
+  return new_node;
 }
 
 /*
@@ -103,7 +249,38 @@ N *BPLUSTREE_TYPE::Split(N *node) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &key, BPlusTreePage *new_node,
-                                      Transaction *transaction) {}
+                                      Transaction *transaction) {
+  if (old_node->IsRootPage()) {
+    page_id_t page_id;
+    Page *page = buffer_pool_manager_->NewPage(&page_id);
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate new root page");
+    }
+    auto *root = reinterpret_cast<InternalPage *>(page->GetData());
+    root->Init(page_id, INVALID_PAGE_ID, internal_max_size_);
+    root->PopulateNewRoot(old_node->GetPageId(), key, new_node->GetPageId());
+    old_node->SetParentPageId(page_id);
+    new_node->SetParentPageId(page_id);
+    root_page_id_ = page_id;
+    UpdateRootPageId();
+    buffer_pool_manager_->UnpinPage(page_id, true);
+    return;
+  }
+
+  Page *page = buffer_pool_manager_->FetchPage(old_node->GetParentPageId());
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch parent page");
+  }
+  auto *parent = reinterpret_cast<InternalPage *>(page->GetData());
+  parent->InsertNodeAfter(old_node->GetPageId(), key, new_node->GetPageId());
+  new_node->SetParentPageId(parent->GetPageId());
+  if (parent->GetSize() >= parent->GetMaxSize()) {
+    InternalPage *new_parent = Split(parent);
+    InsertIntoParent(parent, new_parent->KeyAt(0), new_parent, transaction);
+    buffer_pool_manager_->UnpinPage(new_parent->GetPageId(), true);
+  }
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+}
 
 /*****************************************************************************
  * REMOVE
@@ -113,10 +290,151 @@ void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &ke
  * If current tree is empty, return immdiately.
  * If not, User needs to first find the right leaf page as deletion target, then
  * delete entry from leaf page. Remember to deal with redistribute or merge if
- * necessary.
+ * necessary. In lazy remove mode an underfull leaf is only recorded, and the
+ * redistribute or merge is left to MergeUnderfullLeaves.
+ * @return: false if the key does not exist
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
+  WriteLatchGuard guard(&tree_latch_);
+  remove_count_++;
+  modify_count_++;
+  if (IsEmpty()) {
+    return false;
+  }
+
+  Page *page = FindLeafPage(key);
+  page_id_t page_id = page->GetPageId();
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  int old_size = leaf->GetSize();
+  int size = leaf->RemoveAndDeleteRecord(key, comparator_);
+  bool should_delete = false;
+  if (size < old_size && size < leaf->GetMinSize()) {
+    if (lazy_remove_) {
+      // leave the leaf underfull, MergeUnderfullLeaves will fix it up later
+      std::lock_guard<std::mutex> underfull_guard(underfull_latch_);
+      underfull_leaves_.insert(page_id);
+    } else {
+      should_delete = CoalesceOrRedistribute(leaf, transaction);
+    }
+  }
+  buffer_pool_manager_->UnpinPage(page_id, size < old_size);
+  if (should_delete) {
+    DeletePage(page_id);
+  }
+  return size < old_size;
+}
+
+/*
+ * Switch lazy remove mode on or off. Leaves recorded while the mode was on
+ * are merged before this returns when it is switched off.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::SetLazyRemove(bool lazy_remove) {
+  lazy_remove_ = lazy_remove;
+  if (!lazy_remove) {
+    MergeUnderfullLeaves(SIZE_MAX);
+  }
+}
+
+/*
+ * Run CoalesceOrRedistribute on up to max_leaves leaves recorded by lazy
+ * removes, lowest page id first. The tree latch is taken per leaf so that
+ * foreground operations can interleave with a long pass. Merged away leaves
+ * are forgotten when they are deleted, but a recorded leaf may have been
+ * refilled in the meantime, in which case it is dropped without touching the
+ * tree.
+ * @return: number of recorded leaves processed
  */
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {}
+size_t BPLUSTREE_TYPE::MergeUnderfullLeaves(size_t max_leaves) {
+  size_t processed = 0;
+  while (processed < max_leaves) {
+    WriteLatchGuard guard(&tree_latch_);
+    page_id_t page_id;
+    {
+      std::lock_guard<std::mutex> underfull_guard(underfull_latch_);
+      if (underfull_leaves_.empty()) {
+        break;
+      }
+      page_id = *underfull_leaves_.begin();
+      underfull_leaves_.erase(underfull_leaves_.begin());
+    }
+
+    Page *page = buffer_pool_manager_->FetchPage(page_id);
+    if (page == nullptr) {
+      // every frame is pinned, try again on the next pass
+      std::lock_guard<std::mutex> underfull_guard(underfull_latch_);
+      underfull_leaves_.insert(page_id);
+      break;
+    }
+    auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    bool should_delete = false;
+    bool dirty = false;
+    if (IsLiveLeaf(page_id, leaf) && leaf->GetSize() < leaf->GetMinSize()) {
+      modify_count_++;
+      should_delete = CoalesceOrRedistribute(leaf);
+      dirty = true;
+      if (!should_delete && !leaf->IsRootPage() && leaf->GetSize() < leaf->GetMinSize()) {
+        // it absorbed a right sibling that was underfull as well, take it up again on a later step
+        std::lock_guard<std::mutex> underfull_guard(underfull_latch_);
+        underfull_leaves_.insert(page_id);
+      }
+    }
+    buffer_pool_manager_->UnpinPage(page_id, dirty);
+    if (should_delete) {
+      DeletePage(page_id);
+    }
+    processed++;
+  }
+  return processed;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::StartBackgroundMerge() {
+  if (background_merge_thread_.joinable()) {
+    return;
+  }
+  enable_background_merge_ = true;
+  background_merge_thread_ = std::thread(&BPLUSTREE_TYPE::RunBackgroundMerge, this);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::StopBackgroundMerge() {
+  if (!background_merge_thread_.joinable()) {
+    return;
+  }
+  enable_background_merge_ = false;
+  background_merge_thread_.join();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+size_t BPLUSTREE_TYPE::GetNumUnderfullLeaves() {
+  std::lock_guard<std::mutex> guard(underfull_latch_);
+  return underfull_leaves_.size();
+}
+
+/*
+ * Background maintenance loop. A pass is skipped while removes are still
+ * coming in, unless the backlog has grown past a few passes' worth of leaves.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::RunBackgroundMerge() {
+  uint64_t last_remove_count = remove_count_;
+  while (enable_background_merge_) {
+    std::this_thread::sleep_for(index_merge_interval);
+    uint64_t remove_count = remove_count_;
+    bool busy = remove_count != last_remove_count;
+    last_remove_count = remove_count;
+    if (busy) {
+      std::lock_guard<std::mutex> guard(underfull_latch_);
+      if (underfull_leaves_.size() < 4 * static_cast<size_t>(INDEX_MERGE_BATCH_SIZE)) {
+        continue;
+      }
+    }
+    MergeUnderfullLeaves();
+  }
+}
 
 /*
  * User needs to first find the sibling of input page. If sibling's size + input
@@ -128,7 +446,44 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {}
 INDEX_TEMPLATE_ARGUMENTS
 template <typename N>
 bool BPLUSTREE_TYPE::CoalesceOrRedistribute(N *node, Transaction *transaction) {
-  return false;
+  if (node->IsRootPage()) {
+    return AdjustRoot(node);
+  }
+
+  Page *parent_page = buffer_pool_manager_->FetchPage(node->GetParentPageId());
+  if (parent_page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch parent page");
+  }
+  auto *parent = reinterpret_cast<InternalPage *>(parent_page->GetData());
+  int index = parent->ValueIndex(node->GetPageId());
+  // the first child borrows from or merges with its right sibling, every other child with its left one
+  page_id_t neighbor_id = parent->ValueAt(index == 0 ? 1 : index - 1);
+  Page *neighbor_page = buffer_pool_manager_->FetchPage(neighbor_id);
+  if (neighbor_page == nullptr) {
+    buffer_pool_manager_->UnpinPage(parent_page->GetPageId(), false);
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch sibling page");
+  }
+  auto *neighbor = reinterpret_cast<N *>(neighbor_page->GetData());
+
+  if (neighbor->GetSize() + node->GetSize() >= node->GetMaxSize()) {
+    Redistribute(neighbor, node, index);
+    buffer_pool_manager_->UnpinPage(neighbor_id, true);
+    buffer_pool_manager_->UnpinPage(parent_page->GetPageId(), true);
+    return false;
+  }
+
+  page_id_t parent_id = parent->GetPageId();
+  bool delete_parent = Coalesce(&neighbor, &node, &parent, index, transaction);
+  buffer_pool_manager_->UnpinPage(neighbor_id, true);
+  buffer_pool_manager_->UnpinPage(parent_id, true);
+  if (index == 0) {
+    // node kept the entries of its right sibling, which is gone now
+    DeletePage(neighbor_id);
+  }
+  if (delete_parent) {
+    DeletePage(parent_id);
+  }
+  return index != 0;
 }
 
 /*
@@ -148,21 +503,67 @@ template <typename N>
 bool BPLUSTREE_TYPE::Coalesce(N **neighbor_node, N **node,
                               BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> **parent, int index,
                               Transaction *transaction) {
+  // always merge the right page of the pair into the left one
+  N *left = *neighbor_node;
+  N *right = *node;
+  int right_index = index;
+  if (index == 0) {
+    std::swap(left, right);
+    right_index = 1;
+  }
+  if constexpr (std::is_same_v<N, LeafPage>) {
+    right->MoveAllTo(left);
+    if (left->GetNextPageId() != INVALID_PAGE_ID) {
+      SetPrevPageId(left->GetNextPageId(), left->GetPageId());
+    }
+  } else {
+    right->MoveAllTo(left, (*parent)->KeyAt(right_index), buffer_pool_manager_);
+  }
+  (*parent)->Remove(right_index);
+  if ((*parent)->IsRootPage() || (*parent)->GetSize() < (*parent)->GetMinSize()) {
+    return CoalesceOrRedistribute(*parent, transaction);
+  }
   return false;
 }
 
 /*
- * Redistribute key & value pairs from one page to its sibling page. If index ==
- * 0, move sibling page's first key & value pair into end of input "node",
- * otherwise move sibling page's last key & value pair into head of input
- * "node".
+ * Redistribute key & value pairs from one page to its sibling page until the
+ * input "node" reaches its min size. If index == 0, move sibling page's first
+ * key & value pairs into end of input "node", otherwise move sibling page's
+ * last key & value pairs into head of input "node". A node left underfull by
+ * lazy removes may need more than one pair; the sibling never drops below its
+ * min size, as together they hold at least max size pairs.
  * Using template N to represent either internal page or leaf page.
  * @param   neighbor_node      sibling page of input "node"
  * @param   node               input from method coalesceOrRedistribute()
  */
 INDEX_TEMPLATE_ARGUMENTS
 template <typename N>
-void BPLUSTREE_TYPE::Redistribute(N *neighbor_node, N *node, int index) {}
+void BPLUSTREE_TYPE::Redistribute(N *neighbor_node, N *node, int index) {
+  Page *parent_page = buffer_pool_manager_->FetchPage(node->GetParentPageId());
+  if (parent_page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch parent page");
+  }
+  auto *parent = reinterpret_cast<InternalPage *>(parent_page->GetData());
+  do {
+    if (index == 0) {
+      if constexpr (std::is_same_v<N, LeafPage>) {
+        neighbor_node->MoveFirstToEndOf(node);
+      } else {
+        neighbor_node->MoveFirstToEndOf(node, parent->KeyAt(1), buffer_pool_manager_);
+      }
+      parent->SetKeyAt(1, neighbor_node->KeyAt(0));
+    } else {
+      if constexpr (std::is_same_v<N, LeafPage>) {
+        neighbor_node->MoveLastToFrontOf(node);
+      } else {
+        neighbor_node->MoveLastToFrontOf(node, parent->KeyAt(index), buffer_pool_manager_);
+      }
+      parent->SetKeyAt(index, node->KeyAt(0));
+    }
+  } while (node->GetSize() < node->GetMinSize() && neighbor_node->GetSize() > neighbor_node->GetMinSize());
+  buffer_pool_manager_->UnpinPage(parent_page->GetPageId(), true);
+}
 /*
  * Update root page if necessary
  * NOTE: size of root page can be less than min size and this method is only
@@ -174,7 +575,29 @@ void BPLUSTREE_TYPE::Redistribute(N *neighbor_node, N *node, int index) {}
  * happend
  */
 INDEX_TEMPLATE_ARGUMENTS
-bool BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root_node) { return false; }
+bool BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root_node) {
+  if (old_root_node->IsLeafPage()) {
+    if (old_root_node->GetSize() > 0) {
+      return false;
+    }
+    root_page_id_ = INVALID_PAGE_ID;
+    UpdateRootPageId();
+    return true;
+  }
+  if (old_root_node->GetSize() > 1) {
+    return false;
+  }
+  page_id_t child_id = reinterpret_cast<InternalPage *>(old_root_node)->RemoveAndReturnOnlyChild();
+  Page *page = buffer_pool_manager_->FetchPage(child_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch new root page");
+  }
+  reinterpret_cast<BPlusTreePage *>(page->GetData())->SetParentPageId(INVALID_PAGE_ID);
+  buffer_pool_manager_->UnpinPage(child_id, true);
+  root_page_id_ = child_id;
+  UpdateRootPageId();
+  return true;
+}
 
 /*****************************************************************************
  * INDEX ITERATOR
@@ -185,7 +608,7 @@ bool BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root_node) { return false; }
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE BPLUSTREE_TYPE::begin() { return INDEXITERATOR_TYPE(); }
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::begin() { return MakeIterator(nullptr, true, false, nullptr, false); }
 
 /*
  * Input parameter is low key, find the leaf page that contains the input key
@@ -193,7 +616,7 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::begin() { return INDEXITERATOR_TYPE(); }
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType &key) { return INDEXITERATOR_TYPE(); }
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType &key) { return MakeIterator(&key, true, false, nullptr, false); }
 
 /*
  * Input parameter is void, construct an index iterator representing the end
@@ -203,16 +626,360 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType &key) { return INDEXITERA
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_TYPE::end() { return INDEXITERATOR_TYPE(); }
 
+/*
+ * Input parameters are the bounds of the range [low, high] (each end
+ * inclusive or exclusive), find the leaf page that contains low first, then
+ * construct an index iterator that stops by itself after the last key in
+ * range
+ * @return : index iterator
+ */
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType &low, const KeyType &high, bool low_inclusive,
+                                         bool high_inclusive) {
+  return MakeIterator(&low, low_inclusive, false, &high, high_inclusive);
+}
+
+/*
+ * Input parameter is void, find the rightmost leaf page first, then construct
+ * a reverse index iterator starting at the largest key
+ * @return : index iterator
+ */
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::rbegin() { return MakeIterator(nullptr, true, true, nullptr, false); }
+
+/*
+ * Input parameter is high key, find the leaf page that contains the input key
+ * first, then construct a reverse index iterator starting at the largest key
+ * that is not greater than the input key
+ * @return : index iterator
+ */
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::RBegin(const KeyType &key) { return MakeIterator(&key, true, true, nullptr, false); }
+
+/*
+ * Reverse counterpart of Begin(low, high): starts at the largest key in range
+ * and stops by itself after the smallest one
+ * @return : index iterator
+ */
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::RBegin(const KeyType &low, const KeyType &high, bool low_inclusive,
+                                          bool high_inclusive) {
+  return MakeIterator(&high, high_inclusive, true, &low, low_inclusive);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::MakeIterator(const KeyType *key, bool inclusive, bool reverse,
+                                                const KeyType *stop_key, bool stop_inclusive) {
+  page_id_t page_id;
+  page_id_t sibling_id;
+  uint64_t version;
+  std::vector<MappingType> entries;
+  int index;
+  if (!ReadLeaf(key, inclusive, reverse, &page_id, &sibling_id, &version, &entries, &index)) {
+    return end();
+  }
+  if (stop_key == nullptr) {
+    return INDEXITERATOR_TYPE(this, page_id, sibling_id, version, std::move(entries), index, reverse);
+  }
+  return INDEXITERATOR_TYPE(this, page_id, sibling_id, version, std::move(entries), index, reverse, &comparator_,
+                            *stop_key, stop_inclusive);
+}
+
+/*
+ * Find the leaf holding the first key at or after key (the last key at or
+ * before it if reverse), skipping leaves left empty by lazy removes, and copy
+ * its entries out, along with the leaf after it in the iteration direction and
+ * the modification count the copy is valid for.
+ * @return : false if no key qualifies
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::ReadLeaf(const KeyType *key, bool inclusive, bool reverse, page_id_t *page_id,
+                              page_id_t *sibling_id, uint64_t *version, std::vector<MappingType> *entries,
+                              int *index) {
+  ReadLatchGuard guard(&tree_latch_);
+  if (IsEmpty()) {
+    return false;
+  }
+  Page *page;
+  if (key == nullptr) {
+    page = reverse ? FindRightMostLeafPage() : FindLeafPage(KeyType{}, true);
+  } else {
+    page = FindLeafPage(*key);
+  }
+  for (;;) {
+    auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    int size = leaf->GetSize();
+    int start;
+    if (key == nullptr) {
+      start = reverse ? size - 1 : 0;
+    } else {
+      start = leaf->KeyIndex(*key, comparator_);
+      bool equal = start < size && comparator_(leaf->KeyAt(start), *key) == 0;
+      if (!reverse && equal && !inclusive) {
+        start++;
+      } else if (reverse && !(equal && inclusive)) {
+        start--;
+      }
+    }
+    page_id_t next_id = reverse ? leaf->GetPrevPageId() : leaf->GetNextPageId();
+    if (start >= 0 && start < size) {
+      *page_id = page->GetPageId();
+      *sibling_id = next_id;
+      *version = modify_count_;
+      entries->clear();
+      for (int i = 0; i < size; i++) {
+        entries->push_back(leaf->GetItem(i));
+      }
+      *index = start;
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+      return true;
+    }
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    if (next_id == INVALID_PAGE_ID) {
+      return false;
+    }
+    page = buffer_pool_manager_->FetchPage(next_id);
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch sibling leaf page");
+    }
+  }
+}
+
+/*
+ * Copy out the leaf *page_id, or the first one after it that lazy removes
+ * have not left empty. The leaf links of a tree that has not been modified
+ * since the previous leaf was copied still lead to the keys right after it,
+ * so no descent from the root is needed.
+ * @return : false if the tree has been modified since version
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::ReadSiblingLeaf(uint64_t version, bool reverse, page_id_t *page_id, page_id_t *sibling_id,
+                                     std::vector<MappingType> *entries, int *index) {
+  ReadLatchGuard guard(&tree_latch_);
+  if (version != modify_count_) {
+    return false;
+  }
+  page_id_t current_id = *page_id;
+  while (current_id != INVALID_PAGE_ID) {
+    Page *page = buffer_pool_manager_->FetchPage(current_id);
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch sibling leaf page");
+    }
+    auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    int size = leaf->GetSize();
+    page_id_t next_id = reverse ? leaf->GetPrevPageId() : leaf->GetNextPageId();
+    if (size > 0) {
+      *sibling_id = next_id;
+      entries->clear();
+      for (int i = 0; i < size; i++) {
+        entries->push_back(leaf->GetItem(i));
+      }
+      *index = reverse ? size - 1 : 0;
+      buffer_pool_manager_->UnpinPage(current_id, false);
+      break;
+    }
+    buffer_pool_manager_->UnpinPage(current_id, false);
+    current_id = next_id;
+  }
+  *page_id = current_id;
+  return true;
+}
+
+/*****************************************************************************
+ * STATISTICS
+ *****************************************************************************/
+/*
+ * Walk the internal levels breadth first to get the exact height and page
+ * counts, then read up to max_sample_leaves leaves spread evenly over the
+ * leaf level. Entry count and fill factor are extrapolated from the sampled
+ * leaves, whose keys are appended to sample in ascending order.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::SampleLeaves(size_t max_sample_leaves, IndexStatistics *stats, std::vector<KeyType> *sample,
+                                  std::vector<size_t> *leaf_ends) {
+  *stats = IndexStatistics();
+  stats->valid_ = true;
+  sample->clear();
+  if (leaf_ends != nullptr) {
+    leaf_ends->clear();
+  }
+  ReadLatchGuard guard(&tree_latch_);
+  if (IsEmpty() || max_sample_leaves == 0) {
+    return;
+  }
+
+  std::vector<page_id_t> level{root_page_id_};
+  stats->height_ = 1;
+  for (;;) {
+    std::vector<page_id_t> children;
+    for (page_id_t page_id : level) {
+      Page *page = buffer_pool_manager_->FetchPage(page_id);
+      if (page == nullptr) {
+        throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch page for index statistics");
+      }
+      auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+      if (node->IsLeafPage()) {
+        buffer_pool_manager_->UnpinPage(page_id, false);
+        break;
+      }
+      auto *internal = reinterpret_cast<InternalPage *>(node);
+      for (int i = 0; i < internal->GetSize(); i++) {
+        children.push_back(internal->ValueAt(i));
+      }
+      buffer_pool_manager_->UnpinPage(page_id, false);
+    }
+    if (children.empty()) {
+      break;
+    }
+    stats->internal_page_count_ += level.size();
+    stats->height_++;
+    level.swap(children);
+  }
+  stats->leaf_page_count_ = level.size();
+
+  size_t num_samples = std::min(max_sample_leaves, level.size());
+  uint64_t sampled_entries = 0;
+  uint64_t sampled_capacity = 0;
+  for (size_t i = 0; i < num_samples; i++) {
+    page_id_t page_id = level[i * level.size() / num_samples];
+    Page *page = buffer_pool_manager_->FetchPage(page_id);
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch page for index statistics");
+    }
+    auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    for (int j = 0; j < leaf->GetSize(); j++) {
+      sample->push_back(leaf->KeyAt(j));
+    }
+    if (leaf_ends != nullptr) {
+      leaf_ends->push_back(sample->size());
+    }
+    sampled_entries += leaf->GetSize();
+    sampled_capacity += leaf->GetMaxSize();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+  }
+
+  stats->num_entries_ = sampled_entries * level.size() / num_samples;
+  stats->fill_factor_ =
+      sampled_capacity == 0 ? 0 : static_cast<double>(sampled_entries) / static_cast<double>(sampled_capacity);
+}
+
 /*****************************************************************************
  * UTILITIES AND DEBUG
  *****************************************************************************/
 /*
  * Find leaf page containing particular key, if leftMost flag == true, find
- * the left most leaf page
+ * the left most leaf page. The caller holds the tree latch.
  */
 INDEX_TEMPLATE_ARGUMENTS
 Page *BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, bool leftMost) {
-  throw Exception(ExceptionType::NOT_IMPLEMENTED, "Implement this for test");
+  Page *page = buffer_pool_manager_->FetchPage(root_page_id_);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch root page");
+  }
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  while (!node->IsLeafPage()) {
+    auto *internal = reinterpret_cast<InternalPage *>(node);
+    page_id_t child_id = leftMost ? internal->ValueAt(0) : internal->Lookup(key, comparator_);
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    page = buffer_pool_manager_->FetchPage(child_id);
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch child page");
+    }
+    node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  }
+  return page;
+}
+
+/*
+ * Set the prev page id of a leaf, when the leaf before it changes.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::SetPrevPageId(page_id_t page_id, page_id_t prev_page_id) {
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch sibling leaf page");
+  }
+  reinterpret_cast<LeafPage *>(page->GetData())->SetPrevPageId(prev_page_id);
+  buffer_pool_manager_->UnpinPage(page_id, true);
+}
+
+/*
+ * Delete a page merged away, forgetting it if a lazy remove recorded it.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::DeletePage(page_id_t page_id) {
+  {
+    std::lock_guard<std::mutex> guard(underfull_latch_);
+    underfull_leaves_.erase(page_id);
+  }
+  buffer_pool_manager_->DeletePage(page_id);
+}
+
+/*
+ * Check that a leaf recorded by a lazy remove is still part of the tree,
+ * i.e. it is the root or its parent still points to it.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::IsLiveLeaf(page_id_t page_id, BPlusTreePage *node) {
+  if (!node->IsLeafPage() || node->GetPageId() != page_id) {
+    return false;
+  }
+  if (node->IsRootPage()) {
+    return page_id == root_page_id_;
+  }
+  Page *parent_page = buffer_pool_manager_->FetchPage(node->GetParentPageId());
+  if (parent_page == nullptr) {
+    return false;
+  }
+  auto *parent = reinterpret_cast<InternalPage *>(parent_page->GetData());
+  int index = parent->ValueIndex(page_id);
+  bool linked = index >= 0 && index < parent->GetSize() && parent->ValueAt(index) == page_id;
+  buffer_pool_manager_->UnpinPage(parent_page->GetPageId(), false);
+  return linked;
+}
+
+/*
+ * Find the right most leaf page, used as the starting point of reverse
+ * iteration. The returned page is pinned.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+Page *BPLUSTREE_TYPE::FindRightMostLeafPage() {
+  Page *page = buffer_pool_manager_->FetchPage(root_page_id_);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch root page");
+  }
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  while (!node->IsLeafPage()) {
+    auto *internal = reinterpret_cast<InternalPage *>(node);
+    page_id_t child_id = internal->ValueAt(internal->GetSize() - 1);
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    page = buffer_pool_manager_->FetchPage(child_id);
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch child page");
+    }
+    node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  }
+  return page;
+}
+
+/*
+ * Find the index of the child pointer in internal page "node" whose subtree
+ * covers key, i.e. the largest i such that KeyAt(i) <= key (the first key is
+ * invalid and always matches).
+ */
+INDEX_TEMPLATE_ARGUMENTS
+int BPLUSTREE_TYPE::ChildIndex(const InternalPage *node, const KeyType &key) const {
+  int low = 1;
+  int high = node->GetSize() - 1;
+  while (low <= high) {
+    int mid = low + (high - low) / 2;
+    if (comparator_(node->KeyAt(mid), key) <= 0) {
+      low = mid + 1;
+    } else {
+      high = mid - 1;
+    }
+  }
+  return low - 1;
 }
 
 /*
@@ -226,11 +993,9 @@ Page *BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, bool leftMost) {
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::UpdateRootPageId(int insert_record) {
   HeaderPage *header_page = static_cast<HeaderPage *>(buffer_pool_manager_->FetchPage(HEADER_PAGE_ID));
-  if (insert_record != 0) {
-    // create a new record<index_name + root_page_id> in header_page
-    header_page->InsertRecord(index_name_, root_page_id_);
-  } else {
-    // update root_page_id in header_page
+  // create a new record<index_name + root_page_id> in header_page, or update root_page_id in header_page. A tree
+  // emptied and started again already has its record.
+  if (insert_record == 0 || !header_page->InsertRecord(index_name_, root_page_id_)) {
     header_page->UpdateRecord(index_name_, root_page_id_);
   }
   buffer_pool_manager_->UnpinPage(HEADER_PAGE_ID, true);
@@ -9,6 +9,9 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <utility>
+#include <vector>
+
 #include "storage/index/b_plus_tree_index.h"
 
 namespace bustub {
@@ -27,6 +30,15 @@ void BPLUSTREE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *t
   KeyType index_key;
   index_key.SetFromKey(key);
 
+  // the filter learns the key first, so a concurrent point query that misses it never finds the entry either
+  if (bloom_filter_ != nullptr) {
+    uint64_t hash = BloomFilterHash(index_key);
+    bloom_filter_->Insert(hash);
+    if (!container_.Insert(index_key, rid, transaction)) {
+      bloom_filter_->Remove(hash);
+    }
+    return;
+  }
   container_.Insert(index_key, rid, transaction);
 }
 
@@ -36,7 +48,10 @@ void BPLUSTREE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *t
   KeyType index_key;
   index_key.SetFromKey(key);
 
-  container_.Remove(index_key, transaction);
+  // the filter must only forget keys it has, Remove checks and removes the key under the tree latch
+  if (container_.Remove(index_key, transaction) && bloom_filter_ != nullptr) {
+    bloom_filter_->Remove(BloomFilterHash(index_key));
+  }
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -45,18 +60,82 @@ void BPLUSTREE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, T
   KeyType index_key;
   index_key.SetFromKey(key);
 
+  if (bloom_filter_ != nullptr && !bloom_filter_->MayContain(BloomFilterHash(index_key))) {
+    return;
+  }
   container_.GetValue(index_key, result, transaction);
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *result,
+                                    Transaction *transaction) {
+  // construct scan index keys, the tree sorts them and probes in one pass
+  std::vector<KeyType> index_keys;
+  std::vector<size_t> positions;
+  index_keys.reserve(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    KeyType index_key;
+    index_key.SetFromKey(keys[i]);
+    // keys the filter rules out are left out of the probe
+    if (bloom_filter_ == nullptr || bloom_filter_->MayContain(BloomFilterHash(index_key))) {
+      index_keys.push_back(index_key);
+      positions.push_back(i);
+    }
+  }
+
+  if (positions.size() == keys.size()) {
+    container_.GetValues(index_keys, result, transaction);
+    return;
+  }
+  std::vector<std::vector<RID>> found;
+  container_.GetValues(index_keys, &found, transaction);
+  result->assign(keys.size(), std::vector<RID>());
+  for (size_t i = 0; i < positions.size(); i++) {
+    (*result)[positions[i]] = std::move(found[i]);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_INDEX_TYPE::CollectStatistics(IndexStatistics *stats, size_t sample_leaves) {
+  std::vector<KeyType> sample;
+  std::vector<size_t> leaf_ends;
+  container_.SampleLeaves(sample_leaves, stats, &sample, &leaf_ends);
+
+  // the histogram is kept on the leading key column, which is what range predicates usually bind
+  std::vector<Value> values;
+  values.reserve(sample.size());
+  for (const auto &key : sample) {
+    values.push_back(key.ToValue(GetKeySchema(), 0));
+  }
+  // keys are unique, so a single-column key has as many distinct values as entries
+  stats->BuildFromSample(values, leaf_ends, GetKeySchema()->GetColumnCount() == 1);
+  return true;
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetBeginIterator() { return container_.begin(); }
 
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetBeginIterator(const KeyType &key) { return container_.Begin(key); }
 
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetBeginIterator(const KeyType &low, const KeyType &high, bool low_inclusive,
+                                                          bool high_inclusive) {
+  return container_.Begin(low, high, low_inclusive, high_inclusive);
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetEndIterator() { return container_.end(); }
 
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetReverseBeginIterator() { return container_.rbegin(); }
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetReverseBeginIterator(const KeyType &low, const KeyType &high,
+                                                                 bool low_inclusive, bool high_inclusive) {
+  return container_.RBegin(low, high, low_inclusive, high_inclusive);
+}
+
 template class BPlusTreeIndex<GenericKey<4>, RID, GenericComparator<4>>;
 template class BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>>;
 template class BPlusTreeIndex<GenericKey<16>, RID, GenericComparator<16>>;
@@ -0,0 +1,85 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// bloom_filter.cpp
+//
+// Identification: src/storage/index/bloom_filter.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+
+#include "storage/index/bloom_filter.h"
+
+namespace bustub {
+
+namespace {
+
+// odd multipliers that pick the bit of a key in each word of its block
+constexpr std::array<uint32_t, BloomFilter::BLOCK_WORDS> SALT = {0x47B6137BU, 0x44974D91U, 0x8824AD5BU,
+                                                                0xA2B7289DU, 0x705495C7U, 0x2DF1424BU,
+                                                                0x9EFC4947U, 0x5C6BFB31U};
+
+}  // namespace
+
+BloomFilter::BloomFilter(size_t expected_entries, size_t bits_per_key)
+    : num_blocks_(std::max<size_t>(1, (expected_entries * bits_per_key + BLOCK_BITS - 1) / BLOCK_BITS)),
+      words_(new std::atomic<uint32_t>[num_blocks_ * BLOCK_WORDS]),
+      counters_(new uint8_t[num_blocks_ * BLOCK_BITS]()) {
+  for (size_t i = 0; i < num_blocks_ * BLOCK_WORDS; i++) {
+    words_[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+std::array<uint32_t, BloomFilter::BLOCK_WORDS> BloomFilter::BitsOf(uint64_t hash) {
+  std::array<uint32_t, BLOCK_WORDS> bits;
+  auto key = static_cast<uint32_t>(hash);
+  for (size_t w = 0; w < BLOCK_WORDS; w++) {
+    bits[w] = (key * SALT[w]) >> 27;
+  }
+  return bits;
+}
+
+void BloomFilter::Insert(uint64_t hash) {
+  size_t block = BlockOf(hash);
+  auto bits = BitsOf(hash);
+  std::lock_guard<std::mutex> guard(stripe_latches_[block % NUM_STRIPES]);
+  for (size_t w = 0; w < BLOCK_WORDS; w++) {
+    uint8_t &count = counters_[block * BLOCK_BITS + w * 32 + bits[w]];
+    if (count < MAX_COUNT) {
+      count++;
+    }
+    words_[block * BLOCK_WORDS + w].fetch_or(1U << bits[w]);
+  }
+}
+
+void BloomFilter::Remove(uint64_t hash) {
+  size_t block = BlockOf(hash);
+  auto bits = BitsOf(hash);
+  std::lock_guard<std::mutex> guard(stripe_latches_[block % NUM_STRIPES]);
+  for (size_t w = 0; w < BLOCK_WORDS; w++) {
+    uint8_t &count = counters_[block * BLOCK_BITS + w * 32 + bits[w]];
+    // a saturated counter has lost track of its keys, so its bit stays
+    if (count == MAX_COUNT || count == 0) {
+      continue;
+    }
+    if (--count == 0) {
+      words_[block * BLOCK_WORDS + w].fetch_and(~(1U << bits[w]));
+    }
+  }
+}
+
+bool BloomFilter::MayContain(uint64_t hash) const {
+  size_t block = BlockOf(hash);
+  auto bits = BitsOf(hash);
+  bool found = true;
+  for (size_t w = 0; w < BLOCK_WORDS; w++) {
+    found &= ((words_[block * BLOCK_WORDS + w].load(std::memory_order_acquire) >> bits[w]) & 1) != 0;
+  }
+  return found;
+}
+
+}  // namespace bustub
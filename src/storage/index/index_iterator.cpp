@@ -2,7 +2,9 @@
  * index_iterator.cpp
  */
 #include <cassert>
+#include <utility>
 
+#include "storage/index/b_plus_tree.h"
 #include "storage/index/index_iterator.h"
 
 namespace bustub {
@@ -15,16 +17,81 @@ INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE::IndexIterator() = default;
 
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE::~IndexIterator() = default;
+INDEXITERATOR_TYPE::IndexIterator(Tree *tree, page_id_t page_id, page_id_t sibling_id, uint64_t version,
+                                  std::vector<MappingType> entries, int index, bool reverse)
+    : tree_(tree),
+      page_id_(page_id),
+      sibling_id_(sibling_id),
+      version_(version),
+      entries_(std::move(entries)),
+      index_(index),
+      reverse_(reverse) {}
 
 INDEX_TEMPLATE_ARGUMENTS
-bool INDEXITERATOR_TYPE::isEnd() { throw std::runtime_error("unimplemented"); }
+INDEXITERATOR_TYPE::IndexIterator(Tree *tree, page_id_t page_id, page_id_t sibling_id, uint64_t version,
+                                  std::vector<MappingType> entries, int index, bool reverse,
+                                  const KeyComparator *comparator, const KeyType &stop_key, bool stop_inclusive)
+    : tree_(tree),
+      page_id_(page_id),
+      sibling_id_(sibling_id),
+      version_(version),
+      entries_(std::move(entries)),
+      index_(index),
+      reverse_(reverse),
+      comparator_(comparator),
+      stop_key_(stop_key),
+      stop_inclusive_(stop_inclusive) {
+  CheckStop();
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-const MappingType &INDEXITERATOR_TYPE::operator*() { throw std::runtime_error("unimplemented"); }
+bool INDEXITERATOR_TYPE::isEnd() { return tree_ == nullptr; }
 
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator++() { throw std::runtime_error("unimplemented"); }
+const MappingType &INDEXITERATOR_TYPE::operator*() {
+  assert(!isEnd());
+  return entries_[index_];
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator++() {
+  assert(!isEnd());
+  index_ += reverse_ ? -1 : 1;
+  if (index_ < 0 || index_ >= static_cast<int>(entries_.size())) {
+    page_id_t page_id = sibling_id_;
+    bool found;
+    if (tree_->ReadSiblingLeaf(version_, reverse_, &page_id, &sibling_id_, &entries_, &index_)) {
+      page_id_ = page_id;
+      found = page_id != INVALID_PAGE_ID;
+    } else {
+      // the tree changed, continue after the last key returned, in whatever leaf holds the keys after it now
+      KeyType last_key = reverse_ ? entries_.front().first : entries_.back().first;
+      found = tree_->ReadLeaf(&last_key, false, reverse_, &page_id_, &sibling_id_, &version_, &entries_, &index_);
+    }
+    if (!found) {
+      tree_ = nullptr;
+      entries_.clear();
+      return *this;
+    }
+  }
+  CheckStop();
+  return *this;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::CheckStop() {
+  if (tree_ == nullptr || comparator_ == nullptr) {
+    return;
+  }
+  int cmp = (*comparator_)(entries_[index_].first, stop_key_);
+  if (reverse_) {
+    cmp = -cmp;
+  }
+  if (cmp > 0 || (cmp == 0 && !stop_inclusive_)) {
+    tree_ = nullptr;
+    entries_.clear();
+  }
+}
 
 template class IndexIterator<GenericKey<4>, RID, GenericComparator<4>>;
 
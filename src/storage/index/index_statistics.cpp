@@ -0,0 +1,95 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_statistics.cpp
+//
+// Identification: src/storage/index/index_statistics.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cmath>
+
+#include "storage/index/index_statistics.h"
+
+namespace bustub {
+
+void IndexStatistics::BuildFromSample(const std::vector<Value> &sample, const std::vector<size_t> &run_ends,
+                                      bool unique, size_t num_buckets) {
+  histogram_.clear();
+  distinct_keys_ = 0;
+  size_t n = sample.size();
+  if (n == 0) {
+    return;
+  }
+  uint64_t population = std::max<uint64_t>(num_entries_, n);
+  lower_bound_ = sample.front();
+
+  if (unique) {
+    distinct_keys_ = population;
+  } else {
+    // The sample is made of whole leaves, so it is not uniform and frequency-based estimators do not apply. Within
+    // a run of consecutive entries, every change of value is a boundary between two distinct values; the share of
+    // adjacent pairs that are boundaries carries over to the whole index.
+    uint64_t pairs = 0;
+    uint64_t boundaries = 0;
+    uint64_t seen = 1;
+    size_t begin = 0;
+    for (size_t end : run_ends) {
+      for (size_t i = begin; i < end; i++) {
+        bool changes = i > 0 && sample[i].CompareNotEquals(sample[i - 1]) == CmpBool::CmpTrue;
+        seen += changes ? 1 : 0;
+        if (i > begin) {
+          pairs++;
+          boundaries += changes ? 1 : 0;
+        }
+      }
+      begin = end;
+    }
+    uint64_t estimate = population;
+    if (pairs > 0) {
+      estimate = 1 + static_cast<uint64_t>(std::llround(static_cast<double>(boundaries) / static_cast<double>(pairs) *
+                                                         static_cast<double>(population - 1)));
+    }
+    distinct_keys_ = std::min(std::max(estimate, seen), population);
+  }
+
+  // Equi-depth histogram: every bucket gets the same share of the sample.
+  num_buckets = std::min(num_buckets, n);
+  for (size_t b = 0; b < num_buckets; b++) {
+    size_t begin = b * n / num_buckets;
+    size_t end = (b + 1) * n / num_buckets;
+    uint64_t count = population * (end - begin) / n;
+    histogram_.emplace_back(sample[end - 1], count);
+  }
+}
+
+double IndexStatistics::EstimateSelectivity(const Value &low, const Value &high) const {
+  if (histogram_.empty()) {
+    return 1.0;
+  }
+  uint64_t total = 0;
+  double matched = 0;
+  for (size_t b = 0; b < histogram_.size(); b++) {
+    const HistogramBucket &bucket = histogram_[b];
+    total += bucket.count_;
+    // the bucket spans (previous upper bound, upper bound], the first one [lower bound, upper bound]
+    bool below = bucket.upper_bound_.CompareLessThan(low) == CmpBool::CmpTrue;
+    bool above = b > 0 ? histogram_[b - 1].upper_bound_.CompareGreaterThanEquals(high) == CmpBool::CmpTrue
+                       : lower_bound_.CompareGreaterThan(high) == CmpBool::CmpTrue;
+    if (below || above) {
+      continue;
+    }
+    bool starts_inside = b > 0 ? histogram_[b - 1].upper_bound_.CompareGreaterThanEquals(low) == CmpBool::CmpTrue
+                               : lower_bound_.CompareGreaterThanEquals(low) == CmpBool::CmpTrue;
+    bool ends_inside = bucket.upper_bound_.CompareLessThanEquals(high) == CmpBool::CmpTrue;
+    // without interpolation inside a bucket, a partially covered one counts half
+    matched += (starts_inside && ends_inside) ? bucket.count_ : bucket.count_ / 2.0;
+  }
+  return total == 0 ? 0.0 : std::min(1.0, matched / static_cast<double>(total));
+}
+
+}  // namespace bustub
@@ -1,3 +1,6 @@
+#include <thread>  // NOLINT
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "storage/index/linear_probe_hash_table_index.h"
@@ -6,43 +9,100 @@ namespace bustub {
 /*
  * Constructor
  */
-template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashTableType>
 HASH_TABLE_INDEX_TYPE::LinearProbeHashTableIndex(IndexMetadata *metadata, BufferPoolManager *buffer_pool_manager,
                                                  size_t num_buckets, const HashFunction<KeyType> &hash_fn)
     : Index(metadata),
       comparator_(metadata->GetKeySchema()),
       container_(metadata->GetName(), buffer_pool_manager, comparator_, num_buckets, hash_fn) {}
 
-template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashTableType>
 void HASH_TABLE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) {
   // construct insert index key
   KeyType index_key;
   index_key.SetFromKey(key);
 
+  // the filter learns the key first, so a concurrent point query that misses it never finds the entry either
+  if (bloom_filter_ != nullptr) {
+    uint64_t hash = BloomFilterHash(index_key);
+    bloom_filter_->Insert(hash);
+    if (!container_.Insert(transaction, index_key, rid)) {
+      bloom_filter_->Remove(hash);
+    }
+    return;
+  }
   container_.Insert(transaction, index_key, rid);
 }
 
-template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashTableType>
 void HASH_TABLE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
   // construct delete index key
   KeyType index_key;
   index_key.SetFromKey(key);
 
-  container_.Remove(transaction, index_key, rid);
+  if (container_.Remove(transaction, index_key, rid) && bloom_filter_ != nullptr) {
+    bloom_filter_->Remove(BloomFilterHash(index_key));
+  }
 }
 
-template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashTableType>
 void HASH_TABLE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
   // construct scan index key
   KeyType index_key;
   index_key.SetFromKey(key);
 
+  if (bloom_filter_ != nullptr && !bloom_filter_->MayContain(BloomFilterHash(index_key))) {
+    return;
+  }
   container_.GetValue(transaction, index_key, result);
 }
+
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashTableType>
+void HASH_TABLE_INDEX_TYPE::ReserveEntries(size_t num_entries) {
+  if constexpr (std::is_same_v<HashTableType, LinearProbeHashTable<KeyType, ValueType, KeyComparator>>) {
+    container_.Reserve(num_entries);
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator, typename HashTableType>
+void HASH_TABLE_INDEX_TYPE::InsertEntries(const std::vector<Tuple> &keys, const std::vector<RID> &rids,
+                                          Transaction *transaction) {
+  if constexpr (std::is_same_v<HashTableType, LinearProbeHashTable<KeyType, ValueType, KeyComparator>>) {
+    std::vector<std::pair<KeyType, ValueType>> entries(keys.size());
+    for (size_t i = 0; i < keys.size(); i++) {
+      entries[i].first.SetFromKey(keys[i]);
+      entries[i].second = rids[i];
+    }
+    // the filter learns only the keys that went in, a table that is not empty may turn some of them away
+    std::vector<bool> loaded;
+    container_.BulkLoad(entries, std::thread::hardware_concurrency(), &loaded);
+    if (bloom_filter_ != nullptr) {
+      for (size_t i = 0; i < entries.size(); i++) {
+        if (loaded[i]) {
+          bloom_filter_->Insert(BloomFilterHash(entries[i].first));
+        }
+      }
+    }
+  } else {
+    Index::InsertEntries(keys, rids, transaction);
+  }
+}
+
 template class LinearProbeHashTableIndex<GenericKey<4>, RID, GenericComparator<4>>;
 template class LinearProbeHashTableIndex<GenericKey<8>, RID, GenericComparator<8>>;
 template class LinearProbeHashTableIndex<GenericKey<16>, RID, GenericComparator<16>>;
 template class LinearProbeHashTableIndex<GenericKey<32>, RID, GenericComparator<32>>;
 template class LinearProbeHashTableIndex<GenericKey<64>, RID, GenericComparator<64>>;
 
+template class LinearProbeHashTableIndex<GenericKey<4>, RID, GenericComparator<4>,
+                                         ExtendibleHashTable<GenericKey<4>, RID, GenericComparator<4>>>;
+template class LinearProbeHashTableIndex<GenericKey<8>, RID, GenericComparator<8>,
+                                         ExtendibleHashTable<GenericKey<8>, RID, GenericComparator<8>>>;
+template class LinearProbeHashTableIndex<GenericKey<16>, RID, GenericComparator<16>,
+                                         ExtendibleHashTable<GenericKey<16>, RID, GenericComparator<16>>>;
+template class LinearProbeHashTableIndex<GenericKey<32>, RID, GenericComparator<32>,
+                                         ExtendibleHashTable<GenericKey<32>, RID, GenericComparator<32>>>;
+template class LinearProbeHashTableIndex<GenericKey<64>, RID, GenericComparator<64>,
+                                         ExtendibleHashTable<GenericKey<64>, RID, GenericComparator<64>>>;
+
 }  // namespace bustub
@@ -10,6 +10,12 @@
 //
 //===----------------------------------------------------------------------===//
 
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+
 #include "storage/page/hash_table_block_page.h"
 #include "storage/index/generic_key.h"
 
@@ -32,15 +38,45 @@ ValueType HASH_TABLE_BLOCK_TYPE::ValueAt(slot_offset_t bucket_ind) const {
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-bool HASH_TABLE_BLOCK_TYPE::Insert(slot_offset_t bucket_ind, const KeyType &key, const ValueType &value) {
-  char expected = readable_[bucket_ind / 8];
-  char desired = readable_[bucket_ind / 8] | (1 << (bucket_ind % 8));
-  if (!readable_[bucket_ind / 8].compare_exchange_weak(expected, desired)) return false;
-  if (expected == desired) return false;
+bool HASH_TABLE_BLOCK_TYPE::Insert(slot_offset_t bucket_ind, const KeyType &key, const ValueType &value,
+                                   uint8_t tag) {
+  if (IsReadable(bucket_ind)) {
+    return false;
+  }
+  // a reader may still be copying the pair that was removed from a tombstone
+  bool reuse = IsOccupied(bucket_ind);
+  uint32_t version = version_.load(std::memory_order_relaxed);
+  if (reuse) {
+    version_.store(version + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+  // the pair and its tag are written before the readable bit publishes them to readers without the latch
   array_[bucket_ind] = std::make_pair(key, value);
-  occupied_[bucket_ind / 8] |= (1 << (bucket_ind % 8));
+  tags_[bucket_ind] = tag;
+  occupied_[bucket_ind / 8].fetch_or(static_cast<char>(1 << (bucket_ind % 8)), std::memory_order_release);
+  readable_[bucket_ind / 8].fetch_or(static_cast<char>(1 << (bucket_ind % 8)), std::memory_order_release);
+  if (reuse) {
+    version_.store(version + 2, std::memory_order_release);
+  }
   return true;
+}
 
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_BLOCK_TYPE::ReadPair(slot_offset_t bucket_ind, MappingType *pair) const {
+  while (true) {
+    uint32_t version = version_.load(std::memory_order_acquire);
+    if ((version & 1) != 0) {
+      continue;
+    }
+    if (!IsReadable(bucket_ind)) {
+      return false;
+    }
+    *pair = array_[bucket_ind];
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (version_.load(std::memory_order_relaxed) == version) {
+      return true;
+    }
+  }
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
@@ -48,19 +84,66 @@ void HASH_TABLE_BLOCK_TYPE::Remove(slot_offset_t bucket_ind) {
   // if (!IsReadable(bucket_ind)) {
   //   throw std::runtime_error("Bucket " + std::to_string(bucket_ind) + " is not readable");
   // }
-  char expected = readable_[bucket_ind / 8];
-  char desired = readable_[bucket_ind / 8] & ~(1 << (bucket_ind % 8));
-  readable_[bucket_ind / 8].compare_exchange_weak(expected, desired);
+  readable_[bucket_ind / 8].fetch_and(static_cast<char>(~(1 << (bucket_ind % 8))), std::memory_order_release);
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_BLOCK_TYPE::IsOccupied(slot_offset_t bucket_ind) const {
-  return (occupied_[bucket_ind / 8] >> (bucket_ind % 8)) & 1;
+  return (occupied_[bucket_ind / 8].load(std::memory_order_acquire) >> (bucket_ind % 8)) & 1;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_BLOCK_TYPE::IsReadable(slot_offset_t bucket_ind) const {
-  return (readable_[bucket_ind / 8] >> (bucket_ind % 8)) & 1;
+  return (readable_[bucket_ind / 8].load(std::memory_order_acquire) >> (bucket_ind % 8)) & 1;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint32_t HASH_TABLE_BLOCK_TYPE::GroupBits(const std::atomic_char *bitmap, size_t group) {
+  // a group spans TAG_GROUP_SIZE / 8 bitmap bytes, the last group may run past the bitmap
+  uint32_t bits = 0;
+  size_t first = group * TAG_GROUP_SIZE / 8;
+  size_t end = std::min<size_t>(first + TAG_GROUP_SIZE / 8, (BLOCK_ARRAY_SIZE - 1) / 8 + 1);
+  for (size_t i = first; i < end; i++) {
+    bits |= static_cast<uint32_t>(static_cast<uint8_t>(bitmap[i].load(std::memory_order_acquire))) << (8 * (i - first));
+  }
+  return bits;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint32_t HASH_TABLE_BLOCK_TYPE::OccupiedMask(size_t group) const {
+  return GroupBits(occupied_, group);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint32_t HASH_TABLE_BLOCK_TYPE::ReadableMask(size_t group) const {
+  return GroupBits(readable_, group);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint32_t HASH_TABLE_BLOCK_TYPE::MatchTag(size_t group, uint8_t tag) const {
+  // load the readable bits first, the tags of the slots they cover are published by then
+  uint32_t readable = ReadableMask(group);
+  const uint8_t *tags = tags_ + group * TAG_GROUP_SIZE;
+  uint32_t matches;
+  // the build compiles with -march=native, so the AVX2 path is taken whenever the build host supports AVX2
+#if defined(__AVX2__)
+  __m256i group_tags = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(tags));
+  __m256i needle = _mm256_set1_epi8(static_cast<char>(tag));
+  matches = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(group_tags, needle)));
+#elif defined(__SSE2__)
+  __m128i needle = _mm_set1_epi8(static_cast<char>(tag));
+  __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i *>(tags));
+  __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i *>(tags + 16));
+  matches = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(low, needle))) |
+            (static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(high, needle))) << 16);
+#else
+  matches = 0;
+  for (size_t i = 0; i < TAG_GROUP_SIZE; i++) {
+    matches |= static_cast<uint32_t>(tags[i] == tag) << i;
+  }
+#endif
+  // a stale tag of a tombstone or an empty slot must not match
+  return matches & readable;
 }
 
 // DO NOT REMOVE ANYTHING BELOW THIS LINE
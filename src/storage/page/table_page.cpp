@@ -266,6 +266,24 @@ void TablePage::RollbackDelete(const RID &rid, Transaction *txn, LogManager *log
 }
 
 bool TablePage::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, LockManager *lock_manager) {
+  uint32_t tuple_size;
+  const char *tuple_data = ReadTuple(rid, &tuple_size, txn, lock_manager);
+  if (tuple_data == nullptr) {
+    return false;
+  }
+  // Copy the tuple data into our result.
+  tuple->size_ = tuple_size;
+  if (tuple->allocated_) {
+    delete[] tuple->data_;
+  }
+  tuple->data_ = new char[tuple->size_];
+  memcpy(tuple->data_, tuple_data, tuple->size_);
+  tuple->rid_ = rid;
+  tuple->allocated_ = true;
+  return true;
+}
+
+const char *TablePage::ReadTuple(const RID &rid, uint32_t *size, Transaction *txn, LockManager *lock_manager) {
   // Get the current slot number.
   uint32_t slot_num = rid.GetSlotNum();
   // If somehow we have more slots than tuples, abort the transaction.
@@ -273,7 +291,7 @@ bool TablePage::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, LockMan
     if (enable_logging) {
       txn->SetState(TransactionState::ABORTED);
     }
-    return false;
+    return nullptr;
   }
   // Otherwise get the current tuple size too.
   uint32_t tuple_size = GetTupleSize(slot_num);
@@ -282,27 +300,19 @@ bool TablePage::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, LockMan
     if (enable_logging) {
       txn->SetState(TransactionState::ABORTED);
     }
-    return false;
+    return nullptr;
   }
 
   // Otherwise we have a valid tuple, try to acquire at least a shared lock.
   if (enable_logging) {
     if (!txn->IsSharedLocked(rid) && !txn->IsExclusiveLocked(rid) && !lock_manager->LockShared(txn, rid)) {
-      return false;
+      return nullptr;
     }
   }
 
-  // At this point, we have at least a shared lock on the RID. Copy the tuple data into our result.
-  uint32_t tuple_offset = GetTupleOffsetAtSlot(slot_num);
-  tuple->size_ = tuple_size;
-  if (tuple->allocated_) {
-    delete[] tuple->data_;
-  }
-  tuple->data_ = new char[tuple->size_];
-  memcpy(tuple->data_, GetData() + tuple_offset, tuple->size_);
-  tuple->rid_ = rid;
-  tuple->allocated_ = true;
-  return true;
+  // At this point, we have at least a shared lock on the RID.
+  *size = tuple_size;
+  return GetData() + GetTupleOffsetAtSlot(slot_num);
 }
 
 bool TablePage::GetFirstTupleRid(RID *first_rid) {
@@ -11,7 +11,9 @@
 //===----------------------------------------------------------------------===//
 
 #include <cassert>
+#include <cstring>
 
+#include "common/exception.h"
 #include "common/logger.h"
 #include "storage/table/table_heap.h"
 
@@ -169,6 +171,52 @@ bool TableHeap::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn) {
   return res;
 }
 
+page_id_t TableHeap::ScanPage(page_id_t page_id, std::vector<Tuple> *tuples, Transaction *txn,
+                             const TupleFilter &filter, const TupleProjection *projection) {
+  tuples->clear();
+  auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "no frame to read a table page into");
+  }
+  page->RLatch();
+  RID rid;
+  for (bool found = page->GetFirstTupleRid(&rid); found; found = page->GetNextTupleRid(rid, &rid)) {
+    uint32_t size;
+    const char *data = page->ReadTuple(rid, &size, txn, lock_manager_);
+    // a tuple the transaction cannot lock is left out
+    if (data == nullptr || (filter != nullptr && !filter(data))) {
+      continue;
+    }
+    tuples->emplace_back();
+    Tuple &tuple = tuples->back();
+    if (projection != nullptr) {
+      projection->Project(data, rid, &tuple);
+    } else {
+      tuple.data_ = new char[size];
+      memcpy(tuple.data_, data, size);
+      tuple.size_ = size;
+      tuple.rid_ = rid;
+      tuple.allocated_ = true;
+    }
+  }
+  page_id_t next_page_id = page->GetNextPageId();
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  return next_page_id;
+}
+
+page_id_t TableHeap::GetNextPageId(page_id_t page_id) {
+  auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "no frame to read a table page into");
+  }
+  page->RLatch();
+  page_id_t next_page_id = page->GetNextPageId();
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  return next_page_id;
+}
+
 TableIterator TableHeap::Begin(Transaction *txn) {
   // Start an iterator from the first page.
   // TODO(Wuwen): Hacky fix for now. Removing empty pages is a better way to handle this.
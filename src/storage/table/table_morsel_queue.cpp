@@ -0,0 +1,36 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_morsel_queue.cpp
+//
+// Identification: src/storage/table/table_morsel_queue.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/table_morsel_queue.h"
+
+namespace bustub {
+
+TableMorselQueue::TableMorselQueue(TableHeap *table_heap, size_t morsel_pages)
+    : table_heap_(table_heap), morsel_pages_(morsel_pages), next_page_id_(table_heap->GetFirstPageId()) {
+  BUSTUB_ASSERT(morsel_pages > 0, "a morsel must have a page");
+}
+
+bool TableMorselQueue::Next(TableMorsel *morsel) {
+  std::scoped_lock latch{latch_};
+  if (next_page_id_ == INVALID_PAGE_ID) {
+    return false;
+  }
+  morsel->first_page_id_ = next_page_id_;
+  morsel->num_pages_ = 0;
+  while (next_page_id_ != INVALID_PAGE_ID && morsel->num_pages_ < morsel_pages_) {
+    next_page_id_ = table_heap_->GetNextPageId(next_page_id_);
+    morsel->num_pages_++;
+  }
+  return true;
+}
+
+}  // namespace bustub
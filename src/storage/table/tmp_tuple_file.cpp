@@ -0,0 +1,70 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tmp_tuple_file.cpp
+//
+// Identification: src/storage/table/tmp_tuple_file.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/tmp_tuple_file.h"
+
+#include <algorithm>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+void TmpTupleFile::Append(const Tuple &tuple) {
+  TmpTuple location(INVALID_PAGE_ID, 0);
+  if (page_ != nullptr && page_->Insert(tuple, &location)) {
+    return;
+  }
+  Close();
+  page_id_t page_id;
+  auto page = static_cast<TmpTuplePage *>(bpm_->NewPage(&page_id));
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "no free frame for a temporary page");
+  }
+  page->Init(page_id, PAGE_SIZE);
+  pages_.push_back(page_id);
+  page_ = page;
+  if (!page->Insert(tuple, &location)) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "tuple does not fit in a temporary page");
+  }
+}
+
+void TmpTupleFile::Close() {
+  if (page_ != nullptr) {
+    bpm_->UnpinPage(pages_.back(), true);
+    page_ = nullptr;
+  }
+}
+
+void TmpTupleFile::Release() {
+  Close();
+  for (page_id_t page_id : pages_) {
+    bpm_->DeletePage(page_id);
+  }
+  pages_.clear();
+}
+
+void TmpTupleFile::ReadPage(size_t page_index, std::vector<Tuple> *tuples) {
+  auto page = static_cast<TmpTuplePage *>(bpm_->FetchPage(pages_[page_index]));
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "no free frame for a temporary page");
+  }
+  tuples->clear();
+  page->ForEachTuple([&](size_t offset) {
+    tuples->emplace_back();
+    page->Get(offset, &tuples->back());
+  });
+  bpm_->UnpinPage(pages_[page_index], false);
+  // the page is read from the last appended tuple
+  std::reverse(tuples->begin(), tuples->end());
+}
+
+}  // namespace bustub
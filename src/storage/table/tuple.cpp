@@ -87,6 +87,29 @@ Tuple &Tuple::operator=(const Tuple &other) {
   return *this;
 }
 
+Tuple::Tuple(Tuple &&other) noexcept
+    : allocated_(other.allocated_), rid_(other.rid_), size_(other.size_), data_(other.data_) {
+  other.allocated_ = false;
+  other.size_ = 0;
+  other.data_ = nullptr;
+}
+
+Tuple &Tuple::operator=(Tuple &&other) noexcept {
+  if (this != &other) {
+    if (allocated_) {
+      delete[] data_;
+    }
+    allocated_ = other.allocated_;
+    rid_ = other.rid_;
+    size_ = other.size_;
+    data_ = other.data_;
+    other.allocated_ = false;
+    other.size_ = 0;
+    other.data_ = nullptr;
+  }
+  return *this;
+}
+
 Value Tuple::GetValue(const Schema *schema, const uint32_t column_idx) const {
   assert(schema);
   assert(data_);
@@ -0,0 +1,76 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_projection.cpp
+//
+// Identification: src/storage/table/tuple_projection.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/tuple_projection.h"
+
+#include <cstring>
+#include <utility>
+
+#include "common/macros.h"
+#include "type/limits.h"
+
+namespace bustub {
+
+namespace {
+
+uint32_t LoadOffset(const char *data) {
+  uint32_t value;
+  memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+// the bytes of a VARCHAR stored at data: its length, then its characters unless it is NULL
+uint32_t VarlenSize(const char *data) {
+  uint32_t length = LoadOffset(data);
+  return sizeof(uint32_t) + (length == BUSTUB_VALUE_NULL ? 0 : length);
+}
+
+}  // namespace
+
+TupleProjection::TupleProjection(const Schema *schema, const Schema *projected_schema, std::vector<uint32_t> columns)
+    : schema_(schema), projected_schema_(projected_schema), columns_(std::move(columns)) {
+  BUSTUB_ASSERT(columns_.size() == projected_schema_->GetColumnCount(), "one column of schema per projected column");
+}
+
+void TupleProjection::Project(const char *data, const RID &rid, Tuple *tuple) const {
+  // the inlined part, then the VARCHARs in the order of their columns, as in Tuple(values, schema)
+  uint32_t size = projected_schema_->GetLength();
+  for (uint32_t i : projected_schema_->GetUnlinedColumns()) {
+    size += VarlenSize(data + LoadOffset(data + schema_->GetColumn(columns_[i]).GetOffset()));
+  }
+  if (tuple->allocated_) {
+    delete[] tuple->data_;
+  }
+  tuple->data_ = new char[size];
+  tuple->size_ = size;
+  tuple->allocated_ = true;
+  tuple->rid_ = rid;
+
+  uint32_t offset = projected_schema_->GetLength();
+  // the slot of a VARCHAR is wider than its offset, zeroed as by Tuple(values, schema)
+  memset(tuple->data_, 0, offset);
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    const Column &from = schema_->GetColumn(columns_[i]);
+    const Column &to = projected_schema_->GetColumn(i);
+    if (to.IsInlined()) {
+      memcpy(tuple->data_ + to.GetOffset(), data + from.GetOffset(), to.GetFixedLength());
+    } else {
+      const char *varlen = data + LoadOffset(data + from.GetOffset());
+      uint32_t varlen_size = VarlenSize(varlen);
+      memcpy(tuple->data_ + to.GetOffset(), &offset, sizeof(offset));
+      memcpy(tuple->data_ + offset, varlen, varlen_size);
+      offset += varlen_size;
+    }
+  }
+}
+
+}  // namespace bustub
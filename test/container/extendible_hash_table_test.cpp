@@ -0,0 +1,172 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_hash_table_test.cpp
+//
+// Identification: test/container/extendible_hash_table_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <vector>
+
+#include "container/hash/extendible_hash_table.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(ExtendibleHashTableTest, SampleTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1000, HashFunction<int>());
+
+  // insert a few values, with a second value for each key
+  for (int i = 0; i < 5; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+    if (i == 0) {
+      // duplicate values for the same key are not allowed
+      EXPECT_FALSE(ht.Insert(nullptr, i, 2 * i));
+    } else {
+      EXPECT_TRUE(ht.Insert(nullptr, i, 2 * i));
+    }
+  }
+  for (int i = 0; i < 5; i++) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    EXPECT_EQ(i == 0 ? 1 : 2, res.size()) << "Failed to keep " << i << std::endl;
+  }
+
+  // look for a key that does not exist
+  std::vector<int> res;
+  EXPECT_FALSE(ht.GetValue(nullptr, 20, &res));
+
+  // delete the first value of every key
+  for (int i = 0; i < 5; i++) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+    EXPECT_FALSE(ht.Remove(nullptr, i, i));
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    if (i == 0) {
+      EXPECT_EQ(0, res.size());
+    } else {
+      EXPECT_EQ(1, res.size());
+      EXPECT_EQ(2 * i, res[0]);
+    }
+  }
+  ht.VerifyIntegrity();
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(ExtendibleHashTableTest, SplitMergeTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 0, HashFunction<int>());
+  EXPECT_EQ(0, ht.GetGlobalDepth());
+
+  // enough keys to split the single initial bucket many times
+  const int num_keys = 10000;
+  for (int i = 0; i < num_keys; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+  }
+  ht.VerifyIntegrity();
+  EXPECT_GT(ht.GetGlobalDepth(), 0);
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    ASSERT_EQ(1, res.size()) << "Failed to keep " << i << std::endl;
+    EXPECT_EQ(i, res[0]);
+  }
+
+  // emptied buckets merge back and the directory shrinks
+  for (int i = 0; i < num_keys; i++) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+  }
+  ht.VerifyIntegrity();
+  EXPECT_EQ(0, ht.GetGlobalDepth());
+  for (int i = 0; i < num_keys; i += 100) {
+    std::vector<int> res;
+    EXPECT_FALSE(ht.GetValue(nullptr, i, &res));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(ExtendibleHashTableTest, OverflowTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 0, HashFunction<int>());
+
+  // the values of one key share a bucket however deep it splits, so they spill into overflow pages
+  const int hot_key = 7;
+  const int num_values = 2000;
+  for (int i = 0; i < num_values; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, hot_key, i));
+  }
+  for (int i = 0; i < 100; i++) {
+    if (i != hot_key) {
+      EXPECT_TRUE(ht.Insert(nullptr, i, i));
+    }
+  }
+  EXPECT_EQ(DIRECTORY_MAX_DEPTH, ht.GetGlobalDepth());
+  // duplicates are found in the overflow pages too
+  EXPECT_FALSE(ht.Insert(nullptr, hot_key, 0));
+  EXPECT_FALSE(ht.Insert(nullptr, hot_key, num_values - 1));
+  ht.VerifyIntegrity();
+
+  std::vector<int> res;
+  EXPECT_TRUE(ht.GetValue(nullptr, hot_key, &res));
+  std::sort(res.begin(), res.end());
+  ASSERT_EQ(num_values, res.size());
+  for (int i = 0; i < num_values; i++) {
+    EXPECT_EQ(i, res[i]);
+  }
+
+  // remove every other value, freed slots are reused
+  for (int i = 0; i < num_values; i += 2) {
+    EXPECT_TRUE(ht.Remove(nullptr, hot_key, i));
+  }
+  EXPECT_FALSE(ht.Remove(nullptr, hot_key, 0));
+  EXPECT_TRUE(ht.Insert(nullptr, hot_key, 0));
+  res.clear();
+  ht.GetValue(nullptr, hot_key, &res);
+  EXPECT_EQ(num_values / 2 + 1, res.size());
+
+  // once the overflow pages empty, the buckets merge back as usual
+  for (int i = 0; i < num_values; i++) {
+    if (i == 0 || i % 2 == 1) {
+      EXPECT_TRUE(ht.Remove(nullptr, hot_key, i));
+    }
+  }
+  for (int i = 0; i < 100; i++) {
+    if (i != hot_key) {
+      EXPECT_TRUE(ht.Remove(nullptr, i, i));
+    }
+  }
+  res.clear();
+  EXPECT_FALSE(ht.GetValue(nullptr, hot_key, &res));
+  ht.VerifyIntegrity();
+  EXPECT_EQ(0, ht.GetGlobalDepth());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+}  // namespace bustub
@@ -0,0 +1,95 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// flat_hash_table_test.cpp
+//
+// Identification: test/container/flat_hash_table_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <string>
+#include <vector>
+
+#include "container/hash/flat_hash_table.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+namespace {
+
+// keys of 4 to 67 bytes with a common prefix, like serialized group-by columns
+std::vector<std::string> MakeKeys(int num_keys) {
+  std::vector<std::string> keys;
+  keys.reserve(num_keys);
+  for (int i = 0; i < num_keys; i++) {
+    keys.push_back(std::string(i % 64, 'k') + std::to_string(i));
+  }
+  return keys;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(FlatHashTableTest, UniqueKeyTest) {
+  FlatHashTable<int> table;
+  const int num_keys = 100000;
+  auto keys = MakeKeys(num_keys);
+  for (int round = 1; round <= 2; round++) {
+    for (int i = 0; i < num_keys; i++) {
+      auto [count, inserted] = table.FindOrInsert(keys[i], [] { return 0; });
+      EXPECT_EQ(round == 1, inserted);
+      (*count)++;
+    }
+  }
+  EXPECT_EQ(num_keys, table.Size());
+  EXPECT_LE(table.Size(), table.Capacity());
+  for (int i = 0; i < num_keys; i++) {
+    int *count = table.Find(keys[i]);
+    ASSERT_NE(nullptr, count) << "Failed to find " << keys[i];
+    EXPECT_EQ(2, *count);
+  }
+  EXPECT_EQ(nullptr, table.Find("absent"));
+
+  // entries come back in insertion order with their keys
+  int i = 0;
+  for (const auto &entry : table) {
+    EXPECT_EQ(keys[i], entry.Key());
+    EXPECT_EQ(FlatHashTable<int>::Hash(keys[i]), entry.hash_);
+    i++;
+  }
+
+  table.Clear();
+  EXPECT_TRUE(table.Empty());
+  EXPECT_EQ(nullptr, table.Find(keys[0]));
+  EXPECT_TRUE(table.FindOrInsert(keys[0], [] { return 0; }).second);
+}
+
+// NOLINTNEXTLINE
+TEST(FlatHashTableTest, DuplicateKeyTest) {
+  FlatHashTable<int> table(16);
+  const int num_keys = 1000;
+  auto keys = MakeKeys(num_keys);
+  for (int i = 0; i < num_keys; i++) {
+    for (int v = 0; v <= i % 4; v++) {
+      table.Insert(keys[i], v);
+    }
+  }
+  // the empty key and a key larger than an arena chunk
+  std::string large(2 * Arena::DEFAULT_CHUNK_SIZE, 'x');
+  table.Insert("", -1);
+  table.Insert(large, -2);
+
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> values;
+    table.ForEachMatch(keys[i], FlatHashTable<int>::Hash(keys[i]), [&values](int v) { values.push_back(v); });
+    EXPECT_EQ(i % 4 + 1, values.size()) << "Wrong matches for " << keys[i];
+  }
+  EXPECT_EQ(-1, *table.Find(""));
+  EXPECT_EQ(-2, *table.Find(large));
+  EXPECT_EQ(nullptr, table.Find(std::string(large.size() - 1, 'x')));
+}
+
+}  // namespace bustub
@@ -0,0 +1,101 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_function_test.cpp
+//
+// Identification: test/container/hash_function_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstring>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "container/hash/hash_function.h"
+#include "gtest/gtest.h"
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+namespace {
+
+// keys the way an index builds them: small integers, most bytes zero
+template <size_t KeySize>
+std::vector<GenericKey<KeySize>> SequentialKeys(int num_keys) {
+  std::vector<GenericKey<KeySize>> keys(num_keys);
+  for (int i = 0; i < num_keys; i++) {
+    if (KeySize < sizeof(int64_t)) {
+      // SetFromInteger writes 8 bytes, a 4 byte key holds an INTEGER column
+      auto column = static_cast<int32_t>(i);
+      memcpy(keys[i].data_, &column, sizeof(column));
+    } else {
+      keys[i].SetFromInteger(i);
+    }
+  }
+  return keys;
+}
+
+// largest bucket load over the mean load, with buckets picked by the low bits and by the top byte
+template <typename KeyType, typename Hasher>
+void CheckSpread(const std::vector<KeyType> &keys, const std::string &name) {
+  HashFunction<KeyType, Hasher> hash_fn;
+  const size_t num_buckets = 256;
+  std::vector<size_t> low_buckets(num_buckets);
+  std::vector<size_t> tag_buckets(num_buckets);
+  std::unordered_set<uint64_t> distinct;
+  for (const auto &key : keys) {
+    uint64_t hash = hash_fn.GetHash(key);
+    low_buckets[hash % num_buckets]++;
+    tag_buckets[hash >> 56]++;
+    distinct.insert(hash);
+  }
+  double mean = static_cast<double>(keys.size()) / num_buckets;
+  for (size_t b = 0; b < num_buckets; b++) {
+    EXPECT_LT(low_buckets[b], 1.5 * mean) << name << " low bits bucket " << b;
+    EXPECT_LT(tag_buckets[b], 1.5 * mean) << name << " tag bucket " << b;
+  }
+  EXPECT_EQ(keys.size(), distinct.size()) << name;
+}
+
+template <size_t KeySize>
+void CheckAllHashers(int num_keys) {
+  auto keys = SequentialKeys<KeySize>(num_keys);
+  std::string size = std::to_string(KeySize);
+  CheckSpread<GenericKey<KeySize>, MurmurHasher>(keys, "murmur3 " + size);
+  CheckSpread<GenericKey<KeySize>, Crc32cHasher>(keys, "crc32c " + size);
+  CheckSpread<GenericKey<KeySize>, XxHash3Hasher>(keys, "xxhash3 " + size);
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(HashFunctionTest, Crc32cTest) {
+  // the check value of CRC-32C
+  std::string input = "123456789";
+  EXPECT_EQ(0xE3069283, Crc32cHasher::Crc32c(input.data(), input.size()));
+  EXPECT_EQ(0, Crc32cHasher::Crc32c(input.data(), 0));
+}
+
+// NOLINTNEXTLINE
+TEST(HashFunctionTest, QualityTest) {
+  const int num_keys = 1 << 16;
+  CheckAllHashers<4>(num_keys);
+  CheckAllHashers<8>(num_keys);
+  CheckAllHashers<16>(num_keys);
+  CheckAllHashers<32>(num_keys);
+  CheckAllHashers<64>(num_keys);
+
+  // integers get multiply-shift by default
+  std::vector<int> ints(num_keys);
+  for (int i = 0; i < num_keys; i++) {
+    ints[i] = i * 1024;
+  }
+  CheckSpread<int, DefaultHasher<int>::type>(ints, "multiply-shift");
+  static_assert(std::is_same_v<DefaultHasher<int64_t>::type, MultiplyShiftHasher>);
+}
+
+}  // namespace bustub
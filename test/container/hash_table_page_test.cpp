@@ -111,4 +111,40 @@ TEST(HashTablePageTest, BlockPageSampleTest) {
   delete bpm;
 }
 
+// NOLINTNEXTLINE
+TEST(HashTablePageTest, BlockPageTagTest) {
+  DiskManager *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(5, disk_manager);
+
+  page_id_t block_page_id = INVALID_PAGE_ID;
+  auto block_page =
+      reinterpret_cast<HashTableBlockPage<int, int, IntComparator> *>(bpm->NewPage(&block_page_id, nullptr)->GetData());
+
+  // fill the first group and a part of the second one, alternating two tags
+  for (unsigned i = 0; i < TAG_GROUP_SIZE + 8; i++) {
+    block_page->Insert(i, i, i, i % 2 == 0 ? 0xAB : 0x12);
+  }
+  EXPECT_EQ(0x55555555U, block_page->MatchTag(0, 0xAB));
+  EXPECT_EQ(0xAAAAAAAAU, block_page->MatchTag(0, 0x12));
+  EXPECT_EQ(0x55U, block_page->MatchTag(1, 0xAB));
+  EXPECT_EQ(0U, block_page->MatchTag(0, 0x00));
+  EXPECT_EQ(~0U, block_page->OccupiedMask(0));
+  EXPECT_EQ(0xFFU, block_page->OccupiedMask(1));
+
+  // tombstones keep their tag but never match
+  block_page->Remove(2);
+  EXPECT_EQ(0x55555551U, block_page->MatchTag(0, 0xAB));
+  EXPECT_EQ(~0U, block_page->OccupiedMask(0));
+  EXPECT_EQ(~0U ^ 0x4U, block_page->ReadableMask(0));
+
+  // the tag is the top byte of the hash
+  EXPECT_EQ(0xAB, (HashTableBlockPage<int, int, IntComparator>::TagOf(0xAB00000000000012ULL)));
+
+  bpm->UnpinPage(block_page_id, true, nullptr);
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
 }  // namespace bustub
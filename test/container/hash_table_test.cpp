@@ -10,11 +10,14 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <atomic>
 #include <thread>  // NOLINT
 #include <vector>
 
 #include "common/logger.h"
 #include "container/hash/linear_probe_hash_table.h"
+#include "storage/index/generic_key.h"
+#include "storage/b_plus_tree_test_util.h"  // NOLINT
 #include "gtest/gtest.h"
 #include "murmur3/MurmurHash3.h"
 
@@ -104,4 +107,346 @@ TEST(HashTableTest, SampleTest) {
   delete bpm;
 }
 
+// NOLINTNEXTLINE
+TEST(HashTableTest, IncrementalResizeTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 16, HashFunction<int>());
+
+  // every key stays visible while the table grows through several generations
+  const int num_keys = 5000;
+  bool saw_resize = false;
+  for (int i = 0; i < num_keys; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+    saw_resize = saw_resize || ht.IsResizing();
+    std::vector<int> res;
+    ht.GetValue(nullptr, i / 2, &res);
+    EXPECT_EQ(1, res.size()) << "Failed to keep " << i / 2 << std::endl;
+  }
+  EXPECT_TRUE(saw_resize);
+  EXPECT_GE(ht.GetSize(), num_keys);
+
+  // duplicates are detected in whichever generation holds the pair
+  for (int i = 0; i < num_keys; i += 7) {
+    EXPECT_FALSE(ht.Insert(nullptr, i, i));
+  }
+
+  // removes reach both generations
+  for (int i = 0; i < num_keys; i += 2) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+  }
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    EXPECT_EQ(i % 2, res.size()) << "Wrong values for " << i << std::endl;
+  }
+
+  // an explicit resize keeps every entry as well
+  ht.Resize(ht.GetSize());
+  EXPECT_TRUE(ht.IsResizing());
+  for (int i = 1; i < num_keys; i += 2) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    EXPECT_EQ(1, res.size()) << "Failed to keep " << i << std::endl;
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, ConcurrentReadTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 16, HashFunction<int>());
+
+  // readers look up the keys inserted so far while the writer grows the table through several generations
+  const int num_keys = 5000;
+  std::atomic<int> num_inserted{0};
+  std::atomic<int> num_missed{0};
+  std::vector<std::thread> readers;
+  for (int r = 0; r < 4; r++) {
+    readers.emplace_back([&, r] {
+      for (int round = 0; num_inserted < num_keys; round++) {
+        int upto = num_inserted;
+        for (int i = r; i < upto; i += 4 + round % 7) {
+          std::vector<int> res;
+          ht.GetValue(nullptr, i, &res);
+          if (res.size() != 1 || res[0] != i) {
+            num_missed++;
+          }
+        }
+      }
+    });
+  }
+  for (int i = 0; i < num_keys; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+    num_inserted = i + 1;
+  }
+  for (auto &reader : readers) {
+    reader.join();
+  }
+  EXPECT_EQ(0, num_missed);
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, BulkLoadTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 16, HashFunction<int>());
+
+  // two values per key, loaded on several threads
+  const int num_keys = 10000;
+  std::vector<std::pair<int, int>> entries;
+  for (int i = 0; i < num_keys; i++) {
+    entries.emplace_back(i, i);
+    entries.emplace_back(i, 2 * i + 1);
+  }
+  ht.BulkLoad(entries, 4);
+  EXPECT_FALSE(ht.IsResizing());
+  EXPECT_GE(ht.GetSize(), entries.size());
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    EXPECT_EQ(2, res.size()) << "Failed to load " << i << std::endl;
+  }
+
+  // the loaded table behaves like one built by inserts
+  EXPECT_FALSE(ht.Insert(nullptr, 5, 5));
+  EXPECT_TRUE(ht.Remove(nullptr, 5, 5));
+  EXPECT_TRUE(ht.Insert(nullptr, num_keys, num_keys));
+
+  // a table that is not empty any more gets the new entries loaded, and skips the ones it has
+  std::vector<bool> loaded;
+  ht.BulkLoad({{num_keys + 1, 0}, {num_keys, num_keys}}, 4, &loaded);
+  EXPECT_EQ(std::vector<bool>({true, false}), loaded);
+  std::vector<int> res;
+  ht.GetValue(nullptr, num_keys + 1, &res);
+  EXPECT_EQ(1, res.size());
+  res.clear();
+  ht.GetValue(nullptr, num_keys, &res);
+  EXPECT_EQ(1, res.size());
+
+  // a table reserved for the entries loads them in several batches without resizing
+  LinearProbeHashTable<int, int, IntComparator> reserved("blah2", bpm, IntComparator(), 16, HashFunction<int>());
+  reserved.Reserve(entries.size());
+  EXPECT_EQ(2 * entries.size(), reserved.GetSize());
+  const size_t batch_size = entries.size() / 4;
+  for (size_t begin = 0; begin < entries.size(); begin += batch_size) {
+    reserved.BulkLoad(std::vector<std::pair<int, int>>(entries.begin() + begin, entries.begin() + begin + batch_size),
+                      4);
+    EXPECT_FALSE(reserved.IsResizing());
+    EXPECT_EQ(2 * entries.size(), reserved.GetSize());
+  }
+  for (int i = 0; i < num_keys; i++) {
+    res.clear();
+    reserved.GetValue(nullptr, i, &res);
+    EXPECT_EQ(2, res.size()) << "Failed to load " << i << std::endl;
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, MaxSizeTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  // wide keys, so that the largest table has few slots
+  using HashTable = LinearProbeHashTable<GenericKey<64>, RID, GenericComparator<64>>;
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  HashTable ht("blah", bpm, GenericComparator<64>(key_schema), 1000, HashFunction<GenericKey<64>>());
+  auto key_of = [](int64_t i) {
+    GenericKey<64> key;
+    key.SetFromInteger(i);
+    return key;
+  };
+
+  // past MAX_LOAD_FACTOR of the largest size the table stops growing and goes on filling its slots
+  const int64_t num_keys = HashTable::MAX_NUM_BUCKETS * 19 / 20;
+  for (int64_t i = 0; i < num_keys; i++) {
+    ASSERT_TRUE(ht.Insert(nullptr, key_of(i), RID(i))) << "Failed to insert " << i << std::endl;
+  }
+  while (ht.ResizeStep()) {
+  }
+  EXPECT_EQ(HashTable::MAX_NUM_BUCKETS, ht.GetSize());
+  for (int64_t i = 0; i < num_keys; i += 97) {
+    std::vector<RID> res;
+    ht.GetValue(nullptr, key_of(i), &res);
+    EXPECT_EQ(1, res.size()) << "Failed to find " << i << std::endl;
+  }
+
+  // the table stays usable
+  EXPECT_TRUE(ht.Remove(nullptr, key_of(0), RID(0)));
+  EXPECT_TRUE(ht.Insert(nullptr, key_of(num_keys), RID(num_keys)));
+  std::vector<RID> res;
+  ht.GetValue(nullptr, key_of(num_keys), &res);
+  EXPECT_EQ(1, res.size());
+
+  delete key_schema;
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, BulkLoadMaxSizeTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  using HashTable = LinearProbeHashTable<int, int, IntComparator>;
+  HashTable ht("blah", bpm, IntComparator(), 16, HashFunction<int>());
+
+  // more entries than half the slots a header page can address, the table is capped instead of doubled
+  const int num_keys = HashTable::MAX_NUM_BUCKETS * 2 / 3;
+  std::vector<std::pair<int, int>> entries;
+  for (int i = 0; i < num_keys; i++) {
+    entries.emplace_back(i, i);
+  }
+  ht.BulkLoad(entries, 4);
+  EXPECT_EQ(HashTable::MAX_NUM_BUCKETS, ht.GetSize());
+  for (int i = 0; i < num_keys; i += 97) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    EXPECT_EQ(1, res.size()) << "Failed to load " << i << std::endl;
+  }
+
+  // more entries than MAX_LOAD_FACTOR of the largest size are not bulk loaded
+  HashTable too_small("blah2", bpm, IntComparator(), 16, HashFunction<int>());
+  entries.resize(static_cast<size_t>(HashTable::MAX_LOAD_FACTOR * HashTable::MAX_NUM_BUCKETS) + 1);
+  EXPECT_THROW(too_small.BulkLoad(entries, 4), Exception);
+  EXPECT_THROW(too_small.Reserve(entries.size()), Exception);
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, CompactionTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1000, HashFunction<int>());
+  size_t size = ht.GetSize();
+
+  // a sliding window of 100 live keys leaves tombstones behind, which must not grow the table
+  const int window = 100;
+  const int num_keys = 20000;
+  for (int i = 0; i < num_keys; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+    if (i >= window) {
+      EXPECT_TRUE(ht.Remove(nullptr, i - window, i - window));
+    }
+  }
+  EXPECT_EQ(size, ht.GetSize());
+  while (ht.ResizeStep()) {
+  }
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    EXPECT_EQ(i < num_keys - window ? 0 : 1, res.size()) << "Wrong result for " << i << std::endl;
+  }
+
+  // an explicit compaction keeps the live entries
+  for (int i = num_keys - window; i < num_keys - window / 2; i++) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+  }
+  ht.Compact();
+  EXPECT_TRUE(ht.IsResizing());
+  while (ht.ResizeStep(16)) {
+  }
+  EXPECT_EQ(size, ht.GetSize());
+  for (int i = num_keys - window; i < num_keys; i++) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    EXPECT_EQ(i < num_keys - window / 2 ? 0 : 1, res.size()) << "Wrong result for " << i << std::endl;
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, TombstoneReuseTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1000, HashFunction<int>());
+  size_t size = ht.GetSize();
+
+  // a pair removed and inserted again takes back its tombstone, so no compaction is ever needed
+  for (int round = 0; round < 2000; round++) {
+    for (int i = 0; i < 100; i++) {
+      EXPECT_TRUE(ht.Insert(nullptr, i, round));
+    }
+    for (int i = 0; i < 100; i++) {
+      EXPECT_TRUE(ht.Remove(nullptr, i, round));
+    }
+    EXPECT_FALSE(ht.IsResizing());
+  }
+  EXPECT_EQ(size, ht.GetSize());
+  for (int i = 0; i < 100; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+    EXPECT_FALSE(ht.Insert(nullptr, i, i));
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    EXPECT_EQ(std::vector<int>{i}, res);
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, PendingResizeTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1000, HashFunction<int>());
+  const int num_keys = 500;
+  for (int i = 0; i < num_keys; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+  }
+
+  // a resize asked for during another one waits for it instead of moving every entry at once
+  ht.Resize(1000);
+  EXPECT_EQ(2000, ht.GetSize());
+  ht.Resize(4000);
+  EXPECT_TRUE(ht.IsResizing());
+  EXPECT_EQ(2000, ht.GetSize());
+  while (ht.ResizeStep()) {
+  }
+  EXPECT_EQ(8000, ht.GetSize());
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    EXPECT_EQ(std::vector<int>{i}, res);
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
 }  // namespace bustub
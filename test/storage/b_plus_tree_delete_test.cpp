@@ -3,7 +3,10 @@
  */
 
 #include <algorithm>
+#include <chrono>  // NOLINT
 #include <cstdio>
+#include <thread>  // NOLINT
+#include <vector>
 
 #include "b_plus_tree_test_util.h"  // NOLINT
 #include "buffer/buffer_pool_manager.h"
@@ -12,7 +15,38 @@
 
 namespace bustub {
 
-TEST(BPlusTreeTests, DISABLED_DeleteTest1) {
+using DeleteTestTree = BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
+
+// the slot numbers of all entries, in iteration order
+std::vector<int64_t> CollectSlots(DeleteTestTree *tree, bool reverse) {
+  std::vector<int64_t> slots;
+  for (auto iterator = reverse ? tree->rbegin() : tree->begin(); iterator != tree->end(); ++iterator) {
+    slots.push_back((*iterator).second.GetSlotNum());
+  }
+  return slots;
+}
+
+uint64_t CountLeaves(DeleteTestTree *tree) {
+  IndexStatistics stats;
+  std::vector<GenericKey<8>> sample;
+  tree->SampleLeaves(1, &stats, &sample);
+  return stats.leaf_page_count_;
+}
+
+// the number of entries of every leaf, in key order
+std::vector<size_t> LeafSizes(DeleteTestTree *tree) {
+  IndexStatistics stats;
+  std::vector<GenericKey<8>> sample;
+  std::vector<size_t> leaf_ends;
+  tree->SampleLeaves(CountLeaves(tree), &stats, &sample, &leaf_ends);
+  std::vector<size_t> sizes;
+  for (size_t i = 0; i < leaf_ends.size(); i++) {
+    sizes.push_back(leaf_ends[i] - (i == 0 ? 0 : leaf_ends[i - 1]));
+  }
+  return sizes;
+}
+
+TEST(BPlusTreeTests, DeleteTest1) {
   // create KeyComparator and index schema
   std::string createStmt = "a bigint";
   Schema *key_schema = ParseCreateStatement(createStmt);
@@ -92,7 +126,7 @@ TEST(BPlusTreeTests, DISABLED_DeleteTest1) {
   remove("test.log");
 }
 
-TEST(BPlusTreeTests, DISABLED_DeleteTest2) {
+TEST(BPlusTreeTests, DeleteTest2) {
   // create KeyComparator and index schema
   Schema *key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema);
@@ -170,4 +204,194 @@ TEST(BPlusTreeTests, DISABLED_DeleteTest2) {
   remove("test.db");
   remove("test.log");
 }
+
+TEST(BPlusTreeTests, LazyRemoveTest) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  DeleteTestTree tree("foo_pk", bpm, comparator, 4, 5);
+  GenericKey<8> index_key;
+  RID rid;
+
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  for (int64_t key = 1; key <= 1000; key++) {
+    rid.Set(0, key);
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, rid);
+  }
+  uint64_t full_leaves = CountLeaves(&tree);
+
+  // keep every tenth key, leaving most leaves underfull or empty
+  tree.SetLazyRemove(true);
+  std::vector<int64_t> kept;
+  for (int64_t key = 1; key <= 1000; key++) {
+    if (key % 10 == 0) {
+      kept.push_back(key);
+      continue;
+    }
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key);
+  }
+  EXPECT_GT(tree.GetNumUnderfullLeaves(), 0);
+  EXPECT_EQ(CountLeaves(&tree), full_leaves);
+
+  // lookups and scans skip the leaves left behind
+  EXPECT_EQ(CollectSlots(&tree, false), kept);
+  std::vector<int64_t> reversed(kept.rbegin(), kept.rend());
+  EXPECT_EQ(CollectSlots(&tree, true), reversed);
+  std::vector<RID> rids;
+  for (int64_t key = 1; key <= 1000; key++) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_EQ(tree.GetValue(index_key, &rids), key % 10 == 0);
+  }
+  std::vector<int64_t> range;
+  GenericKey<8> low;
+  GenericKey<8> high;
+  low.SetFromInteger(95);
+  high.SetFromInteger(305);
+  for (auto iterator = tree.Begin(low, high); iterator != tree.end(); ++iterator) {
+    range.push_back((*iterator).second.GetSlotNum());
+  }
+  EXPECT_EQ(range, std::vector<int64_t>(kept.begin() + 9, kept.begin() + 30));
+
+  // merging shrinks the leaf level without losing or reordering keys
+  EXPECT_EQ(tree.MergeUnderfullLeaves(5), 5);
+  tree.SetLazyRemove(false);
+  EXPECT_EQ(tree.GetNumUnderfullLeaves(), 0);
+  EXPECT_LT(CountLeaves(&tree), full_leaves / 5);
+  EXPECT_EQ(CollectSlots(&tree, false), kept);
+  EXPECT_EQ(CollectSlots(&tree, true), reversed);
+  // no leaf is left underfull, with a leaf max size of 4
+  std::vector<size_t> sizes = LeafSizes(&tree);
+  ASSERT_GT(sizes.size(), 1);
+  for (auto size : sizes) {
+    EXPECT_GE(size, 2);
+  }
+
+  // eager removes take the tree down to nothing and it can grow again
+  for (auto key : kept) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key);
+  }
+  EXPECT_TRUE(tree.IsEmpty());
+  EXPECT_TRUE(tree.begin() == tree.end());
+  rid.Set(0, 7);
+  index_key.SetFromInteger(7);
+  EXPECT_TRUE(tree.Insert(index_key, rid));
+  EXPECT_EQ(CollectSlots(&tree, false), std::vector<int64_t>{7});
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, BackgroundMergeTest) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  DeleteTestTree tree("foo_pk", bpm, comparator, 4, 5);
+  GenericKey<8> index_key;
+  RID rid;
+
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  const int64_t num_keys = 4000;
+  for (int64_t key = 1; key <= num_keys; key++) {
+    rid.Set(0, key);
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, rid);
+  }
+  uint64_t full_leaves = CountLeaves(&tree);
+
+  auto saved_interval = index_merge_interval;
+  index_merge_interval = std::chrono::milliseconds(1);
+  tree.SetLazyRemove(true);
+  tree.StartBackgroundMerge();
+
+  // removers, an inserter and scanners run against the merge thread
+  const int num_removers = 4;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_removers; i++) {
+    threads.emplace_back([&tree, i] {
+      GenericKey<8> key;
+      for (int64_t k = 1 + i; k <= num_keys; k += num_removers) {
+        if (k % 8 != 0) {
+          key.SetFromInteger(k);
+          tree.Remove(key);
+        }
+      }
+    });
+  }
+  threads.emplace_back([&tree] {
+    GenericKey<8> key;
+    RID value;
+    for (int64_t k = num_keys + 1; k <= num_keys + 200; k++) {
+      value.Set(0, k);
+      key.SetFromInteger(k);
+      tree.Insert(key, value);
+    }
+  });
+  bool ordered = true;
+  threads.emplace_back([&tree, &ordered] {
+    for (int pass = 0; pass < 20; pass++) {
+      for (bool reverse : {false, true}) {
+        std::vector<int64_t> slots = CollectSlots(&tree, reverse);
+        if (reverse) {
+          std::reverse(slots.begin(), slots.end());
+        }
+        ordered = ordered && std::is_sorted(slots.begin(), slots.end()) &&
+                  std::adjacent_find(slots.begin(), slots.end()) == slots.end();
+      }
+    }
+  });
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_TRUE(ordered);
+
+  // once removes stop, the merge thread catches up on its own
+  for (int i = 0; i < 1000 && tree.GetNumUnderfullLeaves() > 0; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  EXPECT_EQ(tree.GetNumUnderfullLeaves(), 0);
+  tree.StopBackgroundMerge();
+  index_merge_interval = saved_interval;
+  EXPECT_LT(CountLeaves(&tree), full_leaves / 2);
+
+  std::vector<int64_t> expected;
+  for (int64_t key = 8; key <= num_keys; key += 8) {
+    expected.push_back(key);
+  }
+  for (int64_t key = num_keys + 1; key <= num_keys + 200; key++) {
+    expected.push_back(key);
+  }
+  EXPECT_EQ(CollectSlots(&tree, false), expected);
+  std::vector<RID> rids;
+  for (int64_t key = 1; key <= num_keys + 200; key++) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_EQ(tree.GetValue(index_key, &rids), key % 8 == 0 || key > num_keys);
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
 }  // namespace bustub
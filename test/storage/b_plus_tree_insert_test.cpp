@@ -4,15 +4,21 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <random>
+#include <set>
+#include <thread>  // NOLINT
+#include <vector>
 
 #include "b_plus_tree_test_util.h"  // NOLINT
 #include "buffer/buffer_pool_manager.h"
 #include "gtest/gtest.h"
 #include "storage/index/b_plus_tree.h"
+#include "storage/index/b_plus_tree_index.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 
-TEST(BPlusTreeTests, DISABLED_InsertTest1) {
+TEST(BPlusTreeTests, InsertTest1) {
   // create KeyComparator and index schema
   Schema *key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema);
@@ -71,7 +77,7 @@ TEST(BPlusTreeTests, DISABLED_InsertTest1) {
   remove("test.log");
 }
 
-TEST(BPlusTreeTests, DISABLED_InsertTest2) {
+TEST(BPlusTreeTests, InsertTest2) {
   // create KeyComparator and index schema
   Schema *key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema);
@@ -139,4 +145,312 @@ TEST(BPlusTreeTests, DISABLED_InsertTest2) {
   remove("test.db");
   remove("test.log");
 }
+
+TEST(BPlusTreeTests, GetValuesTest) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  // small pages, so that the batch crosses many leaves and internal pages
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 5);
+  GenericKey<8> index_key;
+  Transaction *transaction = new Transaction(0);
+
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  std::vector<std::vector<RID>> results;
+  index_key.SetFromInteger(1);
+  tree.GetValues({index_key}, &results, transaction);
+  ASSERT_EQ(1, results.size());
+  EXPECT_TRUE(results[0].empty());
+
+  // the even keys in random order
+  std::vector<int64_t> keys;
+  for (int64_t key = 0; key < 1000; key += 2) {
+    keys.push_back(key);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(0));
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    ASSERT_TRUE(tree.Insert(index_key, RID(static_cast<int32_t>(key), static_cast<uint32_t>(key)), transaction));
+  }
+
+  // present and absent keys, unsorted and repeated
+  std::vector<int64_t> probe_keys;
+  std::mt19937 generator(1);
+  for (int i = 0; i < 300; i++) {
+    probe_keys.push_back(generator() % 1100);
+  }
+  probe_keys.push_back(-1);
+  probe_keys.push_back(probe_keys.front());
+  std::vector<GenericKey<8>> probes;
+  for (auto key : probe_keys) {
+    index_key.SetFromInteger(key);
+    probes.push_back(index_key);
+  }
+  tree.GetValues(probes, &results, transaction);
+  ASSERT_EQ(probes.size(), results.size());
+  for (size_t i = 0; i < probes.size(); i++) {
+    int64_t key = probe_keys[i];
+    if (key >= 0 && key < 1000 && key % 2 == 0) {
+      ASSERT_EQ(1, results[i].size());
+      EXPECT_EQ(RID(static_cast<int32_t>(key), static_cast<uint32_t>(key)), results[i][0]);
+    } else {
+      EXPECT_TRUE(results[i].empty());
+    }
+    std::vector<RID> expected;
+    tree.GetValue(probes[i], &expected);
+    EXPECT_EQ(expected, results[i]);
+  }
+
+  tree.GetValues({}, &results, transaction);
+  EXPECT_TRUE(results.empty());
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, IndexScanKeysTest) {
+  Schema *schema = ParseCreateStatement("a bigint,b integer");
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  Transaction *transaction = new Transaction(0);
+
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>> index(new IndexMetadata("foo_pk", "foo", schema, {0}),
+                                                                 bpm);
+  auto make_key = [&](int64_t key) {
+    return Tuple(std::vector<Value>{ValueFactory::GetBigIntValue(key)}, index.GetKeySchema());
+  };
+  for (int64_t key = 0; key < 2000; key += 3) {
+    index.InsertEntry(make_key(key), RID(0, static_cast<uint32_t>(key)), transaction);
+  }
+
+  std::vector<Tuple> keys;
+  for (int64_t key = 2100; key >= -10; key -= 7) {
+    keys.push_back(make_key(key));
+  }
+  std::vector<std::vector<RID>> results;
+  index.ScanKeys(keys, &results, transaction);
+  ASSERT_EQ(keys.size(), results.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    std::vector<RID> expected;
+    index.ScanKey(keys[i], &expected, transaction);
+    EXPECT_EQ(expected, results[i]);
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete schema;
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, BloomFilterIndexTest) {
+  Schema *schema = ParseCreateStatement("a bigint,b integer");
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  Transaction *transaction = new Transaction(0);
+
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>> index(new IndexMetadata("foo_pk", "foo", schema, {0}),
+                                                                 bpm);
+  const int64_t num_keys = 1000;
+  index.EnableBloomFilter(num_keys);
+  auto make_key = [&](int64_t key) {
+    return Tuple(std::vector<Value>{ValueFactory::GetBigIntValue(key)}, index.GetKeySchema());
+  };
+  auto filter_is_empty = [&] {
+    std::mt19937_64 rng(7);
+    for (int i = 0; i < 10000; i++) {
+      if (index.GetBloomFilter()->MayContain(rng())) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  // failed inserts and deletes of absent keys leave the filter counts alone
+  for (int64_t key = 0; key < num_keys; key += 2) {
+    index.InsertEntry(make_key(key), RID(0, static_cast<uint32_t>(key)), transaction);
+    index.InsertEntry(make_key(key), RID(0, static_cast<uint32_t>(key)), transaction);
+    index.DeleteEntry(make_key(key + 1), RID(), transaction);
+  }
+  index.DeleteEntry(make_key(0), RID(0, 0), transaction);
+  index.DeleteEntry(make_key(0), RID(0, 0), transaction);
+  std::vector<RID> rids;
+  for (int64_t key = 2; key < num_keys; key += 2) {
+    rids.clear();
+    index.ScanKey(make_key(key), &rids, transaction);
+    ASSERT_EQ(1, rids.size()) << key;
+  }
+  for (int64_t key = 2; key < num_keys; key += 2) {
+    index.DeleteEntry(make_key(key), RID(0, static_cast<uint32_t>(key)), transaction);
+  }
+  EXPECT_TRUE(filter_is_empty());
+
+  // threads inserting and deleting the same keys must not make the counts drift either
+  const int num_threads = 4;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      Transaction thread_transaction(t + 1);
+      for (int round = 0; round < 5; round++) {
+        for (int64_t key = 0; key < 200; key++) {
+          index.InsertEntry(make_key(key), RID(0, static_cast<uint32_t>(key)), &thread_transaction);
+          index.DeleteEntry(make_key(key), RID(0, static_cast<uint32_t>(key)), &thread_transaction);
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (int64_t key = 0; key < 200; key++) {
+    index.InsertEntry(make_key(key), RID(0, static_cast<uint32_t>(key)), transaction);
+  }
+  for (int64_t key = 0; key < 200; key++) {
+    rids.clear();
+    index.ScanKey(make_key(key), &rids, transaction);
+    ASSERT_EQ(1, rids.size()) << key;
+  }
+  for (int64_t key = 0; key < 200; key++) {
+    index.DeleteEntry(make_key(key), RID(0, static_cast<uint32_t>(key)), transaction);
+  }
+  EXPECT_TRUE(filter_is_empty());
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete schema;
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, ReverseIterationTest) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  // small pages, so that the scans cross many leaves whose prev links were set by splits
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 5);
+  GenericKey<8> index_key;
+  Transaction *transaction = new Transaction(0);
+
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  EXPECT_TRUE(tree.rbegin() == tree.end());
+
+  // the multiples of 3 below 3000 in random order
+  std::vector<int64_t> keys;
+  for (int64_t key = 0; key < 3000; key += 3) {
+    keys.push_back(key);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(0));
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    ASSERT_TRUE(tree.Insert(index_key, RID(0, static_cast<uint32_t>(key)), transaction));
+  }
+  std::sort(keys.begin(), keys.end());
+
+  auto collect = [&](IndexIterator<GenericKey<8>, RID, GenericComparator<8>> iterator) {
+    std::vector<int64_t> result;
+    for (; iterator != tree.end(); ++iterator) {
+      result.push_back((*iterator).second.GetSlotNum());
+    }
+    return result;
+  };
+  // the keys in [low, high] in ascending order, without the bounds that are exclusive
+  auto range = [&](int64_t low, int64_t high, bool low_inclusive, bool high_inclusive) {
+    std::vector<int64_t> result;
+    for (auto key : keys) {
+      if ((key > low || (key == low && low_inclusive)) && (key < high || (key == high && high_inclusive))) {
+        result.push_back(key);
+      }
+    }
+    return result;
+  };
+  auto make_key = [](int64_t key) {
+    GenericKey<8> index_key;
+    index_key.SetFromInteger(key);
+    return index_key;
+  };
+
+  std::vector<int64_t> expected(keys.rbegin(), keys.rend());
+  EXPECT_EQ(expected, collect(tree.rbegin()));
+  EXPECT_EQ(keys, collect(tree.begin()));
+
+  // from a key in the tree and from one between two keys
+  expected = range(0, 1500, true, true);
+  std::reverse(expected.begin(), expected.end());
+  EXPECT_EQ(expected, collect(tree.RBegin(make_key(1500))));
+  expected = range(0, 1000, true, true);
+  std::reverse(expected.begin(), expected.end());
+  EXPECT_EQ(expected, collect(tree.RBegin(make_key(1000))));
+
+  // bounds in the tree, between keys and outside of the keys, both ends inclusive or exclusive
+  std::vector<std::pair<int64_t, int64_t>> bounds{{300, 600}, {301, 601}, {-10, 30}, {2990, 4000}, {600, 600}};
+  for (const auto &[low, high] : bounds) {
+    for (int flags = 0; flags < 4; flags++) {
+      bool low_inclusive = (flags & 1) != 0;
+      bool high_inclusive = (flags & 2) != 0;
+      expected = range(low, high, low_inclusive, high_inclusive);
+      EXPECT_EQ(expected, collect(tree.Begin(make_key(low), make_key(high), low_inclusive, high_inclusive)))
+          << low << " " << high << " " << flags;
+      std::reverse(expected.begin(), expected.end());
+      EXPECT_EQ(expected, collect(tree.RBegin(make_key(low), make_key(high), low_inclusive, high_inclusive)))
+          << low << " " << high << " " << flags;
+    }
+  }
+
+  // an iterator sees the keys inserted ahead of it while it runs and not the ones removed, although the splits
+  // and merges this causes make the sibling link saved with its copy of a leaf stale
+  std::set<int64_t> remaining(keys.begin(), keys.end());
+  std::vector<int64_t> seen;
+  for (auto iterator = tree.begin(); iterator != tree.end(); ++iterator) {
+    int64_t key = (*iterator).second.GetSlotNum();
+    seen.push_back(key);
+    // past the copied leaf, which holds at most 4 keys
+    if (key < 1500 && key % 3 == 0) {
+      index_key.SetFromInteger(key + 13);
+      ASSERT_TRUE(tree.Insert(index_key, RID(0, static_cast<uint32_t>(key + 13)), transaction));
+      remaining.insert(key + 13);
+      index_key.SetFromInteger(key + 12);
+      tree.Remove(index_key, transaction);
+      remaining.erase(key + 12);
+    }
+  }
+  expected.assign(remaining.begin(), remaining.end());
+  EXPECT_EQ(expected, seen);
+  std::reverse(expected.begin(), expected.end());
+  EXPECT_EQ(expected, collect(tree.rbegin()));
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
 }  // namespace bustub
@@ -0,0 +1,84 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// bloom_filter_test.cpp
+//
+// Identification: test/storage/bloom_filter_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdint>
+
+#include "common/util/hashers.h"
+#include "gtest/gtest.h"
+#include "storage/index/bloom_filter.h"
+
+namespace bustub {
+
+namespace {
+
+uint64_t KeyHash(int64_t key) { return XxHash3Hasher::Hash(&key, sizeof(key)); }
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(BloomFilterTest, FalsePositiveTest) {
+  const int num_keys = 10000;
+  BloomFilter filter(num_keys);
+  EXPECT_GE(filter.GetNumBits(), num_keys * BloomFilter::DEFAULT_BITS_PER_KEY);
+  EXPECT_FALSE(filter.MayContain(KeyHash(0)));
+
+  for (int i = 0; i < num_keys; i++) {
+    filter.Insert(KeyHash(i));
+  }
+  // no false negatives
+  for (int i = 0; i < num_keys; i++) {
+    EXPECT_TRUE(filter.MayContain(KeyHash(i))) << "Lost key " << i;
+  }
+  // about 1% false positives at 10 bits per key
+  const int num_absent = 10 * num_keys;
+  int false_positives = 0;
+  for (int i = num_keys; i < num_keys + num_absent; i++) {
+    false_positives += filter.MayContain(KeyHash(i)) ? 1 : 0;
+  }
+  EXPECT_LT(false_positives, 2 * num_absent / 100);
+}
+
+// NOLINTNEXTLINE
+TEST(BloomFilterTest, RemoveTest) {
+  const int num_keys = 10000;
+  BloomFilter filter(num_keys);
+  for (int i = 0; i < num_keys; i++) {
+    filter.Insert(KeyHash(i));
+  }
+  // a key inserted twice stays until it is removed twice
+  filter.Insert(KeyHash(0));
+  for (int i = 0; i < num_keys; i += 2) {
+    filter.Remove(KeyHash(i));
+  }
+
+  int removed_hits = 0;
+  for (int i = 0; i < num_keys; i++) {
+    if (i % 2 == 1 || i == 0) {
+      EXPECT_TRUE(filter.MayContain(KeyHash(i))) << "Lost key " << i;
+    } else {
+      removed_hits += filter.MayContain(KeyHash(i)) ? 1 : 0;
+    }
+  }
+  // the removed keys now only hit as often as keys that were never there
+  EXPECT_LT(removed_hits, num_keys / 2 / 20);
+
+  // an emptied filter holds no bits
+  for (int i = 1; i < num_keys; i += 2) {
+    filter.Remove(KeyHash(i));
+  }
+  filter.Remove(KeyHash(0));
+  for (int i = 0; i < num_keys; i++) {
+    EXPECT_FALSE(filter.MayContain(KeyHash(i)));
+  }
+}
+
+}  // namespace bustub
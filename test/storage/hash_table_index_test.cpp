@@ -0,0 +1,120 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_index_test.cpp
+//
+// Identification: test/storage/hash_table_index_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#include "b_plus_tree_test_util.h"  // NOLINT
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/index/linear_probe_hash_table_index.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(HashTableIndexTest, BulkLoadBloomFilterTest) {
+  Schema *schema = ParseCreateStatement("a bigint,b integer");
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  Transaction transaction(0);
+
+  LinearProbeHashTableIndex<GenericKey<8>, RID, GenericComparator<8>> index(
+      new IndexMetadata("foo_pk", "foo", schema, {0}), bpm, 16, HashFunction<GenericKey<8>>());
+  const int64_t num_keys = 1000;
+  index.EnableBloomFilter(num_keys);
+  auto load = [&](int64_t begin, int64_t end) {
+    std::vector<Tuple> keys;
+    std::vector<RID> rids;
+    for (int64_t key = begin; key < end; key++) {
+      keys.emplace_back(std::vector<Value>{ValueFactory::GetBigIntValue(key)}, index.GetKeySchema());
+      rids.emplace_back(0, static_cast<uint32_t>(key));
+    }
+    index.InsertEntries(keys, rids, &transaction);
+  };
+
+  // the first batch fills the empty table, the second one overlaps it and only adds the keys that are new
+  load(0, num_keys / 2);
+  load(num_keys / 4, num_keys * 3 / 4);
+  std::vector<RID> rids;
+  for (int64_t key = 0; key < num_keys * 3 / 4; key++) {
+    rids.clear();
+    Tuple tuple(std::vector<Value>{ValueFactory::GetBigIntValue(key)}, index.GetKeySchema());
+    index.ScanKey(tuple, &rids, &transaction);
+    ASSERT_EQ(1, rids.size()) << key;
+  }
+
+  // the filter counted every key once, so it is empty again once they are deleted
+  for (int64_t key = 0; key < num_keys * 3 / 4; key++) {
+    Tuple tuple(std::vector<Value>{ValueFactory::GetBigIntValue(key)}, index.GetKeySchema());
+    index.DeleteEntry(tuple, RID(0, static_cast<uint32_t>(key)), &transaction);
+  }
+  std::mt19937_64 rng(7);
+  for (int i = 0; i < 10000; i++) {
+    ASSERT_FALSE(index.GetBloomFilter()->MayContain(rng()));
+  }
+
+  delete schema;
+  disk_manager->ShutDown();
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableIndexTest, DefaultHasherTest) {
+  // keys of up to 8 bytes are hashed like integers
+  static_assert(std::is_same_v<DefaultHasher<GenericKey<4>>::type, MultiplyShiftHasher>);
+  static_assert(std::is_same_v<DefaultHasher<GenericKey<8>>::type, MultiplyShiftHasher>);
+  static_assert(!std::is_same_v<DefaultHasher<GenericKey<16>>::type, MultiplyShiftHasher>);
+
+  Schema *schema = ParseCreateStatement("a integer");
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  Transaction transaction(0);
+  LinearProbeHashTableIndex<GenericKey<4>, RID, GenericComparator<4>> index(
+      new IndexMetadata("foo_pk", "foo", schema, {0}), bpm, 16, HashFunction<GenericKey<4>>());
+
+  // keys that differ only in their high bits still spread over the table
+  const int32_t num_keys = 2000;
+  auto key_of = [&](int32_t i) {
+    return Tuple(std::vector<Value>{ValueFactory::GetIntegerValue(i << 20)}, index.GetKeySchema());
+  };
+  for (int32_t i = 0; i < num_keys; i++) {
+    index.InsertEntry(key_of(i), RID(0, static_cast<uint32_t>(i)), &transaction);
+  }
+  std::vector<RID> rids;
+  for (int32_t i = 0; i < num_keys; i++) {
+    rids.clear();
+    index.ScanKey(key_of(i), &rids, &transaction);
+    ASSERT_EQ(1, rids.size()) << i;
+    EXPECT_EQ(static_cast<uint32_t>(i), rids[0].GetSlotNum());
+  }
+  for (int32_t i = 0; i < num_keys; i += 2) {
+    index.DeleteEntry(key_of(i), RID(0, static_cast<uint32_t>(i)), &transaction);
+  }
+  for (int32_t i = 0; i < num_keys; i++) {
+    rids.clear();
+    index.ScanKey(key_of(i), &rids, &transaction);
+    EXPECT_EQ(i % 2 == 0 ? 0 : 1, rids.size()) << i;
+  }
+
+  delete schema;
+  disk_manager->ShutDown();
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+}
+
+}  // namespace bustub
@@ -0,0 +1,165 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_statistics_test.cpp
+//
+// Identification: test/storage/index_statistics_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <vector>
+
+#include "b_plus_tree_test_util.h"  // NOLINT
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/index_statistics.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(IndexStatisticsTest, HistogramTest) {
+  // 1000 entries, every key value appears twice in the sample
+  IndexStatistics stats;
+  stats.num_entries_ = 1000;
+  std::vector<Value> sample;
+  for (int i = 0; i < 100; i++) {
+    sample.push_back(ValueFactory::GetIntegerValue(i / 2));
+  }
+  stats.BuildFromSample(sample, {sample.size()}, false, 10);
+
+  ASSERT_EQ(10, stats.histogram_.size());
+  uint64_t total = 0;
+  for (size_t b = 0; b < stats.histogram_.size(); b++) {
+    EXPECT_EQ(100, stats.histogram_[b].count_);
+    if (b > 0) {
+      EXPECT_EQ(CmpBool::CmpTrue,
+                stats.histogram_[b - 1].upper_bound_.CompareLessThan(stats.histogram_[b].upper_bound_));
+    }
+    total += stats.histogram_[b].count_;
+  }
+  EXPECT_EQ(1000, total);
+  EXPECT_EQ(49, stats.histogram_.back().upper_bound_.GetAs<int32_t>());
+
+  // every other adjacent pair changes value: 1 + 49 / 99 * 999
+  EXPECT_EQ(495, stats.distinct_keys_);
+
+  // a range covering the upper half of the keys
+  double selectivity =
+      stats.EstimateSelectivity(ValueFactory::GetIntegerValue(25), ValueFactory::GetIntegerValue(49));
+  EXPECT_GT(selectivity, 0.4);
+  EXPECT_LT(selectivity, 0.6);
+  EXPECT_EQ(0.0, stats.EstimateSelectivity(ValueFactory::GetIntegerValue(100), ValueFactory::GetIntegerValue(200)));
+}
+
+// NOLINTNEXTLINE
+TEST(IndexStatisticsTest, DistinctEstimateTest) {
+  // a single-column key is unique, whatever the sample looks like
+  IndexStatistics stats;
+  stats.num_entries_ = 10000;
+  std::vector<Value> sample;
+  for (int i = 0; i < 100; i++) {
+    sample.push_back(ValueFactory::GetIntegerValue(i * 100));
+  }
+  stats.BuildFromSample(sample, {50, 100}, true);
+  EXPECT_EQ(10000, stats.distinct_keys_);
+  EXPECT_EQ(IndexStatistics::DEFAULT_HISTOGRAM_BUCKETS, stats.histogram_.size());
+
+  // two sampled leaves of a composite key with 4 entries per leading value: 2 of the 14 adjacent pairs inside the
+  // leaves change value, the jump between the leaves does not count
+  IndexStatistics composite;
+  composite.num_entries_ = 1000;
+  sample.clear();
+  for (int i = 0; i < 8; i++) {
+    sample.push_back(ValueFactory::GetIntegerValue(i / 4));
+  }
+  for (int i = 0; i < 8; i++) {
+    sample.push_back(ValueFactory::GetIntegerValue(50 + i / 4));
+  }
+  composite.BuildFromSample(sample, {8, 16}, false);
+  // 1 + 2 / 14 * 999, rounded
+  EXPECT_EQ(144, composite.distinct_keys_);
+
+  // never less than the values actually seen
+  composite.BuildFromSample(sample, {4, 8, 12, 16}, false);
+  EXPECT_EQ(4, composite.distinct_keys_);
+
+  IndexStatistics empty;
+  EXPECT_EQ(1.0, empty.EstimateSelectivity(ValueFactory::GetIntegerValue(0), ValueFactory::GetIntegerValue(1)));
+}
+
+// NOLINTNEXTLINE
+TEST(IndexStatisticsTest, FirstBucketSelectivityTest) {
+  IndexStatistics stats;
+  stats.num_entries_ = 100;
+  std::vector<Value> sample;
+  for (int i = 0; i < 100; i++) {
+    sample.push_back(ValueFactory::GetIntegerValue(i));
+  }
+  stats.BuildFromSample(sample, {sample.size()}, true, 10);
+
+  // the first bucket is bounded below by the smallest sampled key
+  EXPECT_EQ(1.0, stats.EstimateSelectivity(ValueFactory::GetIntegerValue(-10), ValueFactory::GetIntegerValue(99)));
+  EXPECT_EQ(0.0, stats.EstimateSelectivity(ValueFactory::GetIntegerValue(-10), ValueFactory::GetIntegerValue(-1)));
+  EXPECT_EQ(0.05, stats.EstimateSelectivity(ValueFactory::GetIntegerValue(3), ValueFactory::GetIntegerValue(5)));
+}
+
+// NOLINTNEXTLINE
+TEST(IndexStatisticsTest, SampleLeavesTest) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+
+  GenericKey<8> index_key;
+  RID rid;
+  const int64_t num_keys = 10000;
+  for (int64_t key = 0; key < num_keys; key++) {
+    rid.Set(0, static_cast<uint32_t>(key));
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, rid);
+  }
+
+  IndexStatistics stats;
+  std::vector<GenericKey<8>> sample;
+  std::vector<size_t> leaf_ends;
+  tree.SampleLeaves(4, &stats, &sample, &leaf_ends);
+  EXPECT_TRUE(stats.valid_);
+  EXPECT_EQ(2, stats.height_);
+  EXPECT_EQ(1, stats.internal_page_count_);
+  EXPECT_GT(stats.leaf_page_count_, 4);
+  EXPECT_GT(stats.fill_factor_, 0.4);
+  EXPECT_LE(stats.fill_factor_, 1.0);
+  // the estimate extrapolates the sampled leaves to all of them
+  EXPECT_GT(stats.num_entries_, num_keys / 2);
+  EXPECT_LT(stats.num_entries_, num_keys * 2);
+
+  // whole leaves, in key order
+  ASSERT_EQ(4, leaf_ends.size());
+  EXPECT_EQ(sample.size(), leaf_ends.back());
+  for (size_t i = 1; i < sample.size(); i++) {
+    EXPECT_LT(comparator(sample[i - 1], sample[i]), 0);
+  }
+  EXPECT_EQ(0, sample.front().ToValue(key_schema, 0).GetAs<int64_t>());
+
+  // sampling every leaf counts the entries exactly
+  tree.SampleLeaves(stats.leaf_page_count_, &stats, &sample, &leaf_ends);
+  EXPECT_EQ(num_keys, stats.num_entries_);
+  EXPECT_EQ(num_keys, sample.size());
+
+  delete key_schema;
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+}  // namespace bustub
@@ -19,11 +19,7 @@
 namespace bustub {
 
 // NOLINTNEXTLINE
-TEST(TmpTuplePageTest, DISABLED_BasicTest) {
-  // There are many ways to do this assignment, and this is only one of them.
-  // If you don't like the TmpTuplePage idea, please feel free to delete this test case entirely.
-  // You will get full credit as long as you are correctly using a linear probe hash table.
-
+TEST(TmpTuplePageTest, BasicTest) {
   TmpTuplePage page{};
   page_id_t page_id = 15445;
   page.Init(page_id, PAGE_SIZE);
@@ -41,11 +37,44 @@ TEST(TmpTuplePageTest, DISABLED_BasicTest) {
 
   Tuple tuple(values, &schema);
   TmpTuple tmp_tuple(INVALID_PAGE_ID, 0);
-  page.Insert(tuple, &tmp_tuple);
+  ASSERT_TRUE(page.Insert(tuple, &tmp_tuple));
 
   ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + sizeof(page_id_t) + sizeof(lsn_t)), PAGE_SIZE - 8);
   ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + PAGE_SIZE - 8), 4);
   ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + PAGE_SIZE - 4), 123);
+  ASSERT_EQ(tmp_tuple, TmpTuple(page_id, PAGE_SIZE - 8));
+
+  Tuple read;
+  page.Get(tmp_tuple.GetOffset(), &read);
+  ASSERT_EQ(read.GetValue(&schema, 0).GetAs<int32_t>(), 123);
+}
+
+// NOLINTNEXTLINE
+TEST(TmpTuplePageTest, FullPageTest) {
+  TmpTuplePage page{};
+  page.Init(0, PAGE_SIZE);
+
+  std::vector<Column> columns;
+  columns.emplace_back("A", TypeId::INTEGER);
+  Schema schema(columns);
+
+  // every tuple takes 8 bytes, the header 12
+  TmpTuple tmp_tuple(INVALID_PAGE_ID, 0);
+  int32_t num_tuples = 0;
+  while (page.Insert(Tuple({ValueFactory::GetIntegerValue(num_tuples)}, &schema), &tmp_tuple)) {
+    num_tuples++;
+  }
+  ASSERT_EQ(num_tuples, (PAGE_SIZE - 12) / 8);
+  ASSERT_LT(page.GetFreeSpaceRemaining(), 8);
+
+  // the tuples come back from the last inserted one
+  int32_t expected = num_tuples;
+  page.ForEachTuple([&](size_t offset) {
+    Tuple tuple;
+    page.Get(offset, &tuple);
+    ASSERT_EQ(tuple.GetValue(&schema, 0).GetAs<int32_t>(), --expected);
+  });
+  ASSERT_EQ(expected, 0);
 }
 
 }  // namespace bustub
@@ -21,6 +21,8 @@
 #include "logging/common.h"
 #include "storage/table/table_heap.h"
 #include "storage/table/tuple.h"
+#include "storage/table/tuple_projection.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 // NOLINTNEXTLINE
@@ -71,4 +73,82 @@ TEST(TupleTest, DISABLED_TableHeapTest) {
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+TEST(TupleTest, ScanPageFilterProjectionTest) {
+  Schema schema{std::vector<Column>{Column{"a", TypeId::VARCHAR, 20}, Column{"b", TypeId::SMALLINT},
+                                    Column{"c", TypeId::BIGINT}, Column{"d", TypeId::VARCHAR, 16}}};
+  // d, then b, then a: the VARCHARs change places
+  Schema projected_schema{std::vector<Column>{Column{"d", TypeId::VARCHAR, 16}, Column{"b", TypeId::SMALLINT},
+                                              Column{"a", TypeId::VARCHAR, 20}}};
+  TupleProjection projection{&schema, &projected_schema, {3, 1, 0}};
+
+  auto *transaction = new Transaction(0);
+  auto *disk_manager = new DiskManager("test.db");
+  auto *buffer_pool_manager = new BufferPoolManager(50, disk_manager);
+  auto *lock_manager = new LockManager();
+  auto *log_manager = new LogManager(disk_manager);
+  auto *table = new TableHeap(buffer_pool_manager, lock_manager, log_manager, transaction);
+
+  const int num_tuples = 1000;
+  for (int i = 0; i < num_tuples; ++i) {
+    // a is empty for every seventh tuple
+    std::vector<Value> values{ValueFactory::GetVarcharValue(std::string(i % 7, 'a')),
+                              ValueFactory::GetSmallIntValue(static_cast<int16_t>(i)),
+                              ValueFactory::GetBigIntValue(i % 10), ValueFactory::GetVarcharValue(std::to_string(i))};
+    RID rid;
+    ASSERT_TRUE(table->InsertTuple(Tuple(values, &schema), &rid, transaction));
+  }
+
+  // c < 5, read from the bytes of the tuples in the page
+  uint32_t c_offset = schema.GetColumn(2).GetOffset();
+  TupleFilter filter = [c_offset](const char *data) { return *reinterpret_cast<const int64_t *>(data + c_offset) < 5; };
+
+  std::vector<Tuple> expected;
+  for (auto iter = table->Begin(transaction); iter != table->End(); ++iter) {
+    if (iter->GetValue(&schema, 2).GetAs<int64_t>() < 5) {
+      expected.push_back(*iter);
+    }
+  }
+  ASSERT_EQ(num_tuples / 2, expected.size());
+
+  size_t num_scanned = 0;
+  std::vector<Tuple> tuples;
+  std::vector<Tuple> projected_tuples;
+  for (page_id_t page_id = table->GetFirstPageId(); page_id != INVALID_PAGE_ID;) {
+    page_id_t next_page_id = table->ScanPage(page_id, &tuples, transaction, filter);
+    table->ScanPage(page_id, &projected_tuples, transaction, filter, &projection);
+    ASSERT_EQ(tuples.size(), projected_tuples.size());
+    for (size_t i = 0; i < tuples.size(); i++, num_scanned++) {
+      ASSERT_LT(num_scanned, expected.size());
+      const Tuple &tuple = expected[num_scanned];
+      EXPECT_EQ(tuple.GetRid(), tuples[i].GetRid());
+      EXPECT_EQ(tuple.GetLength(), tuples[i].GetLength());
+      EXPECT_EQ(0, memcmp(tuple.GetData(), tuples[i].GetData(), tuple.GetLength()));
+
+      // the projection is the tuple built from the values of its columns
+      EXPECT_EQ(tuple.GetRid(), projected_tuples[i].GetRid());
+      std::vector<Value> values{tuple.GetValue(&schema, 3), tuple.GetValue(&schema, 1), tuple.GetValue(&schema, 0)};
+      Tuple built{values, &projected_schema};
+      ASSERT_EQ(built.GetLength(), projected_tuples[i].GetLength());
+      EXPECT_EQ(0, memcmp(built.GetData(), projected_tuples[i].GetData(), built.GetLength()));
+      for (uint32_t col = 0; col < projected_schema.GetColumnCount(); col++) {
+        Value value = projected_tuples[i].GetValue(&projected_schema, col);
+        EXPECT_EQ(CmpBool::CmpTrue, value.CompareEquals(built.GetValue(&projected_schema, col)));
+      }
+    }
+    page_id = next_page_id;
+  }
+  EXPECT_EQ(expected.size(), num_scanned);
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.log");
+  delete table;
+  delete log_manager;
+  delete lock_manager;
+  delete buffer_pool_manager;
+  delete disk_manager;
+  delete transaction;
+}
+
 }  // namespace bustub